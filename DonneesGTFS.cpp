@@ -6,53 +6,14 @@
 
 using namespace std;
 
-//! \brief Pour string_to_vector ci-dessous
-//! \brief Solution obtenue de https://www.techiedelight.com/
-std::string ltrim(const std::string &s, const std::string &WHITESPACE)
-{
-    size_t start = s.find_first_not_of(WHITESPACE);
-    return (start == std::string::npos) ? "" : s.substr(start);
-}
-
-//! Pour string_to_vector ci-dessous
-//! \brief Solution obtenue de https://www.techiedelight.com/
-std::string rtrim(const std::string &s, const std::string &WHITESPACE)
-{
-    size_t end = s.find_last_not_of(WHITESPACE);
-    return (end == std::string::npos) ? "" : s.substr(0, end + 1);
-}
-
-//! \brief partitionne un string en un vecteur de strings
-//! \brief cela modifie le string s en lui enlevant tous les guillements
-//! \param[in] s: le string à être partitionner
-//! \param[in] delim: le caractère utilisé pour le partitionnement
-//! \return le vecteur de string sans le caractère utilisé pour le partitionnement
-//! \brief On supprime tous les caractères blancs situés au début et à la fin de chaque élément du vecteur
-vector<string> DonneesGTFS::string_to_vector(string &s, char delim)
-{
-    s.erase(remove(s.begin(), s.end(), '"'), s.end()); // enlever les guillemets du texte
-    stringstream ss(s);
-    string item;
-    vector<string> elems;
-    while (getline(ss, item, delim))
-    {
-        //pour chaque string item, on enlève les caractères blancs du début et de la fin
-        //solution obtenue de https://www.techiedelight.com/
-        auto ret_item = rtrim(ltrim(item, " \n\r\t\f\v"), " \n\r\t\f\v");
-
-        //maintenant que les caractères blancs sont enlevés, on insère item dans le vecteur elems
-        elems.push_back(ret_item);
-    }
-    return elems;
-}
-
 //! \brief construit un objet GTFS
 //! \param[in] p_date: la date utilisée par le GTFS
 //! \param[in] p_now1: l'heure du début de l'intervalle considéré
 //! \param[in] p_now2: l'heure de fin de l'intervalle considéré
 //! \brief Ces deux heures définissent l'intervalle de temps du GTFS; seuls les moments de [p_now1, p_now2) sont considérés
 DonneesGTFS::DonneesGTFS(const Date &p_date, const Heure &p_now1, const Heure &p_now2)
-        : m_date(p_date), m_now1(p_now1), m_now2(p_now2), m_nbArrets(0), m_tousLesArretsPresents(false)
+        : m_date(p_date), m_now1(p_now1), m_now2(p_now2), m_arrets(1 << 14), m_nbArrets(0),
+          m_tousLesArretsPresents(false), m_rayonMarche(0), m_vitesseMarche(VITESSE_MARCHE)
 {
 }
 
@@ -81,6 +42,16 @@ size_t DonneesGTFS::getNbStationsDeTransfert() const
     return m_stationsDeTransfert.size();
 }
 
+const StatistiquesArrets &DonneesGTFS::getStatistiquesArrets() const
+{
+    return m_statistiquesArrets;
+}
+
+const std::vector<DureePhase> &DonneesGTFS::getDureesChargement() const
+{
+    return m_dureesChargement;
+}
+
 size_t DonneesGTFS::getNbServices() const
 {
     return m_services.size();
@@ -110,9 +81,9 @@ void DonneesGTFS::afficherStations() const
     std::cout << "   STATIONS GTFS   " << std::endl;
     std::cout << "   COMPTE = " << m_stations.size() << "   " << std::endl;
     std::cout << "========================" << std::endl;
-    for (const auto & stationM : m_stations)
+    for (auto station : m_idsStations.trier(m_stations.identifiants()))
     {
-        std::cout << stationM.second << endl;
+        std::cout << m_stations[station] << endl;
     }
     std::cout << std::endl;
 }
@@ -123,9 +94,9 @@ void DonneesGTFS::afficherStationsDeTransfert() const
     std::cout << "   STATIONS DE TRANSFERT GTFS   " << std::endl;
     std::cout << "   COMPTE = " << m_stationsDeTransfert.size() << "   " << std::endl;
     std::cout << "================================" << std::endl;
-    for (auto station_id : m_stationsDeTransfert)
+    for (auto station : m_idsStations.trier(m_stationsDeTransfert))
     {
-        std::cout << "Station id: " << station_id << endl;
+        std::cout << "Station id: " << m_idsStations.chaine(station) << endl;
     }
     std::cout << std::endl;
 
@@ -140,7 +111,8 @@ void DonneesGTFS::afficherTransferts() const
     std::cout << "========================" << std::endl;
     for (unsigned int i = 0; i < m_transferts.size(); ++i)
     {
-        std::cout << "De la station " << get<0>(m_transferts.at(i)) << " vers la station " << get<1>(m_transferts.at(i))
+        std::cout << "De la station " << m_idsStations.chaine(get<0>(m_transferts.at(i))) << " vers la station "
+                  << m_idsStations.chaine(get<1>(m_transferts.at(i)))
                   <<
                   " en " << get<2>(m_transferts.at(i)) << " secondes" << endl;
 
@@ -158,21 +130,19 @@ void DonneesGTFS::afficherArretsParVoyages() const
     std::cout << "   COMPTE = " << m_voyages.size() << "   " << std::endl;
     std::cout << "=====================================" << std::endl;
 
-    for (const auto & voyageM : m_voyages)
+    for (auto voyage_id : m_idsVoyages.trier(m_voyages.identifiants()))
     {
-        auto ligne_id = voyageM.second.getLigne();
-        auto l_itr = m_lignes.find(ligne_id);
-        if (l_itr == m_lignes.end())
+        const Voyage & voyage = m_voyages[voyage_id];
+        if (!m_lignes.contient(voyage.getLigne()))
             throw logic_error("DonneesGTFS::afficherArretsParVoyages(): ligne_id absent de m_lignes");
-        cout << (l_itr->second).getNumero() << " ";
-        cout << voyageM.second << endl;
-        for (const auto & a: voyageM.second.getArrets())
+        cout << m_lignes[voyage.getLigne()].getNumero() << " ";
+        cout << voyage << endl;
+        const PlageArrets & arrets = voyage.getArrets();
+        for (std::size_t i = 0; i < arrets.size(); ++i)
         {
-            auto station_id = a->getStationId();
-            auto s_itr = m_stations.find(station_id);
-            if (s_itr == m_stations.end())
+            if (!m_stations.contient(arrets.stations[i]))
                 throw logic_error("DonneesGTFS::afficherArretsParVoyages(): station_id absent de m_stations");
-            std::cout << a->getHeureArrivee() << " station " << s_itr->second << endl;
+            std::cout << Heure::depuisCode(arrets.arrivees[i]) << " station " << m_stations[arrets.stations[i]] << endl;
         }
     }
 
@@ -185,45 +155,186 @@ void DonneesGTFS::afficherArretsParStations() const
     std::cout << "   ARRETS PAR STATIONS   " << std::endl;
     std::cout << "   Nombre d'arrêts = " << m_nbArrets << std::endl;
     std::cout << "========================" << std::endl;
-    for ( const auto & stationM : m_stations)
+    for (auto station_id : m_idsStations.trier(m_stations.identifiants()))
     {
-        std::cout << "Station " << stationM.second << endl;
-        for ( const auto & arretM : stationM.second.getArrets())
+        const Station & station = m_stations[station_id];
+        std::cout << "Station " << station << endl;
+        // L'index est trié par heure de départ; l'affichage suit l'heure d'arrivée
+        const PlageStation & arrets = station.getArrets();
+        std::vector<std::uint32_t> rangees(arrets.rangees, arrets.rangees + arrets.size());
+        const std::vector<std::uint32_t> & arrivees = m_tableArrets.getArrivees();
+        std::stable_sort(rangees.begin(), rangees.end(), [&arrivees](std::uint32_t a, std::uint32_t b) {
+            return arrivees[a] < arrivees[b];
+        });
+        for (auto rangee : rangees)
         {
-            auto voyage_id = arretM.second->getVoyageId();
-            auto v_itr = m_voyages.find(voyage_id);
-            if (v_itr == m_voyages.end())
+            auto voyage_id = m_tableArrets.getVoyages()[rangee];
+            if (!m_voyages.contient(voyage_id))
                 throw logic_error("DonneesGTFS::afficherArretsParStations(): voyage_id absent de m_voyages");
-            auto ligne_id = (v_itr->second).getLigne();
-            auto l_itr = m_lignes.find(ligne_id);
-            if (l_itr == m_lignes.end())
+            const Voyage & voyage = m_voyages[voyage_id];
+            if (!m_lignes.contient(voyage.getLigne()))
                 throw logic_error("DonneesGTFS::afficherArretsParStations(): ligne_id absent de m_lignes");
-            std::cout << arretM.first << " - " << (l_itr->second).getNumero() << " " << v_itr->second << std::endl;
+            std::cout << Heure::depuisCode(arrivees[rangee]) << " - " << m_lignes[voyage.getLigne()].getNumero() << " " << voyage << std::endl;
         }
     }
     std::cout << std::endl;
 }
 
-const std::map<std::string, Voyage> &DonneesGTFS::getVoyages() const
+const Registre<Voyage> &DonneesGTFS::getVoyages() const
 {
     return m_voyages;
 }
 
-const std::map<std::string, Station> &DonneesGTFS::getStations() const
+//! \brief les arrêts de tous les voyages en colonnes, triés par (voyage, numéro de séquence)
+const TableArrets &DonneesGTFS::getTableArrets() const
+{
+    return m_tableArrets;
+}
+
+//! \brief reconstruit m_tableArrets à partir de tous les arrêts de m_arrets (voir indexerArrets(const vector<>&))
+void DonneesGTFS::indexerArrets()
+{
+    std::vector<Arret::Ptr> arrets;
+    arrets.reserve(m_arrets.taille());
+    m_arrets.parcourir([&arrets](const Arret &p_arret) { arrets.push_back(&p_arret); });
+    indexerArrets(arrets);
+}
+
+/*!
+ * \brief reconstruit m_tableArrets et donne à chaque voyage de m_voyages sa plage
+ * \param[in] p_arrets: les arrêts des voyages, dans l'ordre de leur lecture
+ * \throws logic_error si les numéros de séquence d'un voyage contredisent ses heures
+ */
+void DonneesGTFS::indexerArrets(const std::vector<Arret::Ptr> &p_arrets)
+{
+    m_tableArrets.construire(p_arrets, static_cast<std::uint32_t>(m_idsVoyages.taille()));
+    for (auto voyageM : m_voyages) voyageM.second.setArrets(m_tableArrets.plage(voyageM.first));
+    indexerStations();
+}
+
+//! \brief reconstruit m_indexStations à partir de m_tableArrets et donne à chaque station de m_stations sa plage
+void DonneesGTFS::indexerStations()
+{
+    m_indexStations.construire(m_tableArrets, static_cast<std::uint32_t>(m_idsStations.taille()));
+    for (auto stationM : m_stations) stationM.second.setArrets(m_indexStations.plage(stationM.first));
+}
+
+//! \brief les arrêts de chaque station, triés par heure de départ, en rangées de getTableArrets()
+const IndexStations &DonneesGTFS::getIndexStations() const
+{
+    return m_indexStations;
+}
+
+const Registre<Station> &DonneesGTFS::getStations() const
 {
     return m_stations;
 }
 
-const std::set<std::string> &DonneesGTFS::getStationsDeTransfert() const
+const EnsembleIdentifiants &DonneesGTFS::getServices() const
+{
+    return m_services;
+}
+
+const EnsembleIdentifiants &DonneesGTFS::getStationsDeTransfert() const
 {
     return m_stationsDeTransfert;
 }
 
-const std::vector<std::tuple<std::string, std::string, unsigned int> > &DonneesGTFS::getTransferts() const
+const std::vector<std::tuple<std::uint32_t, std::uint32_t, unsigned int> > &DonneesGTFS::getTransferts() const
 {
     return m_transferts;
 }
 
+//! \brief les transferts de getTransferts(), regroupés par station de départ
+const GrapheTransferts &DonneesGTFS::getGrapheTransferts() const
+{
+    return m_grapheTransferts;
+}
+
+//! \brief reconstruit m_grapheTransferts à partir de m_transferts
+void DonneesGTFS::indexerTransferts()
+{
+    m_grapheTransferts.construire(m_transferts, static_cast<std::uint32_t>(m_idsStations.taille()));
+}
+
+/*!
+ * \brief ajoute aux transferts un trajet à pied entre chaque paire de stations présentes à au plus p_rayon km
+ * \brief Lorsqu'un transfert de transfers.txt relie déjà les deux stations, le plus court des deux temps est gardé.
+ * Les paramètres sont mémorisés: recharger() et chargerDepuisHoraire() régénèrent les trajets, et l'instantané les
+ * conserve (voir chargerAvecInstantane())
+ * \param[in] p_rayon: la distance à vol d'oiseau maximale, en km
+ * \param[in] p_vitesse: la vitesse de marche, en m/s
+ * \throws logic_error si tous les arrets de la date et de l'intervalle n'ont pas été ajoutés
+ * \throws logic_error si p_vitesse n'est pas positive
+ */
+void DonneesGTFS::ajouterTrajetsAPied(double p_rayon, double p_vitesse)
+{
+    if (!m_tousLesArretsPresents)
+    {
+        throw std::logic_error("DonneesGTFS::ajouterTrajetsAPied(): tous les arrêts n'ont pas été ajoutés");
+    }
+    if (!(p_vitesse > 0)) throw std::logic_error("DonneesGTFS::ajouterTrajetsAPied(): la vitesse doit être positive");
+    m_rayonMarche = p_rayon;
+    m_vitesseMarche = p_vitesse;
+    appliquerTrajetsAPied();
+}
+
+//! \brief fusionne à m_transferts les trajets à pied de m_rayonMarche et m_vitesseMarche, s'il y en a
+void DonneesGTFS::appliquerTrajetsAPied()
+{
+    if (m_rayonMarche <= 0) return;
+
+    std::vector<std::tuple<std::uint32_t, std::uint32_t, unsigned int> > trajets;
+    genererTrajetsAPied(m_stations, m_rayonMarche, m_vitesseMarche, trajets);
+
+    std::unordered_map<std::uint64_t, std::size_t> existants; //(from_station, to_station) -> position
+    existants.reserve(m_transferts.size() + trajets.size());
+    for (std::size_t i = 0; i < m_transferts.size(); ++i)
+    {
+        existants.insert(std::make_pair(static_cast<std::uint64_t>(std::get<0>(m_transferts[i])) << 32 |
+                                        std::get<1>(m_transferts[i]), i));
+    }
+    for (const auto &trajet : trajets)
+    {
+        std::uint64_t cle = static_cast<std::uint64_t>(std::get<0>(trajet)) << 32 | std::get<1>(trajet);
+        auto itr = existants.find(cle);
+        if (itr != existants.end())
+        {
+            unsigned int &temps = std::get<2>(m_transferts[itr->second]);
+            temps = std::min(temps, std::get<2>(trajet));
+            continue;
+        }
+        existants.insert(std::make_pair(cle, m_transferts.size()));
+        m_transferts.push_back(trajet);
+        m_stationsDeTransfert.ajouter(std::get<0>(trajet));
+    }
+    indexerTransferts();
+}
+
+//! \brief la table des stop_id: les identifiants de getStations(), des arrêts et des transferts y renvoient
+const TableIdentifiants &DonneesGTFS::getIdsStations() const
+{
+    return m_idsStations;
+}
+
+//! \brief la table des trip_id: les identifiants de getVoyages() et des arrêts y renvoient
+const TableIdentifiants &DonneesGTFS::getIdsVoyages() const
+{
+    return m_idsVoyages;
+}
+
+//! \brief la table des route_id: les identifiants de getLignes() et Voyage::getLigne() y renvoient
+const TableIdentifiants &DonneesGTFS::getIdsLignes() const
+{
+    return m_idsLignes;
+}
+
+//! \brief la table des service_id: les identifiants de getServices() et Voyage::getServiceId() y renvoient
+const TableIdentifiants &DonneesGTFS::getIdsServices() const
+{
+    return m_idsServices;
+}
+
 Heure DonneesGTFS::getTempsFin() const
 {
     return m_now2;
@@ -234,10 +345,15 @@ Heure DonneesGTFS::getTempsDebut() const
     return m_now1;
 }
 
-const std::unordered_map<std::string, Ligne> &DonneesGTFS::getLignes() const
+const Registre<Ligne> &DonneesGTFS::getLignes() const
 {
     return m_lignes;
 }
 
+const std::multimap<std::string, Ligne> &DonneesGTFS::getLignesParNumero() const
+{
+    return m_lignes_par_numero;
+}
+
 
 
@@ -20,12 +20,51 @@
 #include "voyage.h"
 #include "arret.h"
 #include "coordonnees.h"
+#include "lecteurcsv.h"
+#include "identifiants.h"
+#include "arene.h"
+#include "tablearrets.h"
+#include "indexstations.h"
+#include "graphetransferts.h"
+#include "trajetsapied.h"
+#include "rechargement.h"
+
+class HoraireGTFS;
+
+/*!
+ * \struct StatistiquesArrets
+ * \brief Compteurs de la dernière lecture de stop_times.txt par DonneesGTFS::ajouterArretsDesVoyagesDeLaDate()
+ * \note Les lignes rejetées ne sont décodées que jusqu'au filtre (trip_id, arrival_time, departure_time);
+ * avec un intervalle vide, dureeLecture / nbLignesLues est donc le coût d'une ligne rejetée
+ */
+struct StatistiquesArrets
+{
+    StatistiquesArrets() : nbLignesLues(0), nbRejeteesIntervalle(0), nbRejeteesVoyage(0), dureeLecture(0) {}
+
+    std::size_t nbLignesLues;
+    std::size_t nbRejeteesIntervalle; //arrêts hors de [now1, now2)
+    std::size_t nbRejeteesVoyage;     //arrêts dont le voyage est absent de m_voyages
+    double dureeLecture;              //en secondes, découpage et filtrage du fichier (sans la fusion)
+};
+
+/*!
+ * \struct DureePhase
+ * \brief Une phase de DonneesGTFS::charger(): son début et sa durée, en secondes depuis le début du chargement
+ */
+struct DureePhase
+{
+    std::string nom;
+    double debut;
+    double duree;
+};
 
 class DonneesGTFS
 {
 
 public:
     DonneesGTFS(const Date&, const Heure&, const Heure&);
+    DonneesGTFS(const DonneesGTFS &) = delete; //les voyages et les stations désignent m_tableArrets et m_indexStations
+    DonneesGTFS &operator=(const DonneesGTFS &) = delete;
 
     void ajouterLignes(const std::string &);
     void ajouterStations(const std::string &);
@@ -33,6 +72,15 @@ public:
     void ajouterVoyagesDeLaDate(const std::string &);
     void ajouterArretsDesVoyagesDeLaDate(const std::string&);
     void ajouterTransferts(const std::string&);
+    void ajouterTrajetsAPied(double p_rayon = RAYON_MARCHE, double p_vitesse = VITESSE_MARCHE);
+    void charger(const std::string &p_dossier);
+
+    void chargerAvecInstantane(const std::string &p_dossier, const std::string &p_nomInstantane,
+                               double p_rayonMarche = 0, double p_vitesseMarche = VITESSE_MARCHE);
+    bool chargerInstantane(const std::string &p_nomFichier, const std::string &p_dossier);
+    void sauvegarderInstantane(const std::string &p_nomFichier, const std::string &p_dossier) const;
+    void chargerDepuisHoraire(const HoraireGTFS &p_horaire);
+    RapportRechargement recharger(const std::string &p_dossier);
 
     void afficherLignes() const;
     void afficherStations() const;
@@ -50,32 +98,74 @@ public:
     size_t getNbVoyages() const;
     size_t getNbTransferts() const;
     size_t getNbStationsDeTransfert() const;
-    const std::map<std::string, Voyage> & getVoyages() const;
-    const std::map<std::string, Station> & getStations() const;
-    const std::unordered_map<std::string, Ligne> & getLignes() const;
-    const std::set<std::string> & getStationsDeTransfert() const;
-    const std::vector<std::tuple<std::string, std::string, unsigned int> > & getTransferts() const;
+    const StatistiquesArrets & getStatistiquesArrets() const;
+    const std::vector<DureePhase> & getDureesChargement() const;
+    const Registre<Voyage> & getVoyages() const;
+    const TableArrets & getTableArrets() const;
+    const IndexStations & getIndexStations() const;
+    const Registre<Station> & getStations() const;
+    const Registre<Ligne> & getLignes() const;
+    const std::multimap<std::string, Ligne> & getLignesParNumero() const;
+    const EnsembleIdentifiants & getServices() const;
+    const EnsembleIdentifiants & getStationsDeTransfert() const;
+    const std::vector<std::tuple<std::uint32_t, std::uint32_t, unsigned int> > & getTransferts() const;
+    const GrapheTransferts & getGrapheTransferts() const;
+    const TableIdentifiants & getIdsStations() const;
+    const TableIdentifiants & getIdsVoyages() const;
+    const TableIdentifiants & getIdsLignes() const;
+    const TableIdentifiants & getIdsServices() const;
 
 private:
-
-    std::vector<std::string> string_to_vector(std::string &s, char delim);
+    friend class RechargeurGTFS;
+
+    void ajouterLignes(const FichierMappe &p_fichier);
+    void ajouterStations(const FichierMappe &p_fichier);
+    void ajouterServices(const FichierMappe &p_fichier);
+    void ajouterVoyagesDeLaDate(const FichierMappe &p_fichier);
+    void ajouterArretsDesVoyagesDeLaDate(const FichierMappe &p_fichier);
+    static void lireTransferts(const std::string &p_nomFichier,
+                               std::vector<std::tuple<std::string, std::string, unsigned int> > &p_transferts);
+    static void lireTransferts(const FichierMappe &p_fichier,
+                               std::vector<std::tuple<std::string, std::string, unsigned int> > &p_transferts);
+    void indexerArrets();
+    void indexerArrets(const std::vector<Arret::Ptr> &p_arrets);
+    void indexerStations();
+    void appliquerTransferts(const std::vector<std::tuple<std::string, std::string, unsigned int> > &p_transferts);
+    void indexerTransferts();
+    void appliquerTrajetsAPied();
 
     Date m_date; //la date d'intérêt
     Heure m_now1;  //l'heure de début d'intérêt (à partir de laquelle on considère les arrêts)
     Heure m_now2;  //l'heure de fin d'intérêt (à partir de laquelle on ne considère plus les arrêts
 
+    Arene<Arret> m_arrets; //possède tous les arrêts; EtatRechargement n'en a que des poignées
+    TableArrets m_tableArrets; //les arrêts des voyages en colonnes; chaque Voyage en désigne une plage
+    IndexStations m_indexStations; //les rangées de m_tableArrets par station; chaque Station en désigne une plage
     unsigned int m_nbArrets; //le nombre d'arrets au total présents dans cet objet
     bool m_tousLesArretsPresents; //indique si tous les arrêts de la date et de l'intervalle [now1, now2) ont été ajoutés
-
-    std::unordered_map<std::string, Ligne> m_lignes; //la clé string est l'identifiant m_id de l'objet Ligne
-    std::map<std::string, Station> m_stations; //la clé string est l'identifiant m_id de l'objet Station
-    std::unordered_set<std::string> m_services; //le string est l'identifiant du service (service_id)
-    std::map<std::string, Voyage> m_voyages; //le string est l'identifiant (trip_id) de l'objet Voyage
-    std::vector<std::tuple<std::string, std::string, unsigned int> > m_transferts; // <from_station_id, to_station_id, min_transfer_time>
-    std::set<std::string> m_stationsDeTransfert; //Chaque élément est l'identifiant from_station_id d'une station présente dans m_transferts
+    StatistiquesArrets m_statistiquesArrets; //compteurs de la lecture de stop_times.txt
+    std::vector<DureePhase> m_dureesChargement; //phases du dernier appel à charger()
+
+    //Les identifiants GTFS sont internés au chargement; tout le reste de l'objet ne conserve que leurs identifiants denses
+    TableIdentifiants m_idsLignes;   //route_id
+    TableIdentifiants m_idsStations; //stop_id, y compris ceux de stop_times.txt absents de stops.txt
+    TableIdentifiants m_idsServices; //service_id
+    TableIdentifiants m_idsVoyages;  //trip_id
+
+    Registre<Ligne> m_lignes; //indexé par l'identifiant dense du route_id
+    Registre<Station> m_stations; //indexé par l'identifiant dense du stop_id
+    EnsembleIdentifiants m_services; //les services offerts à m_date
+    Registre<Voyage> m_voyages; //indexé par l'identifiant dense du trip_id
+    std::vector<std::tuple<std::uint32_t, std::uint32_t, unsigned int> > m_transferts; // <from_station, to_station, min_transfer_time>
+    EnsembleIdentifiants m_stationsDeTransfert; //Chaque élément est la station from_station d'un transfert de m_transferts
+    GrapheTransferts m_grapheTransferts; //m_transferts par station de départ
+    double m_rayonMarche;   //en km, celui des trajets à pied fusionnés à m_transferts; 0 s'il n'y en a pas
+    double m_vitesseMarche; //en m/s
 
     std::multimap<std::string, Ligne> m_lignes_par_numero; //le string est l'attribut m_numero de l'objet ligne
 
+    EtatRechargement m_etatRechargement; //empreintes du dernier recharger(); tout autre chargement les oublie
+
 };
 
 #endif //TP1_GTFS_H
@@ -3,40 +3,65 @@
 //
 
 #include "DonneesGTFS.h"
+#include "enregistrementsgtfs.h"
+#include "parallele.h"
 #include <fstream>
+#include <chrono>
 
 using namespace std;
 
+namespace
+{
+    //! taille (en octets) des morceaux de stop_times.txt distribués aux fils; ils sont petits pour que la lecture d'un
+    //! membre d'archive suive de près sa décompression
+    const std::size_t TAILLE_MORCEAU_ARRETS = 1 << 18;
+
+    //! arrêt d'une station absente de la table des stations: il ne reçoit son identifiant qu'à la fusion
+    struct ArretSansIdentifiant
+    {
+        std::size_t position; //dans MorceauRetenu::arrets
+        std::string stationId;
+    };
+
+    //! arrêts retenus par un fil, en attente d'être copiés dans l'arène et attachés à leur voyage et à leur station
+    struct MorceauRetenu
+    {
+        std::vector<Arret> arrets;
+        std::vector<ArretSansIdentifiant> sansIdentifiant;
+    };
+}
+
 
 //! \brief ajoute les lignes dans l'objet GTFS
 //! \param[in] p_nomFichier: le nom du fichier contenant les lignes
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterLignes(const std::string &p_nomFichier)
 {
-    ifstream fichier(p_nomFichier);
+    m_etatRechargement = EtatRechargement();
+    FichierMappe fichier(p_nomFichier);
+    ajouterLignes(fichier);
+}
 
-    if (!fichier.is_open())
+//! \brief ajoute les lignes depuis un fichier déjà ouvert (voir charger())
+//! \param[in] p_fichier: le fichier, ou le membre d'archive, à lire
+//! \throws logic_error si le fichier n'a pu être ouvert
+void DonneesGTFS::ajouterLignes(const FichierMappe &p_fichier)
+{
+    if (!p_fichier.estOuvert())
     {
         throw std::logic_error("Erreur lors de l'ouverture du fichier de lignes.");
     }
 
-    string ligne;
-    getline(fichier, ligne); // Ignorer la première ligne (en-têtes)
+    LecteurEnregistrements<EnregistrementLigne> lecteur(p_fichier.debut(), p_fichier.fin());
+    EnregistrementLigne enregistrement;
 
-    while (getline(fichier, ligne))
+    while (lecteur.lire(enregistrement))
     {
-        stringstream ss(ligne);
-        string id, numero, description, categorieStr;
-        getline(ss, id, ',');           // Lire l'identifiant de la ligne
-        getline(ss, numero, ',');       // Lire le numéro de la ligne
-        getline(ss, description, ',');  // Lire la description de la ligne
-        getline(ss, categorieStr, ','); // Lire la catégorie de la ligne
-
-        // Convertir la chaîne de caractères en enum CategorieBus
+        // Convertir la couleur en enum CategorieBus
         CategorieBus categorie;
         try
         {
-            categorie = Ligne::couleurToCategorie(categorieStr);
+            categorie = Ligne::couleurToCategorie(enregistrement.couleur.str());
         }
         catch (const std::logic_error &e)
         {
@@ -46,16 +71,13 @@ void DonneesGTFS::ajouterLignes(const std::string &p_nomFichier)
         }
 
         // Créer un objet Ligne
-        Ligne nouvelleLigne(id, numero, description, categorie);
-
-        // Ajouter la nouvelle ligne à m_lignes
-        m_lignes[id] = nouvelleLigne;
+        Ligne nouvelleLigne(enregistrement.ligneId.str(), enregistrement.numero.str(), enregistrement.description.str(),
+                            categorie);
 
-        // Ajouter la nouvelle ligne à m_lignes_par_numero
-        m_lignes_par_numero.insert(std::make_pair(numero, nouvelleLigne));
+        // Ajouter la nouvelle ligne à m_lignes et à m_lignes_par_numero
+        m_lignes.inserer(m_idsLignes.interner(nouvelleLigne.getId()), nouvelleLigne);
+        m_lignes_par_numero.insert(std::make_pair(nouvelleLigne.getNumero(), nouvelleLigne));
     }
-
-    fichier.close();
 }
 
 
@@ -64,35 +86,34 @@ void DonneesGTFS::ajouterLignes(const std::string &p_nomFichier)
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterStations(const std::string &p_nomFichier)
 {
-    ifstream fichier(p_nomFichier);
+    m_etatRechargement = EtatRechargement();
+    FichierMappe fichier(p_nomFichier);
+    ajouterStations(fichier);
+}
 
-    if (!fichier)
+//! \brief ajoute les stations depuis un fichier déjà ouvert (voir charger())
+//! \param[in] p_fichier: le fichier, ou le membre d'archive, à lire
+//! \throws logic_error si le fichier n'a pu être ouvert
+void DonneesGTFS::ajouterStations(const FichierMappe &p_fichier)
+{
+    if (!p_fichier.estOuvert())
     {
         throw logic_error("Erreur lors de l'ouverture du fichier de stations.");
     }
 
-    string ligne;
-    getline(fichier, ligne); // Ignorer la première ligne (en-têtes)
+    LecteurEnregistrements<EnregistrementStation> lecteur(p_fichier.debut(), p_fichier.fin());
+    EnregistrementStation enregistrement;
 
-    while (getline(fichier, ligne))
+    while (lecteur.lire(enregistrement))
     {
-        stringstream ss(ligne);
-        string id, nom, description, latitude, longitude;
-        getline(ss, id, ',');          // Lire l'identifiant de la station
-        getline(ss, nom, ',');         // Lire le nom de la station
-        getline(ss, description, ',');  // Lire la description de la station
-        getline(ss, latitude, ',');     // Lire la latitude de la station
-        getline(ss, longitude, ',');    // Lire la longitude de la station
-
         // Convertir les coordonnées en objet Coordonnees
-        Coordonnees coords(stod(latitude), stod(longitude));
+        Coordonnees coords(enregistrement.latitude, enregistrement.longitude);
 
         // Créer un objet Station et l'ajouter à l'objet DonneesGTFS
-        Station nouvelleStation(id, nom, description, coords);
-        m_stations[id] = nouvelleStation;
+        string id = enregistrement.stationId.str();
+        m_stations.inserer(m_idsStations.interner(id),
+                           Station(id, enregistrement.nom.str(), enregistrement.description.str(), coords));
     }
-
-    fichier.close();
 }
 
 //! \brief ajoute les transferts dans l'objet GTFS
@@ -105,47 +126,76 @@ void DonneesGTFS::ajouterStations(const std::string &p_nomFichier)
 //! \throws logic_error si tous les arrets de la date et de l'intervalle n'ont pas été ajoutés
 void DonneesGTFS::ajouterTransferts(const std::string &p_nomFichier)
 {
+    if (!m_tousLesArretsPresents)
+    {
+        throw std::logic_error("DonneesGTFS::ajouterTransferts(): tous les arrêts n'ont pas été ajoutés");
+    }
+
+    m_etatRechargement = EtatRechargement();
+    std::vector<std::tuple<std::string, std::string, unsigned int> > transferts;
+    lireTransferts(p_nomFichier, transferts);
+    appliquerTransferts(transferts);
+}
 
-    ifstream fichier(p_nomFichier);
+//! \brief lit les transferts qui ont un temps minimal, sans consulter l'objet GTFS
+//! \param[in] p_nomFichier: le nom du fichier contenant les transferts
+//! \param[out] p_transferts: les transferts <from_station_id, to_station_id, min_transfer_time>, dans l'ordre du fichier
+//! \throws logic_error si un problème survient avec la lecture du fichier
+void DonneesGTFS::lireTransferts(const std::string &p_nomFichier,
+                                 std::vector<std::tuple<std::string, std::string, unsigned int> > &p_transferts)
+{
+    FichierMappe fichier(p_nomFichier);
+    lireTransferts(fichier, p_transferts);
+}
 
-    if (!fichier.is_open())
+//! \brief lit les transferts depuis un fichier déjà ouvert (voir charger())
+//! \param[in] p_fichier: le fichier, ou le membre d'archive, à lire
+//! \param[out] p_transferts: les transferts qui ont un temps minimal, dans l'ordre du fichier
+//! \throws logic_error si le fichier n'a pu être ouvert
+void DonneesGTFS::lireTransferts(const FichierMappe &p_fichier,
+                                 std::vector<std::tuple<std::string, std::string, unsigned int> > &p_transferts)
+{
+    if (!p_fichier.estOuvert())
     {
         throw std::logic_error("Erreur lors de l'ouverture du fichier de transferts.");
     }
 
-    string ligne;
-    getline(fichier, ligne); // Ignorer la première ligne (en-têtes)
+    LecteurEnregistrements<EnregistrementTransfert> lecteur(p_fichier.debut(), p_fichier.fin());
+    EnregistrementTransfert enregistrement;
 
-    while (getline(fichier, ligne))
+    p_transferts.clear();
+    while (lecteur.lire(enregistrement))
     {
-        vector<string> elements = string_to_vector(ligne, ',');
-
-        // Vérifier que tous les éléments nécessaires sont présents
-        if (elements.size() < 3)
+        if (enregistrement.tempsMinimal.empty())
         {
-            // Ignorer les lignes invalides
+            // Ignorer les transferts sans temps minimal
             continue;
         }
 
-        string fromStationId = elements[0];
-        string toStationId = elements[1];
-        unsigned int minTransferTime = stoi(elements[2]);
+        p_transferts.push_back(std::make_tuple(enregistrement.deStationId.str(), enregistrement.versStationId.str(),
+                                               champVersEntier(enregistrement.tempsMinimal)));
+    }
+}
 
+//! \brief ajoute les transferts dont les deux stations sont présentes dans l'objet GTFS
+//! \param[in] p_transferts: les transferts lus par lireTransferts()
+void DonneesGTFS::appliquerTransferts(const std::vector<std::tuple<std::string, std::string, unsigned int> > &p_transferts)
+{
+    for (const auto &transfert : p_transferts)
+    {
         // Vérifier si les stations de transfert sont présentes dans l'objet GTFS
-        auto fromStationItr = m_stations.find(fromStationId);
-        auto toStationItr = m_stations.find(toStationId);
-
-        if (fromStationItr != m_stations.end() && toStationItr != m_stations.end())
+        std::uint32_t de = m_idsStations.trouver(get<0>(transfert));
+        std::uint32_t vers = m_idsStations.trouver(get<1>(transfert));
+        if (m_stations.contient(de) && m_stations.contient(vers))
         {
             // Ajouter le transfert dans m_transferts
-            m_transferts.push_back(std::make_tuple(fromStationId, toStationId, minTransferTime));
+            m_transferts.push_back(std::make_tuple(de, vers, get<2>(transfert)));
 
             // Ajouter from_station_id dans m_stationsDeTransfert
-            m_stationsDeTransfert.insert(fromStationId);
+            m_stationsDeTransfert.ajouter(de);
         }
     }
-
-    fichier.close();
+    indexerTransferts();
 }
 
 
@@ -154,51 +204,32 @@ void DonneesGTFS::ajouterTransferts(const std::string &p_nomFichier)
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterServices(const std::string &p_nomFichier)
 {
-    std::ifstream fichier(p_nomFichier);
-    if (!fichier)
+    m_etatRechargement = EtatRechargement();
+    FichierMappe fichier(p_nomFichier);
+    ajouterServices(fichier);
+}
+
+//! \brief ajoute les services de la date depuis un fichier déjà ouvert (voir charger())
+//! \param[in] p_fichier: le fichier, ou le membre d'archive, à lire
+//! \throws logic_error si le fichier n'a pu être ouvert
+void DonneesGTFS::ajouterServices(const FichierMappe &p_fichier)
+{
+    if (!p_fichier.estOuvert())
     {
         throw std::logic_error("Erreur lors de l'ouverture du fichier de services.");
     }
 
-    std::string ligne;
-    while (std::getline(fichier, ligne))
-    {
-        std::istringstream ss(ligne);
-        std::vector<std::string> elements = string_to_vector(ligne, ',');
+    LecteurEnregistrements<EnregistrementService> lecteur(p_fichier.debut(), p_fichier.fin());
+    EnregistrementService enregistrement;
 
-        if (elements.size() >= 3)
-        {
-            std::string serviceId = elements[0];
-            std::string startDateStr = elements[1];
-            std::string endDateStr = elements[2];
-
-            // Extraction de l'année, du mois et du jour du début et de fin à partir des chaînes de caractères
-            unsigned int anDebut, moisDebut, jourDebut, anFin, moisFin, jourFin;
-            char delimiter;
-            std::istringstream ssStartDate(startDateStr);
-            std::istringstream ssEndDate(endDateStr);
-            ssStartDate >> anDebut >> delimiter >> moisDebut >> delimiter >> jourDebut;
-            ssEndDate >> anFin >> delimiter >> moisFin >> delimiter >> jourFin;
-
-            // Création des objets Date
-            Date debut(anDebut, moisDebut, jourDebut);
-            Date fin(anFin, moisFin, jourFin);
-
-            // Vérification si la date du service est dans la plage d'intérêt (m_now1 et m_now2)
-            if (debut < m_date && fin > m_date)
-            {
-                // La date de début est antérieure à la date d'intérêt, et la date de fin est postérieure,
-                // ajouter le service
-                m_services.insert(serviceId);
-            }
-        }
-        else
+    while (lecteur.lire(enregistrement))
+    {
+        // Le service est offert à la date d'intérêt s'il y est ajouté (exception_type == 1)
+        if (enregistrement.typeException == 1 && enregistrement.date == m_date)
         {
-            throw std::logic_error("Format de fichier de services incorrect.");
+            m_services.ajouter(m_idsServices.interner(enregistrement.serviceId));
         }
     }
-
-    fichier.close();
 }
 
 //! \brief ajoute les voyages de la date
@@ -207,33 +238,34 @@ void DonneesGTFS::ajouterServices(const std::string &p_nomFichier)
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterVoyagesDeLaDate(const std::string &p_nomFichier)
 {
-    // Lire le fichier des voyages
-    std::ifstream fichier(p_nomFichier);
-    if (!fichier.is_open()) {
+    m_etatRechargement = EtatRechargement();
+    FichierMappe fichier(p_nomFichier);
+    ajouterVoyagesDeLaDate(fichier);
+}
+
+//! \brief ajoute les voyages de la date depuis un fichier déjà ouvert (voir charger())
+//! \param[in] p_fichier: le fichier, ou le membre d'archive, à lire
+//! \throws logic_error si le fichier n'a pu être ouvert
+void DonneesGTFS::ajouterVoyagesDeLaDate(const FichierMappe &p_fichier)
+{
+    if (!p_fichier.estOuvert()) {
         throw std::logic_error("Erreur lors de l'ouverture du fichier des voyages.");
     }
 
-    std::string ligne;
-    std::getline(fichier, ligne); // Ignorer la première ligne (en-têtes)
+    LecteurEnregistrements<EnregistrementVoyage> lecteur(p_fichier.debut(), p_fichier.fin());
+    EnregistrementVoyage enregistrement;
 
     // Parcourir le fichier des voyages ligne par ligne
-    while (std::getline(fichier, ligne)) {
-        std::vector<std::string> tokens = string_to_vector(ligne, ',');
-
+    while (lecteur.lire(enregistrement)) {
         // Vérifier si le voyage appartient au service de la date actuelle
-        if (m_services.find(tokens[1]) != m_services.end()) {
-            std::string voyage_id = tokens[0];
-            std::string ligne_id = tokens[1];
-            std::string service_id = tokens[2];
-            std::string destination = tokens[3];
-
+        std::uint32_t service = m_idsServices.trouver(enregistrement.serviceId);
+        if (m_services.contient(service)) {
             // Créer le voyage et l'ajouter à m_voyages
-            Voyage nouveauVoyage(voyage_id, ligne_id, service_id, destination);
-            m_voyages[voyage_id] = nouveauVoyage;
+            std::uint32_t voyage = m_idsVoyages.interner(enregistrement.voyageId);
+            m_voyages.inserer(voyage, Voyage(voyage, m_idsLignes.interner(enregistrement.ligneId), service,
+                                             enregistrement.destination.str()));
         }
     }
-
-    fichier.close();
 }
 
 
@@ -246,50 +278,133 @@ void DonneesGTFS::ajouterVoyagesDeLaDate(const std::string &p_nomFichier)
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterArretsDesVoyagesDeLaDate(const std::string &p_nomFichier)
 {
-    // On ouvre le fichier contenant les arrêts
-    std::ifstream fichierArrets(p_nomFichier);
-    if (!fichierArrets) {
+    m_etatRechargement = EtatRechargement();
+    FichierMappe fichier(p_nomFichier);
+    ajouterArretsDesVoyagesDeLaDate(fichier);
+}
+
+//! \brief ajoute les arrêts de la date et de l'intervalle depuis un fichier déjà ouvert (voir charger())
+//! \param[in] p_fichier: le fichier, ou le membre d'archive, à lire
+//! \throws logic_error si le fichier n'a pu être ouvert
+void DonneesGTFS::ajouterArretsDesVoyagesDeLaDate(const FichierMappe &p_fichier)
+{
+    if (!p_fichier.estOuvert()) {
         throw std::logic_error("Impossible d'ouvrir le fichier contenant les arrêts");
     }
 
-    // On lit le fichier arrêt par arrêt
-    std::string ligne;
-    while (getline(fichierArrets, ligne)) {
-        // On parse la ligne
-        std::vector<std::string> champs = string_to_vector(ligne, ',');
-
-        // On récupère les informations de l'arrêt
-        std::string stationId = champs[0];
-        Heure heureDepart(std::stoi(champs[2]), std::stoi(champs[3]), 0);
-        Heure heureArrivee(std::stoi(champs[4]), std::stoi(champs[5]), 0);
-        unsigned int numeroSequence = std::stoi(champs[4]);
-        std::string voyageId = champs[5];
-
-        // On vérifie que l'arrêt est dans l'intervalle de temps
-        if (heureDepart >= m_now1 && heureArrivee < m_now2) {
-            // On ajoute l'arrêt au voyage correspondant
-            auto it = m_voyages.find(voyageId);
-            if (it != m_voyages.end()) {
-                // On vérifie si le voyage n'a plus d'arrêt
-                if (it->second.getArrets().size() == 1) {
-                    // On supprime le voyage
-                    m_voyages.erase(it);
+    // Le fichier est distribué aux fils en morceaux alignés sur les lignes, que chacun lit et filtre à son tour. Un
+    // membre d'archive ouvert en différé est lu à mesure qu'il est décompressé. Le premier morceau contient l'en-tête
+    auto debut = std::chrono::steady_clock::now();
+    DistributeurLignes distributeur(p_fichier, p_fichier.debut(), TAILLE_MORCEAU_ARRETS);
+    std::size_t premier;
+    const char *debutPremier = p_fichier.debut();
+    const char *finPremier = p_fichier.debut();
+    distributeur.prendre(premier, debutPremier, finPremier);
+    LecteurEnregistrements<EnregistrementArret> entete(debutPremier, finPremier);
+
+    std::size_t nbFils = std::min<std::size_t>(nbFilsDisponibles(), 1 + p_fichier.taille() / TAILLE_MORCEAU_ARRETS);
+    std::vector<std::vector<std::pair<std::size_t, MorceauRetenu> > > parFil(nbFils); //(rang, morceau)
+    std::vector<StatistiquesArrets> statistiques(nbFils);
+
+    executerEnParallele(nbFils, [&](std::size_t f) {
+        EnregistrementArret enregistrement;
+        StatistiquesArrets &stats = statistiques[f];
+
+        // Le filtre ne voit que trip_id, arrival_time et departure_time: une ligne rejetée n'est pas lue plus loin.
+        // m_voyages et les tables d'identifiants ne sont que consultés ici: les fils peuvent les partager. Les clés
+        // sont cherchées directement dans le tampon du fichier, sans copie
+        std::uint32_t voyage = TableIdentifiants::ABSENT;
+        auto filtre = [&](const EnregistrementArret &p_arret) -> bool {
+            ++stats.nbLignesLues;
+            // On vérifie que l'arrêt est dans l'intervalle de temps
+            if (!(p_arret.heureDepart >= m_now1 && p_arret.heureArrivee < m_now2)) {
+                ++stats.nbRejeteesIntervalle;
+                return false;
+            }
+            // On vérifie que le voyage est présent
+            voyage = m_idsVoyages.trouver(p_arret.voyageId);
+            if (!m_voyages.contient(voyage)) {
+                ++stats.nbRejeteesVoyage;
+                return false;
+            }
+            return true;
+        };
+
+        // Seuls les arrêts retenus sont lus au complet; seul un stop_id inconnu est copié
+        auto lireMorceau = [&](std::size_t p_rang, const char *p_debut, const char *p_fin) {
+            LecteurEnregistrements<EnregistrementArret> lecteur(entete, p_debut, p_fin);
+            parFil[f].push_back(std::make_pair(p_rang, MorceauRetenu()));
+            MorceauRetenu &morceau = parFil[f].back().second;
+            while (lecteur.lire(enregistrement, filtre)) {
+                std::uint32_t station = m_idsStations.trouver(enregistrement.stationId);
+                if (station == TableIdentifiants::ABSENT) {
+                    ArretSansIdentifiant sansIdentifiant = {morceau.arrets.size(), enregistrement.stationId.str()};
+                    morceau.sansIdentifiant.push_back(sansIdentifiant);
                 }
-
-                it->second.ajouterArret(std::make_shared<Arret>(stationId, heureDepart, heureArrivee, numeroSequence, voyageId));
+                morceau.arrets.push_back(Arret(station, enregistrement.heureArrivee, enregistrement.heureDepart,
+                                               enregistrement.numeroSequence, voyage));
             }
+        };
+
+        if (f == 0) lireMorceau(premier, entete.position(), finPremier);
+        std::size_t rang;
+        const char *debutMorceau, *finMorceau;
+        while (distributeur.prendre(rang, debutMorceau, finMorceau)) lireMorceau(rang, debutMorceau, finMorceau);
+    });
+
+    m_statistiquesArrets = StatistiquesArrets();
+    for (const auto &stats : statistiques) {
+        m_statistiquesArrets.nbLignesLues += stats.nbLignesLues;
+        m_statistiquesArrets.nbRejeteesIntervalle += stats.nbRejeteesIntervalle;
+        m_statistiquesArrets.nbRejeteesVoyage += stats.nbRejeteesVoyage;
+    }
+    m_statistiquesArrets.dureeLecture = std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+
+    // On fusionne les morceaux dans l'ordre du fichier: le résultat est identique à une lecture séquentielle.
+    // Les stations absentes de stops.txt sont internées ici, dans l'ordre de leur apparition. Tous les arrêts
+    // retenus sont copiés dans un même bloc de l'arène
+    std::size_t nbMorceaux = 0;
+    for (const auto &morceaux : parFil) nbMorceaux += morceaux.size();
+    std::vector<MorceauRetenu *> retenus(nbMorceaux);
+    std::size_t nbRetenus = 0;
+    for (auto &morceaux : parFil) {
+        for (auto &morceau : morceaux) {
+            retenus[morceau.first] = &morceau.second;
+            nbRetenus += morceau.second.arrets.size();
+        }
+    }
+    m_arrets.reserver(nbRetenus);
+    for (MorceauRetenu *retenu : retenus) {
+        MorceauRetenu &morceau = *retenu;
+        for (const auto &a : morceau.sansIdentifiant) {
+            const Arret &incomplet = morceau.arrets[a.position];
+            morceau.arrets[a.position] = Arret(m_idsStations.interner(a.stationId), incomplet.getHeureArrivee(),
+                                               incomplet.getHeureDepart(), incomplet.getNumeroSequence(),
+                                               incomplet.getVoyage());
+        }
+        for (const auto &valeur : morceau.arrets) {
+            m_arrets.creer(valeur);
+            ++m_nbArrets;
         }
     }
 
-    // On ferme le fichier arrêts
-    fichierArrets.close();
+    // Les voyages et les stations désignent leurs arrêts dans la table en colonnes et dans l'index des stations,
+    // reconstruits avec les arrêts des appels précédents
+    indexerArrets();
+
+    // On supprime les voyages qui n'ont pas d'arrêts
+    for (std::uint32_t id = 0; id < m_voyages.identifiants().borne(); ++id) {
+        if (m_voyages.contient(id) && m_voyages[id].getArrets().empty()) {
+            m_voyages.retirer(id);
+        }
+    }
 
     // On supprime les stations qui n'ont pas d'arrêts
-    for (auto it = m_stations.begin(); it != m_stations.end();) {
-        if (it->second.getArrets().empty()) {
-            it = m_stations.erase(it);
-        } else {
-            it++;
+    for (std::uint32_t id = 0; id < m_stations.identifiants().borne(); ++id) {
+        if (m_stations.contient(id) && m_stations[id].getArrets().empty()) {
+            m_stations.retirer(id);
         }
     }
+
+    m_tousLesArretsPresents = true;
 }
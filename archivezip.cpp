@@ -0,0 +1,384 @@
+//
+// Lecture des membres d'une archive zip (fichiers GTFS distribués compressés), sans extraction sur le disque.
+//
+
+#include "archivezip.h"
+
+#include <algorithm>
+#include <sys/stat.h>
+#include <zlib.h>
+
+using namespace std;
+
+namespace
+{
+    const std::uint32_t SIGNATURE_FIN_REPERTOIRE = 0x06054b50;
+    const std::uint32_t SIGNATURE_FIN_REPERTOIRE_ZIP64 = 0x06064b50;
+    const std::uint32_t SIGNATURE_LOCALISATEUR_ZIP64 = 0x07064b50;
+    const std::uint32_t SIGNATURE_ENTREE_REPERTOIRE = 0x02014b50;
+    const std::uint32_t SIGNATURE_ENTETE_LOCAL = 0x04034b50;
+
+    const std::size_t TAILLE_FIN_REPERTOIRE = 22;
+    const std::size_t TAILLE_LOCALISATEUR_ZIP64 = 20;
+    const std::size_t TAILLE_FIN_REPERTOIRE_ZIP64 = 56;
+    const std::size_t TAILLE_ENTREE_REPERTOIRE = 46;
+    const std::size_t TAILLE_ENTETE_LOCAL = 30;
+    const std::size_t TAILLE_MAX_COMMENTAIRE = 0xffff;
+
+    const std::uint16_t EXTRA_ZIP64 = 0x0001;
+    const std::uint32_t MARQUEUR_ZIP64 = 0xffffffff;
+
+    const std::uint16_t METHODE_STOCKE = 0;
+    const std::uint16_t METHODE_DEFLATE = 8;
+
+    //! deflate ne peut pas faire mieux qu'une copie de 258 octets en deux bits (code de longueur et de distance)
+    const std::uint64_t RAPPORT_MAX_DEFLATE = 258 * 8 / 2;
+
+    //! taille des tranches passées à zlib, dont les compteurs sont sur 32 bits; le CRC est calculé par tranche,
+    //! pendant qu'elle est encore dans le cache
+    const std::size_t TAILLE_TRANCHE = 1 << 18;
+
+    //les champs d'une archive zip sont en petit-boutiste
+    inline std::uint16_t lire16(const char *p)
+    {
+        const unsigned char *u = reinterpret_cast<const unsigned char *>(p);
+        return (std::uint16_t) (u[0] | (u[1] << 8));
+    }
+
+    inline std::uint32_t lire32(const char *p)
+    {
+        return (std::uint32_t) lire16(p) | ((std::uint32_t) lire16(p + 2) << 16);
+    }
+
+    inline std::uint64_t lire64(const char *p)
+    {
+        return (std::uint64_t) lire32(p) | ((std::uint64_t) lire32(p + 4) << 32);
+    }
+
+    void erreur(const std::string &p_message)
+    {
+        throw std::logic_error("ArchiveZip: " + p_message);
+    }
+}
+
+/*!
+ * \brief Lit le répertoire central de l'archive [p_debut, p_fin)
+ * \param[in] p_debut: le premier octet de l'archive
+ * \param[in] p_fin: la position suivant le dernier octet de l'archive
+ * \pre le tampon doit exister tant que l'objet et les membres stockés qu'il a donnés sont utilisés
+ * \throws logic_error si le tampon n'est pas une archive zip valide
+ */
+ArchiveZip::ArchiveZip(const char *p_debut, const char *p_fin) : m_debut(p_debut), m_fin(p_fin)
+{
+    lireRepertoire();
+}
+
+//! \brief trouve la fin du répertoire central (en partant de la fin, après un éventuel commentaire) et lit ses entrées
+void ArchiveZip::lireRepertoire()
+{
+    std::size_t taille = (std::size_t) (m_fin - m_debut);
+    if (taille < TAILLE_FIN_REPERTOIRE) erreur("fichier trop court pour être une archive");
+
+    std::size_t plancher = taille - TAILLE_FIN_REPERTOIRE > TAILLE_MAX_COMMENTAIRE
+                           ? taille - TAILLE_FIN_REPERTOIRE - TAILLE_MAX_COMMENTAIRE : 0;
+    const char *fin = nullptr;
+    for (std::size_t decalage = taille - TAILLE_FIN_REPERTOIRE + 1; decalage-- > plancher;)
+    {
+        if (lire32(m_debut + decalage) == SIGNATURE_FIN_REPERTOIRE)
+        {
+            fin = m_debut + decalage;
+            break;
+        }
+    }
+    if (fin == nullptr) erreur("fin du répertoire central introuvable");
+
+    std::uint64_t nbEntrees = lire16(fin + 10);
+    std::uint64_t tailleRepertoire = lire32(fin + 12);
+    std::uint64_t decalageRepertoire = lire32(fin + 16);
+
+    const char *localisateur = fin - TAILLE_LOCALISATEUR_ZIP64;
+    if (localisateur >= m_debut && lire32(localisateur) == SIGNATURE_LOCALISATEUR_ZIP64)
+    {
+        std::uint64_t decalage = lire64(localisateur + 8);
+        if (decalage + TAILLE_FIN_REPERTOIRE_ZIP64 > taille || lire32(m_debut + decalage) != SIGNATURE_FIN_REPERTOIRE_ZIP64)
+            erreur("fin du répertoire central ZIP64 invalide");
+        nbEntrees = lire64(m_debut + decalage + 32);
+        tailleRepertoire = lire64(m_debut + decalage + 40);
+        decalageRepertoire = lire64(m_debut + decalage + 48);
+    }
+    if (decalageRepertoire + tailleRepertoire > taille) erreur("répertoire central hors de l'archive");
+
+    m_membres.clear();
+    m_membres.reserve((std::size_t) std::min<std::uint64_t>(nbEntrees, tailleRepertoire / TAILLE_ENTREE_REPERTOIRE));
+    const char *p = m_debut + decalageRepertoire;
+    const char *finRepertoire = p + tailleRepertoire;
+    for (std::uint64_t i = 0; i < nbEntrees; ++i)
+    {
+        if (finRepertoire - p < (std::ptrdiff_t) TAILLE_ENTREE_REPERTOIRE || lire32(p) != SIGNATURE_ENTREE_REPERTOIRE)
+            erreur("entrée du répertoire central invalide");
+        std::uint16_t drapeaux = lire16(p + 8);
+        std::size_t longueurNom = lire16(p + 28);
+        std::size_t longueurExtra = lire16(p + 30);
+        std::size_t longueurCommentaire = lire16(p + 32);
+        const char *nom = p + TAILLE_ENTREE_REPERTOIRE;
+        const char *extra = nom + longueurNom;
+        const char *suivant = extra + longueurExtra + longueurCommentaire;
+        if (suivant > finRepertoire) erreur("entrée du répertoire central tronquée");
+
+        MembreZip membre;
+        membre.nom.assign(nom, longueurNom);
+        membre.methode = lire16(p + 10);
+        membre.crc = lire32(p + 16);
+        membre.tailleCompressee = lire32(p + 20);
+        membre.tailleDecompressee = lire32(p + 24);
+        membre.decalageEntete = lire32(p + 42);
+        if (drapeaux & 1) erreur("membre chiffré non supporté: " + membre.nom);
+
+        //les champs à 0xffffffff sont dans l'extra ZIP64, dans cet ordre
+        for (const char *e = extra; e + 4 <= extra + longueurExtra;)
+        {
+            std::uint16_t type = lire16(e);
+            std::size_t longueur = lire16(e + 2);
+            const char *champ = e + 4;
+            const char *finChamp = champ + longueur;
+            if (finChamp > extra + longueurExtra) break;
+            if (type == EXTRA_ZIP64)
+            {
+                if (membre.tailleDecompressee == MARQUEUR_ZIP64 && champ + 8 <= finChamp)
+                {
+                    membre.tailleDecompressee = lire64(champ);
+                    champ += 8;
+                }
+                if (membre.tailleCompressee == MARQUEUR_ZIP64 && champ + 8 <= finChamp)
+                {
+                    membre.tailleCompressee = lire64(champ);
+                    champ += 8;
+                }
+                if (membre.decalageEntete == MARQUEUR_ZIP64 && champ + 8 <= finChamp)
+                {
+                    membre.decalageEntete = lire64(champ);
+                }
+            }
+            e = finChamp;
+        }
+        m_membres.push_back(membre);
+        p = suivant;
+    }
+}
+
+const std::vector<MembreZip> &ArchiveZip::getMembres() const
+{
+    return m_membres;
+}
+
+/*!
+ * \brief cherche un membre par son nom
+ * \brief Si aucun membre n'a exactement ce nom, un membre unique dont le nom finit par "/" + p_nom est retenu:
+ * plusieurs agences placent les fichiers GTFS dans un dossier à l'intérieur de l'archive
+ * \param[in] p_nom: le nom du membre, par exemple "stop_times.txt"
+ * \return le membre, ou nullptr s'il est absent (ou ambigu)
+ */
+const MembreZip *ArchiveZip::trouver(const std::string &p_nom) const
+{
+    const MembreZip *candidat = nullptr;
+    std::size_t nbCandidats = 0;
+    std::string suffixe = "/" + p_nom;
+    for (const MembreZip &membre : m_membres)
+    {
+        if (membre.nom == p_nom) return &membre;
+        if (membre.nom.size() > suffixe.size() &&
+            membre.nom.compare(membre.nom.size() - suffixe.size(), suffixe.size(), suffixe) == 0)
+        {
+            candidat = &membre;
+            ++nbCandidats;
+        }
+    }
+    return nbCandidats == 1 ? candidat : nullptr;
+}
+
+/*!
+ * \brief donne le début des données (compressées ou non) d'un membre, après son en-tête local
+ * \note seuls tailleCompressee octets sont garantis dans l'archive: pour un membre stocké, verifierStocke() vérifie
+ * aussi que la taille décompressée est la même
+ * \throws logic_error si l'en-tête local est invalide ou si les données dépassent l'archive
+ */
+const char *ArchiveZip::donnees(const MembreZip &p_membre) const
+{
+    std::size_t taille = (std::size_t) (m_fin - m_debut);
+    if (p_membre.decalageEntete > taille || taille - p_membre.decalageEntete < TAILLE_ENTETE_LOCAL ||
+        lire32(m_debut + p_membre.decalageEntete) != SIGNATURE_ENTETE_LOCAL)
+        erreur("en-tête local invalide: " + p_membre.nom);
+
+    const char *entete = m_debut + p_membre.decalageEntete;
+    std::uint64_t debut = p_membre.decalageEntete + TAILLE_ENTETE_LOCAL + lire16(entete + 26) + lire16(entete + 28);
+    if (debut > taille || p_membre.tailleCompressee > taille - debut) erreur("membre tronqué: " + p_membre.nom);
+    return m_debut + debut;
+}
+
+/*!
+ * \brief vérifie les tailles annoncées par le répertoire, avant qu'un tampon soit alloué à la taille décompressée
+ * \brief Les données compressées doivent tenir dans l'archive, et la taille décompressée ne peut dépasser ce que la
+ * méthode produit à partir d'elles: la même taille pour un membre stocké, RAPPORT_MAX_DEFLATE fois plus pour deflate
+ * \return le début des données du membre dans l'archive
+ * \throws logic_error si la méthode n'est pas supportée, si le membre est tronqué ou si sa taille décompressée est
+ * impossible
+ */
+const char *ArchiveZip::verifierTailles(const MembreZip &p_membre) const
+{
+    const char *source = donnees(p_membre);
+    if (p_membre.methode == METHODE_STOCKE)
+    {
+        if (p_membre.tailleCompressee != p_membre.tailleDecompressee) erreur("membre stocké incohérent: " + p_membre.nom);
+    }
+    else if (p_membre.methode == METHODE_DEFLATE)
+    {
+        if (p_membre.tailleDecompressee / RAPPORT_MAX_DEFLATE > p_membre.tailleCompressee)
+            erreur("taille décompressée impossible: " + p_membre.nom);
+    }
+    else
+    {
+        erreur("méthode de compression non supportée: " + p_membre.nom);
+    }
+    return source;
+}
+
+/*!
+ * \brief vérifie un membre stocké avant qu'il soit lu en place: tailles égales, données dans l'archive et CRC
+ * \return le début de ses tailleDecompressee octets dans l'archive
+ * \throws logic_error si le membre n'est pas stocké, si ses tailles diffèrent, s'il est tronqué ou si son CRC est
+ * incorrect
+ */
+const char *ArchiveZip::verifierStocke(const MembreZip &p_membre) const
+{
+    if (p_membre.methode != METHODE_STOCKE) erreur("membre non stocké: " + p_membre.nom);
+    const char *source = verifierTailles(p_membre);
+    uLong crc = crc32(0L, Z_NULL, 0);
+    for (std::uint64_t fait = 0; fait < p_membre.tailleDecompressee;)
+    {
+        std::size_t tranche = (std::size_t) std::min<std::uint64_t>(TAILLE_TRANCHE, p_membre.tailleDecompressee - fait);
+        crc = crc32(crc, reinterpret_cast<const Bytef *>(source + fait), (uInt) tranche);
+        fait += tranche;
+    }
+    if (crc != p_membre.crc) erreur("CRC incorrect: " + p_membre.nom);
+    return source;
+}
+
+/*!
+ * \brief écrit le contenu d'un membre dans p_destination et vérifie son CRC
+ * \param[in] p_membre: un membre de l'archive (stocké ou deflate)
+ * \param[out] p_destination: un tampon d'au moins p_membre.tailleDecompressee octets
+ * \throws logic_error si la méthode n'est pas supportée ou si les données sont corrompues
+ */
+void ArchiveZip::decompresser(const MembreZip &p_membre, char *p_destination) const
+{
+    DecompressionZip decompression(*this, p_membre, p_destination);
+    while (!decompression.estTerminee()) decompression.avancer();
+}
+
+/*!
+ * \brief prépare la décompression de p_membre dans p_destination; rien n'est écrit avant le premier avancer()
+ * \param[in] p_archive: l'archive, dont la projection doit exister jusqu'à la fin de la décompression
+ * \param[in] p_membre: un membre de l'archive (stocké ou deflate)
+ * \param[out] p_destination: un tampon d'au moins p_membre.tailleDecompressee octets
+ * \throws logic_error si la méthode n'est pas supportée ou si les tailles annoncées sont impossibles
+ */
+DecompressionZip::DecompressionZip(const ArchiveZip &p_archive, const MembreZip &p_membre, char *p_destination)
+        : m_membre(p_membre), m_source(p_archive.verifierTailles(p_membre)), m_destination(p_destination),
+          m_flux(nullptr), m_lu(0), m_ecrit(0), m_crc(crc32(0L, Z_NULL, 0)), m_terminee(false)
+{
+    if (p_membre.methode == METHODE_STOCKE) return;
+    m_flux = new z_stream();
+    if (inflateInit2(m_flux, -MAX_WBITS) != Z_OK)
+    {
+        delete m_flux;
+        erreur("initialisation de zlib impossible");
+    }
+}
+
+DecompressionZip::~DecompressionZip()
+{
+    if (m_flux == nullptr) return;
+    inflateEnd(m_flux);
+    delete m_flux;
+}
+
+/*!
+ * \brief écrit au plus TAILLE_TRANCHE octets de plus, à la suite de produit()
+ * \brief La fin du membre peut demander un dernier appel qui n'écrit rien
+ * \throws logic_error si les données sont corrompues, ou si la taille ou le CRC du membre complet sont incorrects
+ */
+void DecompressionZip::avancer()
+{
+    if (m_terminee) return;
+    std::size_t place = (std::size_t) std::min<std::uint64_t>(TAILLE_TRANCHE, m_membre.tailleDecompressee - m_ecrit);
+    char *tranche = m_destination + m_ecrit;
+
+    if (m_flux == nullptr)
+    {
+        std::copy(m_source + m_ecrit, m_source + m_ecrit + place, tranche);
+        m_terminee = m_ecrit + place == m_membre.tailleDecompressee;
+    }
+    else
+    {
+        m_flux->next_out = reinterpret_cast<Bytef *>(tranche);
+        m_flux->avail_out = (uInt) place;
+        int code;
+        do
+        {
+            if (m_flux->avail_in == 0 && m_lu < m_membre.tailleCompressee)
+            {
+                std::size_t entree = (std::size_t) std::min<std::uint64_t>(1u << 30, m_membre.tailleCompressee - m_lu);
+                m_flux->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(m_source + m_lu));
+                m_flux->avail_in = (uInt) entree;
+                m_lu += entree;
+            }
+            code = inflate(m_flux, Z_NO_FLUSH);
+            if (code != Z_OK && code != Z_STREAM_END) //Z_BUF_ERROR: aucun progrès possible, membre tronqué ou plus long qu'annoncé
+                erreur("données compressées corrompues: " + m_membre.nom);
+        } while (code != Z_STREAM_END && m_flux->avail_out > 0);
+        place -= m_flux->avail_out;
+        m_terminee = code == Z_STREAM_END;
+        if (m_terminee && m_ecrit + place != m_membre.tailleDecompressee)
+            erreur("taille décompressée incorrecte: " + m_membre.nom);
+    }
+
+    m_crc = crc32(m_crc, reinterpret_cast<const Bytef *>(tranche), (uInt) place);
+    m_ecrit += place;
+    if (m_terminee && m_crc != m_membre.crc) erreur("CRC incorrect: " + m_membre.nom);
+}
+
+//! \brief le nombre d'octets déjà écrits au début du tampon
+std::size_t DecompressionZip::produit() const
+{
+    return (std::size_t) m_ecrit;
+}
+
+//! \brief vrai lorsque le membre est décompressé au complet et que sa taille et son CRC ont été vérifiés
+bool DecompressionZip::estTerminee() const
+{
+    return m_terminee;
+}
+
+/*!
+ * \brief reconnaît un chemin qui désigne un membre d'archive, comme "gtfs.zip/stop_times.txt"
+ * \param[in] p_chemin: le chemin à analyser
+ * \param[out] p_archive: le plus court préfixe de p_chemin qui est un fichier ordinaire
+ * \param[out] p_membre: le reste du chemin, après le '/' qui suit l'archive
+ * \return false si aucun préfixe du chemin n'est un fichier ordinaire, ou si le chemin lui-même en est un
+ */
+bool separerCheminArchive(const std::string &p_chemin, std::string &p_archive, std::string &p_membre)
+{
+    for (std::size_t barre = p_chemin.find('/', 1); barre != std::string::npos; barre = p_chemin.find('/', barre + 1))
+    {
+        struct stat infos;
+        std::string prefixe = p_chemin.substr(0, barre);
+        if (stat(prefixe.c_str(), &infos) != 0) return false;
+        if (S_ISREG(infos.st_mode))
+        {
+            p_archive = prefixe;
+            p_membre = p_chemin.substr(barre + 1);
+            return !p_membre.empty();
+        }
+    }
+    return false;
+}
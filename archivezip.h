@@ -0,0 +1,92 @@
+//
+// Lecture des membres d'une archive zip (fichiers GTFS distribués compressés), sans extraction sur le disque.
+//
+
+#ifndef RTC_ARCHIVEZIP_H
+#define RTC_ARCHIVEZIP_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+/*!
+ * \struct MembreZip
+ * \brief Un fichier de l'archive, d'après le répertoire central
+ */
+struct MembreZip
+{
+    std::string nom;
+    std::uint16_t methode; //0: stocké, 8: deflate
+    std::uint32_t crc;
+    std::uint64_t tailleCompressee;
+    std::uint64_t tailleDecompressee;
+    std::uint64_t decalageEntete; //position de l'en-tête local du membre dans l'archive
+};
+
+/*!
+ * \class ArchiveZip
+ * \brief Répertoire d'une archive zip projetée en mémoire
+ *
+ *  L'archive n'est pas copiée: les membres stockés sont lus directement dans le tampon de l'archive, les membres
+ *  compressés (deflate) sont décompressés dans un tampon de la taille finale, d'un seul trait ou par tranches
+ *  (DecompressionZip). Les extensions ZIP64 sont reconnues; le chiffrement ne l'est pas.
+ */
+class ArchiveZip
+{
+public:
+    ArchiveZip(const char *p_debut, const char *p_fin);
+
+    const std::vector<MembreZip> &getMembres() const;
+    const MembreZip *trouver(const std::string &p_nom) const;
+    const char *donnees(const MembreZip &p_membre) const;
+    const char *verifierTailles(const MembreZip &p_membre) const;
+    const char *verifierStocke(const MembreZip &p_membre) const;
+    void decompresser(const MembreZip &p_membre, char *p_destination) const;
+
+private:
+    void lireRepertoire();
+
+    const char *m_debut;
+    const char *m_fin;
+    std::vector<MembreZip> m_membres;
+};
+
+struct z_stream_s;
+
+/*!
+ * \class DecompressionZip
+ * \brief Décompression d'un membre par tranches successives, dans un tampon de sa taille finale
+ *
+ *  Chaque appel à avancer() écrit la tranche suivante à la suite des précédentes et met le CRC à jour; la taille et
+ *  le CRC sont vérifiés à la fin du membre. Les produit() premiers octets du tampon peuvent être lus pendant que la
+ *  suite est décompressée. L'objet n'est pas copiable.
+ */
+class DecompressionZip
+{
+public:
+    DecompressionZip(const ArchiveZip &p_archive, const MembreZip &p_membre, char *p_destination);
+    ~DecompressionZip();
+
+    void avancer();
+    std::size_t produit() const;
+    bool estTerminee() const;
+
+private:
+    DecompressionZip(const DecompressionZip &);
+    DecompressionZip &operator=(const DecompressionZip &);
+
+    MembreZip m_membre;
+    const char *m_source;
+    char *m_destination;
+    z_stream_s *m_flux; //nullptr pour un membre stocké
+    std::uint64_t m_lu;
+    std::uint64_t m_ecrit;
+    unsigned long m_crc;
+    bool m_terminee;
+};
+
+bool separerCheminArchive(const std::string &p_chemin, std::string &p_archive, std::string &p_membre);
+
+#endif //RTC_ARCHIVEZIP_H
@@ -0,0 +1,129 @@
+//
+// Arène d'enregistrements compacts: allocation par incrément dans de grands blocs, libérés tous ensemble.
+//
+
+#ifndef RTC_ARENE_H
+#define RTC_ARENE_H
+
+#include <vector>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+
+/*!
+ * \class Arene
+ * \brief Alloue des T les uns à la suite des autres dans des blocs qui ne sont jamais déplacés
+ *
+ *  Un T créé garde son adresse jusqu'à vider(): les poignées (T*) qui le désignent restent valides aussi longtemps
+ *  que l'arène. Les T ne sont jamais détruits un à un, d'où l'exigence qu'ils soient trivialement destructibles; un
+ *  T abandonné occupe sa place jusqu'à vider(). Avec reserver(), un chargement complet tient dans un seul bloc:
+ *  une seule allocation et une seule libération.
+ */
+template<typename T>
+class Arene
+{
+    static_assert(std::is_trivially_destructible<T>::value, "Arene: T doit être trivialement destructible");
+
+public:
+    //! \param[in] p_tailleBloc: le nombre de T d'un bloc alloué sans reserver(); 0 est ramené à 1
+    explicit Arene(std::size_t p_tailleBloc = 4096)
+            : m_tailleBloc(p_tailleBloc > 0 ? p_tailleBloc : 1), m_courant(nullptr), m_restants(0), m_nombre(0)
+    {
+    }
+
+    Arene(const Arene &) = delete;
+    Arene &operator=(const Arene &) = delete;
+
+    ~Arene()
+    {
+        vider();
+    }
+
+    //! \brief construit un T dans l'arène
+    //! \return une poignée valide jusqu'à vider()
+    template<typename... Arguments>
+    T *creer(Arguments &&... p_arguments)
+    {
+        if (m_restants == 0) allouerBloc(m_tailleBloc);
+        T *element = new(m_courant) T(std::forward<Arguments>(p_arguments)...);
+        ++m_courant;
+        --m_restants;
+        ++m_nombre;
+        return element;
+    }
+
+    //! \brief garantit que les p_nombre prochains creer() se feront dans un même bloc, sans autre allocation
+    void reserver(std::size_t p_nombre)
+    {
+        if (p_nombre > m_restants) allouerBloc(p_nombre > m_tailleBloc ? p_nombre : m_tailleBloc);
+    }
+
+    //! \brief appelle p_rappel(const T &) pour chaque T créé, dans l'ordre de création
+    template<typename Rappel>
+    void parcourir(Rappel p_rappel) const
+    {
+        for (std::size_t b = 0; b < m_blocs.size(); ++b)
+        {
+            const T *fin = b + 1 == m_blocs.size() ? m_courant : m_blocs[b].fin;
+            for (const T *element = m_blocs[b].debut; element != fin; ++element) p_rappel(*element);
+        }
+    }
+
+    //! \brief libère tous les blocs d'un coup; toutes les poignées deviennent invalides
+    void vider()
+    {
+        for (const Bloc &bloc : m_blocs) ::operator delete(bloc.debut);
+        m_blocs.clear();
+        m_courant = nullptr;
+        m_restants = 0;
+        m_nombre = 0;
+    }
+
+    //! \brief échange le contenu de deux arènes; les poignées restent valides et suivent leurs T
+    void echanger(Arene &p_autre)
+    {
+        std::swap(m_tailleBloc, p_autre.m_tailleBloc);
+        m_blocs.swap(p_autre.m_blocs);
+        std::swap(m_courant, p_autre.m_courant);
+        std::swap(m_restants, p_autre.m_restants);
+        std::swap(m_nombre, p_autre.m_nombre);
+    }
+
+    //! \brief le nombre de T créés depuis le dernier vider()
+    std::size_t taille() const
+    {
+        return m_nombre;
+    }
+
+    //! \brief le nombre de blocs alloués
+    std::size_t nbBlocs() const
+    {
+        return m_blocs.size();
+    }
+
+private:
+    struct Bloc
+    {
+        T *debut;
+        T *fin; //fin de la partie utilisée, sauf pour le dernier bloc (voir m_courant)
+    };
+
+    void allouerBloc(std::size_t p_nombre)
+    {
+        m_blocs.reserve(m_blocs.size() + 1);
+        if (!m_blocs.empty()) m_blocs.back().fin = m_courant;
+        m_courant = static_cast<T *>(::operator new(p_nombre * sizeof(T)));
+        Bloc bloc = {m_courant, m_courant};
+        m_blocs.push_back(bloc);
+        m_restants = p_nombre;
+    }
+
+    std::size_t m_tailleBloc; //nombre de T d'un bloc alloué sans reserver()
+    std::vector<Bloc> m_blocs;
+    T *m_courant;             //prochaine case libre du dernier bloc
+    std::size_t m_restants;   //cases libres du dernier bloc
+    std::size_t m_nombre;
+};
+
+#endif //RTC_ARENE_H
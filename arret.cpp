@@ -5,13 +5,18 @@
 
 #include "arret.h"
 
+#include <type_traits>
+
+static_assert(sizeof(Arret) < 24, "Arret doit rester compact");
+static_assert(std::is_trivially_destructible<Arret>::value, "Arret est créé dans une Arene");
+
 /*!
  *  \brief Constructeur de la classe Arret
- *  \param[in] p_station_id : identificateur de station
+ *  \param[in] p_station : identifiant dense de la station (voir TableIdentifiants)
  *  \param[in] p_heure_depart: heure de départ
  *  \param[in] p_heure_arrivee: heure d'arrivée
  *  \param[in] p_numero_sequence: numéro de séquence de l'arrêt dans le voyage
- *  \param[in] p_voyage_id: identificateur du voyage
+ *  \param[in] p_voyage: identifiant dense du voyage
  *   	Pour votre information le fichier stop_times.txt comprend des données relatives aux arrêts effectués par les autobus ;
  *		il est composé des champs :
  *		- trip_id : identifiant du voyage ;
@@ -28,10 +33,10 @@
  *		Mais nous n'aurions besoin que de arrival_time (m_heure_arrivee), departure_time(m_heure_depart), stop_id (m_station_id),
  * 		et stop_sequence(m_numero_sequence)
  */
-Arret::Arret(std::string p_station_id, const Heure &p_heure_arrivee, const Heure &p_heure_depart,
-             unsigned int p_numero_sequence, const std::string &p_voyage_id)
-        : m_station_id(p_station_id), m_heure_arrivee(p_heure_arrivee), m_heure_depart(p_heure_depart),
-          m_numero_sequence(p_numero_sequence), m_voyage_id(p_voyage_id)
+Arret::Arret(std::uint32_t p_station, const Heure &p_heure_arrivee, const Heure &p_heure_depart,
+             unsigned int p_numero_sequence, std::uint32_t p_voyage)
+        : m_station(p_station), m_heure_arrivee(p_heure_arrivee.getCode()), m_heure_depart(p_heure_depart.getCode()),
+          m_numero_sequence(p_numero_sequence), m_voyage(p_voyage)
 {
 }
 
@@ -40,16 +45,28 @@ Arret::Arret(std::string p_station_id, const Heure &p_heure_arrivee, const Heure
  * \brief Accesseur de l'attribut m_heure_arrivee
  * \return La valeur courante de l'attribut m_heure_arrivee
  */
-const Heure &Arret::getHeureArrivee() const
+Heure Arret::getHeureArrivee() const
 {
-    return m_heure_arrivee;
+    return Heure::depuisCode(m_heure_arrivee);
 }
 
 /*!
  * \brief Accesseur de l'attribut m_heure_depart
  * \return La valeur courante de l'attribut m_heure_depart
  */
-const Heure &Arret::getHeureDepart() const
+Heure Arret::getHeureDepart() const
+{
+    return Heure::depuisCode(m_heure_depart);
+}
+
+//! \brief L'heure d'arrivée sans construire d'Heure: le nombre de secondes depuis 00h00m00s
+std::uint32_t Arret::getCodeArrivee() const
+{
+    return m_heure_arrivee;
+}
+
+//! \brief L'heure de départ sans construire d'Heure: le nombre de secondes depuis 00h00m00s
+std::uint32_t Arret::getCodeDepart() const
 {
     return m_heure_depart;
 }
@@ -65,12 +82,12 @@ unsigned int Arret::getNumeroSequence() const
 
 
 /*!
- * \brief Accesseur de l'attribut m_station_id
- * \return La valeur courante de l'attribut m_station_id
+ * \brief Accesseur de l'attribut m_station
+ * \return L'identifiant dense de la station; DonneesGTFS::getIdsStations() donne son stop_id
  */
-std::string Arret::getStationId() const
+std::uint32_t Arret::getStation() const
 {
-    return m_station_id;
+    return m_station;
 }
 
 
@@ -80,7 +97,7 @@ std::string Arret::getStationId() const
  */
 bool Arret::operator<(const Arret &p_other) const
 {
-    return m_heure_depart < p_other.getHeureArrivee();
+    return m_heure_depart < p_other.m_heure_arrivee;
 }
 
 /*!
@@ -89,7 +106,7 @@ bool Arret::operator<(const Arret &p_other) const
  */
 bool Arret::operator>(const Arret &p_other) const
 {
-    return m_heure_arrivee > p_other.getHeureDepart();
+    return m_heure_arrivee > p_other.m_heure_depart;
 }
 
 
@@ -101,12 +118,13 @@ bool Arret::operator>(const Arret &p_other) const
  */
 std::ostream &operator<<(std::ostream &flux, const Arret &p_arret)
 {
-    flux << p_arret.m_heure_arrivee;
+    flux << p_arret.getHeureArrivee();
     return flux;
 }
 
-std::string Arret::getVoyageId() const
+//! \brief L'identifiant dense du voyage; DonneesGTFS::getIdsVoyages() donne son trip_id
+std::uint32_t Arret::getVoyage() const
 {
-    return m_voyage_id;
+    return m_voyage;
 }
 
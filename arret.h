@@ -8,7 +8,7 @@
 #ifndef RTC_ARRET_H
 #define RTC_ARRET_H
 
-#include <memory>
+#include <cstdint>
 #include "auxiliaires.h"
 
 
@@ -20,19 +20,24 @@
 *  (ex: la ligne 800 effectue un arrêt à la station du desjardin à 11h32).
 *  Il est important de ne confondre la station et l'arret.
 *
+*  Un arrêt est un enregistrement compact (20 octets) et trivialement destructible: il est créé dans l'arène de
+*  DonneesGTFS, qui le possède; les stations n'en gardent que des poignées. Les voyages lisent leurs arrêts dans
+*  la TableArrets, en colonnes.
 */
 class Arret {
 
 public:
-	typedef std::shared_ptr<Arret> Ptr;  //permet le raccourcis Arret::Ptr à l'externe
-
-	Arret(std::string p_station_id, const Heure & p_heure_arrivee, const Heure & p_heure_depart,
-          unsigned int p_numero_sequence, const std::string & p_voyage_id);
-	const Heure & getHeureArrivee() const;
-	const Heure & getHeureDepart() const;
+	typedef const Arret *Ptr;  //poignée non propriétaire, valide aussi longtemps que l'arène qui contient l'arrêt
+
+	Arret(std::uint32_t p_station, const Heure & p_heure_arrivee, const Heure & p_heure_depart,
+          unsigned int p_numero_sequence, std::uint32_t p_voyage);
+	Heure getHeureArrivee() const;
+	Heure getHeureDepart() const;
+	std::uint32_t getCodeArrivee() const;
+	std::uint32_t getCodeDepart() const;
 	unsigned int getNumeroSequence() const;
-	std::string getStationId() const;
-	std::string getVoyageId() const;
+	std::uint32_t getStation() const;
+	std::uint32_t getVoyage() const;
 
 	bool operator< (const Arret & p_other) const;
 	bool operator> (const Arret & p_other) const;
@@ -40,11 +45,11 @@ public:
 
 
 private:
-	std::string m_station_id;
-	Heure m_heure_arrivee;
-	Heure m_heure_depart;
-	unsigned int m_numero_sequence;
-	std::string m_voyage_id;
+	std::uint32_t m_station; //identifiant dans DonneesGTFS::getIdsStations()
+	std::uint32_t m_heure_arrivee; //code de l'heure, en secondes depuis 00h00m00s
+	std::uint32_t m_heure_depart;
+	std::uint32_t m_numero_sequence;
+	std::uint32_t m_voyage; //identifiant dans DonneesGTFS::getIdsVoyages()
 };
 
 
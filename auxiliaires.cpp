@@ -5,8 +5,18 @@
 
 #include "auxiliaires.h"
 
+#include <type_traits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 using namespace std;;
 
+static_assert(sizeof(Heure) == 4 && std::is_trivially_copyable<Heure>::value, "Heure doit rester un simple code");
+static_assert(sizeof(Date) == 4 && std::is_trivially_copyable<Date>::value, "Date doit rester un simple code");
+static_assert(Date(1970, 1, 1).getCode() == 0 && Date(2016, 1, 31).getCode() == 16831, "Date::calculerCode()");
+static_assert(Heure(25, 1, 2).add_secondes(58).getCode() == 90120, "Heure::add_secondes()");
+
 /*!
  * \brief Constructeur par défaut de la classe.
  * Permet d'initialiser un objet Date qui est la date actuelle
@@ -15,78 +25,51 @@ using namespace std;;
 Date::Date()
 {
     time_t lt = time(nullptr);   //epoch seconds
-    struct tm *p = localtime(&lt);
-    m_an = (unsigned int) (p->tm_year + 1900);
-    m_mois = (unsigned int) (p->tm_mon + 1);
-    m_jour = (unsigned int) (p->tm_mday);
-    encode(m_an, m_mois, m_jour);
+    struct tm local;
+    struct tm *p = localtime_r(&lt, &local); //localtime() partage son résultat entre les fils
+    m_code = calculerCode((unsigned int) (p->tm_year + 1900), (unsigned int) (p->tm_mon + 1),
+                          (unsigned int) (p->tm_mday));
 }
 
 /*!
- * \brief Constructeur avec paramètres de la classe.
- * Permet d'initialiser une date avec les paramètres en argument
- * \param[in] p_an: l'année dela date
- * \param[in] p_mois: le mois de la date
- * \param[in] p_jour: le jour de la date
- *
+ * \brief retrouve l'année, le mois et le jour à partir du code
+ * \param[out] an: l'année de la date
+ * \param[out] mois: le mois de la date, de 1 à 12
+ * \param[out] jour: le jour de la date, de 1 à 31
  */
-Date::Date(unsigned int p_an, unsigned int p_mois, unsigned int p_jour)
+void Date::decomposer(unsigned int &an, unsigned int &mois, unsigned int &jour) const
 {
-    m_an = p_an;
-    m_mois = p_mois;
-    m_jour = p_jour;
-    encode(p_an, p_mois, p_jour);
+    // Cycles de 400 ans (146097 jours) à partir du 0000-03-01; l'année commence en mars, comme dans calculerCode()
+    int z = m_code + 719468;
+    int ere = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned int jourDeEre = static_cast<unsigned int>(z - ere * 146097);
+    unsigned int anDeEre = (jourDeEre - jourDeEre / 1460 + jourDeEre / 36524 - jourDeEre / 146096) / 365;
+    unsigned int jourDeAn = jourDeEre - (365 * anDeEre + anDeEre / 4 - anDeEre / 100);
+    unsigned int moisDepuisMars = (5 * jourDeAn + 2) / 153;
+    jour = jourDeAn - (153 * moisDepuisMars + 2) / 5 + 1;
+    mois = moisDepuisMars < 10 ? moisDepuisMars + 3 : moisDepuisMars - 9;
+    an = static_cast<unsigned int>(static_cast<int>(anDeEre) + ere * 400) + (mois <= 2 ? 1 : 0);
 }
 
-/*!
- * \brief Égalité entre deux dates
- * Deux dates sont égales s'ils ont la même année, le même mois, le même jour
- * \param[in] other: l'autre date avec qui l'on se compare
- * \return True si les deux dates sont égales.
- *
- */
-bool Date::operator==(const Date &other) const
-{
-    return m_code == other.m_code;
-}
-
-/*!
- * \brief Inégalité inférieure entre deux dates
- * \param[in] other: l'autre date avec qui l'on se compare
- * \return True si l'objet courant est inférieure à l'objet passé en paramètre, False autrement
- */
-bool Date::operator<(const Date &other) const
+unsigned int Date::getAn() const
 {
-    return m_code < other.m_code;
+    unsigned int an, mois, jour;
+    decomposer(an, mois, jour);
+    return an;
 }
 
-/*!
- * \brief Inégalité supérieure entre deux dates
- * \param[in] other: l'autre date avec qui l'on se compare
- * \return False si l'objet courant est inférieure à l'objet passé en paramètre, True autrement
- */
-bool Date::operator>(const Date &other) const
+unsigned int Date::getMois() const
 {
-    return m_code > other.m_code;
+    unsigned int an, mois, jour;
+    decomposer(an, mois, jour);
+    return mois;
 }
 
-/*!
- * \brief Permet de déterminer le code d'une date, i.e le nombre de jours depuis 1970-01-01
- * \param[in] an: l'année dela date
- * \param[in] mois: le mois de la date
- * \param[in] jour: le jour de la date
- *
- */
-void Date::encode(unsigned int an, unsigned int mois, unsigned int jour)
+unsigned int Date::getJour() const
 {
-    mois -= 2;
-    if (mois <= 0)
-    {
-        mois += 12;
-        an -= 1;
-    }
-    m_code = an / 4 - an / 100 + an / 400 + 367 * mois / 12 + jour;
-    m_code = m_code + 365 * an - 719499;
+    unsigned int an, mois, jour;
+    decomposer(an, mois, jour);
+    return jour;
 }
 
 /*!
@@ -97,22 +80,24 @@ void Date::encode(unsigned int an, unsigned int mois, unsigned int jour)
  */
 std::ostream &operator<<(std::ostream &flux, const Date &p_date)
 {
-    flux << p_date.m_an << "-";
+    unsigned int an, mois, jour;
+    p_date.decomposer(an, mois, jour);
+    flux << an << "-";
 
-    if (p_date.m_mois < 10)
+    if (mois < 10)
     {
-        flux << "0" << p_date.m_mois << "-";
+        flux << "0" << mois << "-";
     } else
     {
-        flux << p_date.m_mois << "-";
+        flux << mois << "-";
     }
 
-    if (p_date.m_jour < 10)
+    if (jour < 10)
     {
-        flux << "0" << p_date.m_jour;
+        flux << "0" << jour;
     } else
     {
-        flux << p_date.m_jour;
+        flux << jour;
     }
 
     return flux;
@@ -125,145 +110,123 @@ std::ostream &operator<<(std::ostream &flux, const Date &p_date)
 Heure::Heure()
 {
     time_t lt = time(nullptr);   //epoch seconds
-    struct tm *p = localtime(&lt);
-    m_heure = (unsigned int) (p->tm_hour);
-    m_min = (unsigned int) (p->tm_min);
-    m_sec = (unsigned int) (p->tm_sec);
-    encode(m_heure, m_min, m_sec);
+    struct tm local;
+    struct tm *p = localtime_r(&lt, &local);
+    m_code = (((60 * (unsigned int) p->tm_hour) + (unsigned int) p->tm_min) * 60) + (unsigned int) p->tm_sec;
 }
 
 /*!
- * \brief Constructeur avec paramètre de la classe Heure. Instancie une Heure avec les paramètres.
- * \param[in] p_heure: le nombre d'heure de l'heure à instancier
- * \param[in] p_min: le nombre de minutes dans l'heure
- * \param[in] p_sec: le nombre de secondes dans la minute
- */
-Heure::Heure(unsigned int p_heure, unsigned int p_min, unsigned int p_sec)
-{
-    m_heure = p_heure;
-    m_min = p_min;
-    m_sec = p_sec;
-    encode(m_heure, m_min, m_sec);
-}
-
-/*!
- * \brief Égalité entre deux heures
- * Deux heures sont égales s'ils ont la même heure, la même minute et la même seconde
- * \param[in] other: l'autre heure avec qui l'on se compare
- * \return True ssi les deux Heures sont égales.
- *
- */
-bool Heure::operator==(const Heure &other) const
-{
-    return m_code == other.m_code;
-}
-
-/*!
- * \brief Inégalité inférieure stricte entre deux heures
- * \param[in] other: l'autre heure avec qui l'on se compare
- * \return True ssi les l'Heure de l'objet courant est inférieur à celle de l'objet en paramètre.
- */
-bool Heure::operator<(const Heure &other) const
-{
-    return m_code < other.m_code;
-}
-
-/*!
- * \brief Inégalité supérieure stricte entre deux heures
- * \param[in] other: l'autre heure avec qui l'on se compare
- * \return True ssi les l'Heure de l'objet courant est supérieur à celle de l'objet en paramètre.
- */
-bool Heure::operator>(const Heure &other) const
-{
-    return m_code > other.m_code;
-}
-
-/*!
- * \brief Inégalité inférieure entre deux heures
- * \param[in] other: l'autre heure avec qui l'on se compare
- * \return True ssi les l'Heure de l'objet courant est inférieur ou égale à celle de l'objet en paramètre.
+ * \brief Permet l'affichage d'une heure au format HH:MM:SS
+ * \param[in,out] flux: le flux de sortie utilisé pour l'affichage
+ * \param[in] p_heure: l'heure à afficher
+ * \return le flux de sortie mis à jour
  */
-bool Heure::operator<=(const Heure &other) const
+std::ostream &operator<<(std::ostream &flux, const Heure &p_heure)
 {
-    return m_code <= other.m_code;
-}
+    unsigned int heure = p_heure.getHeure(), min = p_heure.getMinutes(), sec = p_heure.getSecondes();
+    if (heure < 10)
+    {
+        flux << "0" << heure << ":";
+    } else
+    {
+        flux << heure << ":";
+    }
 
-/*!
- * \brief Inégalité supérieure entre deux heures
- * \param[in] other: l'autre heure avec qui l'on se compare
- * \return True ssi les l'Heure de l'objet courant est supérieur ou égale à celle de l'objet en paramètre.
- */
-bool Heure::operator>=(const Heure &other) const
-{
-    return m_code >= other.m_code;
-}
+    if (min < 10)
+    {
+        flux << "0" << min << ":";
+    } else
+    {
+        flux << min << ":";
+    }
 
-/*!
- * \brief Différence entre deux heures
- * \param[in] other: l'autre heure avec qui l'on fait l'opération
- * \return le nombre de secondes (positif ou négatif) qui sépare les deux heures.
- */
-int Heure::operator-(const Heure &other) const
-{
-    return m_code - other.m_code;
+    if (sec < 10)
+    {
+        flux << "0" << sec;
+    } else
+    {
+        flux << sec;
+    }
+    return flux;
 }
 
 /*!
- * \brief Ajoute un certain nombre de secondes à l'heure de l'objet courant
- * \param[in] secs: le nombre de secondes à ajouter
- * \return la nouvelle heure obtenue après l'ajout des secondes
+ * \brief compte les codes strictement inférieurs à p_code
+ * \param[in] p_codes: les p_nb codes à comparer, dans n'importe quel ordre
+ * \return le nombre de i tels que p_codes[i] < p_code
  */
-Heure Heure::add_secondes(unsigned int secs) const
+std::size_t compterAvant(const std::uint32_t *p_codes, std::size_t p_nb, std::uint32_t p_code)
 {
-    unsigned int code = m_code + secs; //la nouvelle heure en secondes
-    unsigned int h = code / 3600; //le nombre d'heures de cette nouvelle heure
-    unsigned int reste = code % 3600; //le reste en secondes
-    unsigned int m = reste / 60; //le nombre de minutes de cette nouvelle heure
-    unsigned int s = reste % 60; //le nombre de secondes de cette nouvelle heure
-    return Heure(h, m, s);
+    std::size_t nombre = 0;
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    // SSE2 ne compare que des entiers signés: on décale les deux opérandes de 2^31
+    const __m128i signe = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i borne = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(p_code)), signe);
+    __m128i comptes = _mm_setzero_si128();
+    for (; i + 4 <= p_nb; i += 4)
+    {
+        __m128i codes = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p_codes + i)), signe);
+        comptes = _mm_sub_epi32(comptes, _mm_cmplt_epi32(codes, borne)); //-1 par voie retenue
+    }
+    std::uint32_t voies[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(voies), comptes);
+    nombre = static_cast<std::size_t>(voies[0]) + voies[1] + voies[2] + voies[3];
+#endif
+    for (; i < p_nb; ++i) nombre += p_codes[i] < p_code;
+    return nombre;
 }
 
 /*!
- * \brief Encode et modifie l'attribut hour_code de l'objet. L'encodage revient à déterminier le nombre de secondes depuis 00h00m00s
- * \param[in] p_heure: le nombre d'heure de l'heure à instancier
- * \param[in] p_min: le nombre de minutes dans l'heure
- * \param[in] p_sec: le nombre de secondes dans la minute
+ * \brief ajoute p_secondes à chacun des codes, comme Heure::add_secondes()
+ * \param[in,out] p_codes: les p_nb codes à décaler
  */
-void Heure::encode(unsigned int p_heure, unsigned int p_min, unsigned int p_sec)
+void ajouterSecondes(std::uint32_t *p_codes, std::size_t p_nb, std::uint32_t p_secondes)
 {
-    m_code = (((60 * p_heure) + p_min) * 60) + p_sec;
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i secondes = _mm_set1_epi32(static_cast<int>(p_secondes));
+    for (; i + 4 <= p_nb; i += 4)
+    {
+        __m128i *codes = reinterpret_cast<__m128i *>(p_codes + i);
+        _mm_storeu_si128(codes, _mm_add_epi32(_mm_loadu_si128(codes), secondes));
+    }
+#endif
+    for (; i < p_nb; ++i) p_codes[i] += p_secondes;
 }
 
 /*!
- * \brief Permet l'affichage d'une heure au format HH:MM:SS
- * \param[in,out] flux: le flux de sortie utilisé pour l'affichage
- * \param[in] p_heure: l'heure à afficher
- * \return le flux de sortie mis à jour
+ * \brief retient les arrêts de l'intervalle [now1, now2): départ >= now1 et arrivée < now2, le filtre des chargements
+ * \param[in] p_departs: les p_nb codes des heures de départ
+ * \param[in] p_arrivees: les p_nb codes des heures d'arrivée
+ * \param[out] p_positions: un tableau d'au moins p_nb positions; reçoit les i retenus, en ordre croissant
+ * \return le nombre de positions retenues
  */
-std::ostream &operator<<(std::ostream &flux, const Heure &p_heure)
+std::size_t filtrerFenetre(const std::uint32_t *p_departs, const std::uint32_t *p_arrivees, std::size_t p_nb,
+                           std::uint32_t p_now1, std::uint32_t p_now2, std::uint32_t *p_positions)
 {
-    if (p_heure.m_heure < 10)
+    std::size_t nombre = 0;
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i signe = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i now1 = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(p_now1)), signe);
+    const __m128i now2 = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(p_now2)), signe);
+    for (; i + 4 <= p_nb; i += 4)
     {
-        flux << "0" << p_heure.m_heure << ":";
-    } else
-    {
-        flux << p_heure.m_heure << ":";
-    }
-
-    if (p_heure.m_min < 10)
-    {
-        flux << "0" << p_heure.m_min << ":";
-    } else
-    {
-        flux << p_heure.m_min << ":";
+        __m128i departs = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p_departs + i)), signe);
+        __m128i arrivees = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p_arrivees + i)), signe);
+        // départ >= now1 est la négation de départ < now1
+        __m128i retenus = _mm_andnot_si128(_mm_cmplt_epi32(departs, now1), _mm_cmplt_epi32(arrivees, now2));
+        int masque = _mm_movemask_ps(_mm_castsi128_ps(retenus));
+        for (; masque != 0; masque &= masque - 1)
+        {
+            p_positions[nombre++] = static_cast<std::uint32_t>(i + static_cast<std::size_t>(__builtin_ctz(masque)));
+        }
     }
-
-    if (p_heure.m_sec < 10)
+#endif
+    for (; i < p_nb; ++i)
     {
-        flux << "0" << p_heure.m_sec;
-    } else
-    {
-        flux << p_heure.m_sec;
+        if (p_departs[i] >= p_now1 && p_arrivees[i] < p_now2) p_positions[nombre++] = static_cast<std::uint32_t>(i);
     }
-    return flux;
+    return nombre;
 }
@@ -14,30 +14,49 @@
 #include "time.h"
 #include <unordered_set>
 #include <algorithm>
+#include <cstdint>
+#include <cstddef>
 
 /*!
  * \class Date
  * \brief Cette classe représente une date.
+ *
+ *  Seul le code (nombre de jours depuis 1970-01-01) est conservé: l'objet tient dans 4 octets, se copie comme un
+ *  entier et se construit à la compilation. L'année, le mois et le jour sont recalculés à la demande.
  */
 class Date
 {
 
 public:
     Date();
-    Date(unsigned int an, unsigned int mois, unsigned int jour);
-    bool operator==(const Date &other) const;
-    bool operator<(const Date &other) const;
-    bool operator>(const Date &other) const;
+    constexpr Date(unsigned int an, unsigned int mois, unsigned int jour) : m_code(calculerCode(an, mois, jour)) {}
+    static constexpr Date depuisCode(int p_code) { return Date(ParCode(), p_code); }
+    constexpr bool operator==(const Date &other) const { return m_code == other.m_code; }
+    constexpr bool operator<(const Date &other) const { return m_code < other.m_code; }
+    constexpr bool operator>(const Date &other) const { return m_code > other.m_code; }
+    constexpr int getCode() const { return m_code; }
+    unsigned int getAn() const;
+    unsigned int getMois() const;
+    unsigned int getJour() const;
+    static constexpr int calculerCode(unsigned int an, unsigned int mois, unsigned int jour)
+    {
+        // L'année commence en mars: janvier et février sont les mois 11 et 12 de l'année précédente
+        return mois <= 2 ? codeDepuisMars(static_cast<int>(an) - 1, static_cast<int>(mois) + 10, jour)
+                         : codeDepuisMars(static_cast<int>(an), static_cast<int>(mois) - 2, jour);
+    }
     friend std::ostream &operator<<(std::ostream &flux, const Date &p_date);
 
 
 private:
-    int m_code; // nombre de jours depuis 1970-01-01 pour la date en parametre
-    unsigned int m_an;
-    unsigned int m_mois;
-    unsigned int m_jour;
+    struct ParCode {};
+    constexpr Date(ParCode, int p_code) : m_code(p_code) {}
+    static constexpr int codeDepuisMars(int an, int mois, unsigned int jour)
+    {
+        return an / 4 - an / 100 + an / 400 + 367 * mois / 12 + static_cast<int>(jour) + 365 * an - 719499;
+    }
+    void decomposer(unsigned int &an, unsigned int &mois, unsigned int &jour) const;
 
-    void encode(unsigned int an, unsigned int mois, unsigned int jour);
+    int m_code; // nombre de jours depuis 1970-01-01 pour la date en parametre
 
 };
 
@@ -46,30 +65,45 @@ private:
  * \class Heure
  * \brief Cette classe représente l'heure d'une journée.
  * Cependant pour les besoins du travail pratique nous permettont qu'elle puisse encoder un nombre d'heures supérieurs à 24
+ *
+ *  Seul le code (nombre de secondes depuis 00h00m00s) est conservé, comme pour Date.
  */
 class Heure
 {
 public:
     Heure();
 
-    Heure(unsigned int heure, unsigned int min, unsigned int sec);
-    Heure add_secondes(unsigned int secs) const;
-    bool operator==(const Heure &other) const;
-    bool operator<(const Heure &other) const;
-    bool operator>(const Heure &other) const;
-    bool operator<=(const Heure &other) const;
-    bool operator>=(const Heure &other) const;
-    int operator-(const Heure &other) const;
+    constexpr Heure(unsigned int heure, unsigned int min, unsigned int sec) : m_code((60 * heure + min) * 60 + sec) {}
+    static constexpr Heure depuisCode(unsigned int p_code) { return Heure(ParCode(), p_code); }
+    constexpr Heure add_secondes(unsigned int secs) const { return Heure(ParCode(), m_code + secs); }
+    constexpr bool operator==(const Heure &other) const { return m_code == other.m_code; }
+    constexpr bool operator<(const Heure &other) const { return m_code < other.m_code; }
+    constexpr bool operator>(const Heure &other) const { return m_code > other.m_code; }
+    constexpr bool operator<=(const Heure &other) const { return m_code <= other.m_code; }
+    constexpr bool operator>=(const Heure &other) const { return m_code >= other.m_code; }
+    //! \brief le nombre de secondes (positif ou négatif) qui sépare les deux heures
+    constexpr int operator-(const Heure &other) const
+    {
+        return static_cast<int>(m_code) - static_cast<int>(other.m_code);
+    }
+    constexpr unsigned int getCode() const { return m_code; }
+    constexpr unsigned int getHeure() const { return m_code / 3600; }
+    constexpr unsigned int getMinutes() const { return m_code % 3600 / 60; }
+    constexpr unsigned int getSecondes() const { return m_code % 60; }
     friend std::ostream &operator<<(std::ostream &flux, const Heure &p_heure);
 
 private:
-    unsigned int m_code;
-    unsigned int m_heure;
-    unsigned int m_min;
-    unsigned int m_sec;
+    struct ParCode {};
+    constexpr Heure(ParCode, unsigned int p_code) : m_code(p_code) {}
 
-    void encode(unsigned int heure, unsigned int min, unsigned int sec);
+    unsigned int m_code;
 };
 
+//Opérations sur des tableaux de codes d'heures (Heure::getCode()), comme les colonnes de TableArrets
+std::size_t compterAvant(const std::uint32_t *p_codes, std::size_t p_nb, std::uint32_t p_code);
+void ajouterSecondes(std::uint32_t *p_codes, std::size_t p_nb, std::uint32_t p_secondes);
+std::size_t filtrerFenetre(const std::uint32_t *p_departs, const std::uint32_t *p_arrivees, std::size_t p_nb,
+                           std::uint32_t p_now1, std::uint32_t p_now2, std::uint32_t *p_positions);
+
 
 #endif //RTC_AUXILIAIRES_H
@@ -0,0 +1,1188 @@
+//
+// Mesures de performance du chargement et des requêtes GTFS.
+// Usage: bench [dossier_gtfs] [archive_zip]
+//
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <fstream>
+#include <iterator>
+#include <cstdlib>
+#include <unistd.h>
+
+#include "DonneesGTFS.h"
+#include "horaire.h"
+#include "indexspatial.h"
+#include "raptor.h"
+#include "csa.h"
+#include "matricetemps.h"
+#include "tableaudeparts.h"
+#include "parallele.h"
+
+using namespace std;
+
+namespace
+{
+    const Date DATE_MESURE(2022, 8, 3);
+    const Heure HEURE_MESURE(7, 30, 0);
+
+    const std::size_t NB_CONVERSIONS = 1 << 20;
+    const std::size_t NB_STATIONS_SYNTHETIQUES = 20000;
+    const std::size_t NB_REQUETES_SPATIALES = 10000;
+    const std::size_t NB_ORIGINES = 200;
+    const std::size_t NB_ITINERAIRES = 1000;
+    const std::size_t NB_PROFILS = 100;
+    const std::size_t NB_TABLEAUX = 10000;
+
+    //! \brief durée moyenne par champ (en ns) d'une conversion appliquée à tous les champs; la somme des codes
+    //! est affichée pour que le compilateur ne retire pas le calcul
+    template<typename Conversion>
+    void mesurerConversion(const char *p_nom, const vector<Champ> &p_champs, Conversion p_conversion)
+    {
+        auto debut = chrono::steady_clock::now();
+        long long somme = p_conversion(p_champs);
+        auto fin = chrono::steady_clock::now();
+        cout << "  " << p_nom << ": " << chrono::duration<double, nano>(fin - debut).count() / p_champs.size()
+             << " ns/champ (somme " << somme << ")" << endl;
+    }
+
+    //! \brief conversions d'heures HH:MM:SS et de dates AAAAMMJJ: std::stoi et istringstream (lecture d'origine),
+    //! boucle scalaire par caractère, noyaux d'un mot de 64 bits par champ et par colonne
+    void mesurerConversions()
+    {
+        cout << "=== Conversion des heures et des dates ===" << endl;
+
+        mt19937 generateur(7);
+        string texteHeures, texteDates;
+        for (std::size_t i = 0; i < NB_CONVERSIONS; ++i)
+        {
+            char tampon[16];
+            unsigned int heure = generateur() % 28;
+            unsigned int minute = generateur() % 60;
+            unsigned int seconde = generateur() % 60;
+            int n = (i % 16 == 0 && heure < 10)
+                    ? snprintf(tampon, sizeof(tampon), "%u:%02u:%02u", heure, minute, seconde)
+                    : snprintf(tampon, sizeof(tampon), "%02u:%02u:%02u", heure, minute, seconde);
+            texteHeures.append(tampon, (std::size_t) n);
+            texteHeures.push_back(',');
+            unsigned int annee = 2020 + generateur() % 5;
+            unsigned int mois = 1 + generateur() % 12;
+            unsigned int jour = 1 + generateur() % 28;
+            n = snprintf(tampon, sizeof(tampon), "%04u%02u%02u", annee, mois, jour);
+            texteDates.append(tampon, (std::size_t) n);
+        }
+        vector<Champ> heures, dates;
+        for (std::size_t debut = 0, fin; (fin = texteHeures.find(',', debut)) != string::npos; debut = fin + 1)
+        {
+            heures.push_back(Champ(texteHeures.data() + debut, fin - debut));
+        }
+        for (std::size_t i = 0; i < NB_CONVERSIONS; ++i)
+        {
+            dates.push_back(Champ(texteDates.data() + 8 * i, 8));
+        }
+
+        cout << "Heures:" << endl;
+        mesurerConversion("std::stoi par composante", heures, [](const vector<Champ> &p_champs) {
+            long long somme = 0;
+            for (const Champ &champ : p_champs)
+            {
+                string texte = champ.str();
+                std::size_t deuxPoints = texte.find(':');
+                somme += Heure(stoi(texte.substr(0, deuxPoints)), stoi(texte.substr(deuxPoints + 1, 2)),
+                               stoi(texte.substr(deuxPoints + 4, 2))).getCode();
+            }
+            return somme;
+        });
+        mesurerConversion("boucle scalaire", heures, [](const vector<Champ> &p_champs) {
+            long long somme = 0;
+            for (const Champ &champ : p_champs)
+            {
+                unsigned int composantes[3] = {0, 0, 0};
+                unsigned int k = 0;
+                for (char c : champ)
+                {
+                    if (c == ':') ++k;
+                    else composantes[k] = composantes[k] * 10 + (unsigned int) (c - '0');
+                }
+                somme += Heure(composantes[0], composantes[1], composantes[2]).getCode();
+            }
+            return somme;
+        });
+        mesurerConversion("champVersHeure", heures, [](const vector<Champ> &p_champs) {
+            long long somme = 0;
+            for (const Champ &champ : p_champs) somme += champVersHeure(champ).getCode();
+            return somme;
+        });
+        mesurerConversion("champsVersCodesHeure", heures, [](const vector<Champ> &p_champs) {
+            vector<unsigned int> codes(p_champs.size());
+            champsVersCodesHeure(p_champs.data(), p_champs.size(), codes.data());
+            long long somme = 0;
+            for (unsigned int code : codes) somme += code;
+            return somme;
+        });
+
+        cout << "Dates:" << endl;
+        mesurerConversion("istringstream", dates, [](const vector<Champ> &p_champs) {
+            long long somme = 0;
+            for (const Champ &champ : p_champs)
+            {
+                string texte = champ.str();
+                unsigned int an, mois, jour;
+                istringstream(texte.substr(0, 4)) >> an;
+                istringstream(texte.substr(4, 2)) >> mois;
+                istringstream(texte.substr(6, 2)) >> jour;
+                somme += Date(an, mois, jour).getCode();
+            }
+            return somme;
+        });
+        mesurerConversion("champVersEntier puis divisions", dates, [](const vector<Champ> &p_champs) {
+            long long somme = 0;
+            for (const Champ &champ : p_champs)
+            {
+                unsigned int n = champVersEntier(champ);
+                somme += Date(n / 10000, (n / 100) % 100, n % 100).getCode();
+            }
+            return somme;
+        });
+        mesurerConversion("champVersDate", dates, [](const vector<Champ> &p_champs) {
+            long long somme = 0;
+            for (const Champ &champ : p_champs) somme += champVersDate(champ).getCode();
+            return somme;
+        });
+        mesurerConversion("champsVersCodesDate", dates, [](const vector<Champ> &p_champs) {
+            vector<int> codes(p_champs.size());
+            champsVersCodesDate(p_champs.data(), p_champs.size(), codes.data());
+            long long somme = 0;
+            for (int code : codes) somme += code;
+            return somme;
+        });
+        cout << endl;
+    }
+
+    //! \brief ajoute tout ce qui précède les arrêts dans p_donnees
+    void chargerAvantArrets(DonneesGTFS &p_donnees, const string &p_dossier)
+    {
+        p_donnees.ajouterLignes(p_dossier + "/routes.txt");
+        p_donnees.ajouterStations(p_dossier + "/stops.txt");
+        p_donnees.ajouterServices(p_dossier + "/calendar_dates.txt");
+        p_donnees.ajouterVoyagesDeLaDate(p_dossier + "/trips.txt");
+    }
+
+    //! \brief coût par ligne de stop_times.txt rejetée par le filtre (intervalle vide), puis avec un intervalle d'une heure
+    void mesurerRejetArrets(const string &p_dossier)
+    {
+        cout << "=== stop_times.txt: rejet des lignes ===" << endl;
+
+        DonneesGTFS vide(DATE_MESURE, HEURE_MESURE, HEURE_MESURE);
+        chargerAvantArrets(vide, p_dossier);
+        vide.ajouterArretsDesVoyagesDeLaDate(p_dossier + "/stop_times.txt");
+        const StatistiquesArrets &s = vide.getStatistiquesArrets();
+        cout << "Intervalle vide: " << s.nbLignesLues << " lignes rejetées en " << 1e3 * s.dureeLecture << " ms" << endl;
+        cout << "Coût par ligne rejetée = " << 1e9 * s.dureeLecture / max<size_t>(s.nbLignesLues, 1) << " ns" << endl;
+
+        DonneesGTFS uneHeure(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3600));
+        chargerAvantArrets(uneHeure, p_dossier);
+        uneHeure.ajouterArretsDesVoyagesDeLaDate(p_dossier + "/stop_times.txt");
+        const StatistiquesArrets &t = uneHeure.getStatistiquesArrets();
+        cout << "Intervalle d'une heure: " << t.nbLignesLues << " lignes lues, " << t.nbRejeteesIntervalle
+             << " hors intervalle, " << t.nbRejeteesVoyage << " hors voyages, en " << 1e3 * t.dureeLecture << " ms"
+             << endl;
+        cout << "Coût moyen par ligne = " << 1e9 * t.dureeLecture / max<size_t>(t.nbLignesLues, 1) << " ns" << endl
+             << endl;
+    }
+
+    //! \brief chargement unique de l'horaire, puis coût d'une vue par intervalle comparé à une relecture des fichiers
+    void mesurerHoraire(const string &p_dossier)
+    {
+        cout << "=== Horaire chargé une fois ===" << endl;
+
+        auto debut = chrono::steady_clock::now();
+        HoraireGTFS horaire;
+        horaire.charger(p_dossier);
+        auto fin = chrono::steady_clock::now();
+        cout << "Chargement de l'horaire: " << horaire.getArrets().size() << " arrêts en "
+             << chrono::duration<double, milli>(fin - debut).count() << " ms" << endl;
+
+        for (unsigned int duree : {600u, 3600u, 4u * 3600u})
+        {
+            Heure now2 = HEURE_MESURE.add_secondes(duree);
+
+            debut = chrono::steady_clock::now();
+            DonneesGTFS fichiers(DATE_MESURE, HEURE_MESURE, now2);
+            chargerAvantArrets(fichiers, p_dossier);
+            fichiers.ajouterArretsDesVoyagesDeLaDate(p_dossier + "/stop_times.txt");
+            fichiers.ajouterTransferts(p_dossier + "/transfers.txt");
+            fin = chrono::steady_clock::now();
+            double dureeFichiers = chrono::duration<double, milli>(fin - debut).count();
+
+            debut = chrono::steady_clock::now();
+            DonneesGTFS vue(DATE_MESURE, HEURE_MESURE, now2);
+            vue.chargerDepuisHoraire(horaire);
+            fin = chrono::steady_clock::now();
+
+            cout << "Intervalle de " << duree / 60 << " min: " << vue.getNbArrets() << " arrêts, fichiers "
+                 << dureeFichiers << " ms, vue " << chrono::duration<double, milli>(fin - debut).count() << " ms"
+                 << endl;
+        }
+        cout << endl;
+    }
+
+    //! \brief durée de chaque phase de charger(), comparée au chargement séquentiel par les méthodes ajouter*
+    void mesurerChargement(const string &p_dossier)
+    {
+        cout << "=== Chargement par phases ===" << endl;
+
+        auto debut = chrono::steady_clock::now();
+        DonneesGTFS sequentiel(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3600));
+        chargerAvantArrets(sequentiel, p_dossier);
+        sequentiel.ajouterArretsDesVoyagesDeLaDate(p_dossier + "/stop_times.txt");
+        sequentiel.ajouterTransferts(p_dossier + "/transfers.txt");
+        auto fin = chrono::steady_clock::now();
+        cout << "Séquentiel: " << chrono::duration<double, milli>(fin - debut).count() << " ms" << endl;
+
+        debut = chrono::steady_clock::now();
+        DonneesGTFS parPhases(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3600));
+        parPhases.charger(p_dossier);
+        fin = chrono::steady_clock::now();
+        cout << "charger(): " << chrono::duration<double, milli>(fin - debut).count() << " ms" << endl;
+        for (const auto &phase : parPhases.getDureesChargement())
+        {
+            cout << "  " << phase.nom << ": début " << 1e3 * phase.debut << " ms, durée " << 1e3 * phase.duree
+                 << " ms" << endl;
+        }
+        cout << endl;
+    }
+
+    //! \brief charger() depuis l'archive zip du GTFS, comparé au même chargement depuis le dossier extrait
+    void mesurerArchive(const string &p_dossier, const string &p_archive)
+    {
+        cout << "=== Chargement depuis l'archive zip ===" << endl;
+
+        auto debut = chrono::steady_clock::now();
+        DonneesGTFS dossier(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3600));
+        dossier.charger(p_dossier);
+        auto fin = chrono::steady_clock::now();
+        double dureeDossier = chrono::duration<double, milli>(fin - debut).count();
+        cout << "Dossier extrait: " << dureeDossier << " ms" << endl;
+
+        debut = chrono::steady_clock::now();
+        DonneesGTFS archive(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3600));
+        archive.charger(p_archive);
+        fin = chrono::steady_clock::now();
+        double dureeArchive = chrono::duration<double, milli>(fin - debut).count();
+        cout << "Archive: " << dureeArchive << " ms (" << dureeArchive - dureeDossier << " ms de plus que le dossier), "
+             << archive.getNbArrets() << " arrêts (" << dossier.getNbArrets() << " depuis le dossier)" << endl;
+        for (const auto &phase : archive.getDureesChargement())
+        {
+            cout << "  " << phase.nom << ": début " << 1e3 * phase.debut << " ms, durée " << 1e3 * phase.duree
+                 << " ms" << endl;
+        }
+        cout << endl;
+    }
+
+    //! \brief opérations sur les colonnes d'heures de la table des arrêts d'une journée complète: boucles sur des
+    //! Heure, puis opérations par lots sur les codes
+    void mesurerOperationsHeures(const string &p_dossier)
+    {
+        cout << "=== Opérations sur les heures ===" << endl;
+
+        DonneesGTFS journee(DATE_MESURE, Heure(0, 0, 0), Heure(30, 0, 0));
+        journee.charger(p_dossier);
+        const TableArrets &table = journee.getTableArrets();
+        vector<std::uint32_t> departs(table.getDeparts()), arrivees(table.getArrivees());
+        vector<std::uint32_t> positions(departs.size());
+        const std::size_t n = departs.size();
+        const Heure now1 = HEURE_MESURE, now2 = HEURE_MESURE.add_secondes(3600);
+        cout << n << " arrêts" << endl;
+
+        auto mesurer = [n](const char *p_nom, const std::function<std::size_t()> &p_operation) {
+            auto debut = chrono::steady_clock::now();
+            std::size_t resultat = p_operation();
+            auto fin = chrono::steady_clock::now();
+            cout << "  " << p_nom << ": " << chrono::duration<double, nano>(fin - debut).count() / n
+                 << " ns/arrêt (" << resultat << ")" << endl;
+        };
+        mesurer("Heure < (boucle)", [&]() {
+            std::size_t nombre = 0;
+            for (std::uint32_t code : departs) nombre += Heure::depuisCode(code) < now1;
+            return nombre;
+        });
+        mesurer("compterAvant", [&]() { return compterAvant(departs.data(), n, now1.getCode()); });
+        mesurer("Heure::add_secondes (boucle)", [&]() {
+            for (std::uint32_t &code : departs) code = Heure::depuisCode(code).add_secondes(60).getCode();
+            return (std::size_t) departs[0];
+        });
+        mesurer("ajouterSecondes", [&]() {
+            ajouterSecondes(departs.data(), n, 60);
+            return (std::size_t) departs[0];
+        });
+        departs = table.getDeparts();
+        mesurer("fenêtre [now1, now2) (boucle)", [&]() {
+            std::size_t nombre = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (Heure::depuisCode(departs[i]) >= now1 && Heure::depuisCode(arrivees[i]) < now2)
+                    positions[nombre++] = (std::uint32_t) i;
+            }
+            return nombre;
+        });
+        mesurer("filtrerFenetre", [&]() {
+            return filtrerFenetre(departs.data(), arrivees.data(), n, now1.getCode(), now2.getCode(),
+                                  positions.data());
+        });
+        cout << endl;
+    }
+
+    //! \brief un point au hasard dans la région de Québec
+    Coordonnees pointAuHasard(mt19937 &p_generateur)
+    {
+        uniform_real_distribution<double> latitude(46.70, 46.95), longitude(-71.45, -71.10);
+        double lat = latitude(p_generateur);
+        return Coordonnees(lat, longitude(p_generateur));
+    }
+
+    //! \brief recherches par rayon et des k plus proches stations: parcours de toutes les stations avec
+    //! Coordonnees::operator-, puis IndexSpatial, une requête à la fois et par lots
+    void mesurerRecherchesSpatiales(const char *p_nom, const Registre<Station> &p_stations,
+                                    const vector<Coordonnees> &p_centres)
+    {
+        const double rayon = 0.5;
+        const std::size_t k = 10;
+        cout << p_nom << ": " << p_stations.size() << " stations, " << p_centres.size() << " requêtes" << endl;
+
+        auto debut = chrono::steady_clock::now();
+        IndexSpatial index;
+        index.construire(p_stations);
+        auto fin = chrono::steady_clock::now();
+        cout << "  construction: " << chrono::duration<double, milli>(fin - debut).count() << " ms" << endl;
+
+        auto mesurer = [&p_centres](const char *p_operation, const std::function<std::size_t()> &p_requetes) {
+            auto debut = chrono::steady_clock::now();
+            std::size_t nombre = p_requetes();
+            auto fin = chrono::steady_clock::now();
+            cout << "  " << p_operation << ": "
+                 << chrono::duration<double, nano>(fin - debut).count() / p_centres.size() << " ns/requête (" << nombre
+                 << " stations)" << endl;
+        };
+
+        vector<vector<std::uint32_t> > attendus(p_centres.size());
+        mesurer("rayon, parcours complet", [&]() {
+            std::size_t nombre = 0;
+            for (std::size_t i = 0; i < p_centres.size(); ++i)
+            {
+                for (auto stationM : p_stations)
+                {
+                    if (stationM.second.getCoords() - p_centres[i] <= rayon) attendus[i].push_back(stationM.first);
+                }
+                nombre += attendus[i].size();
+            }
+            return nombre;
+        });
+        vector<Voisin> voisins;
+        std::size_t differences = 0;
+        mesurer("rayon, IndexSpatial", [&]() {
+            std::size_t nombre = 0;
+            for (const Coordonnees &centre : p_centres)
+            {
+                index.dansRayon(centre, rayon, voisins);
+                nombre += voisins.size();
+            }
+            return nombre;
+        });
+        vector<std::uint32_t> debuts;
+        mesurer("rayon, IndexSpatial par lots", [&]() {
+            index.dansRayon(p_centres, rayon, debuts, voisins);
+            return voisins.size();
+        });
+        for (std::size_t i = 0; i < p_centres.size(); ++i)
+        {
+            vector<std::uint32_t> trouves;
+            for (std::uint32_t j = debuts[i]; j < debuts[i + 1]; ++j) trouves.push_back(voisins[j].station);
+            sort(trouves.begin(), trouves.end());
+            differences += trouves != attendus[i];
+        }
+        cout << "  rayon: " << differences << " requête(s) différente(s) du parcours complet" << endl;
+
+        vector<pair<double, std::uint32_t> > distances;
+        mesurer("k plus proches, parcours complet", [&]() {
+            for (std::size_t i = 0; i < p_centres.size(); ++i)
+            {
+                distances.clear();
+                for (auto stationM : p_stations)
+                {
+                    distances.push_back(make_pair(stationM.second.getCoords() - p_centres[i], stationM.first));
+                }
+                std::size_t n = min(k, distances.size());
+                partial_sort(distances.begin(), distances.begin() + n, distances.end());
+                attendus[i].clear();
+                for (std::size_t j = 0; j < n; ++j) attendus[i].push_back(distances[j].second);
+            }
+            return p_centres.size() * min(k, p_stations.size());
+        });
+        mesurer("k plus proches, IndexSpatial", [&]() {
+            std::size_t nombre = 0;
+            for (const Coordonnees &centre : p_centres)
+            {
+                index.plusProches(centre, k, voisins);
+                nombre += voisins.size();
+            }
+            return nombre;
+        });
+        mesurer("k plus proches, IndexSpatial par lots", [&]() {
+            index.plusProches(p_centres, k, debuts, voisins);
+            return voisins.size();
+        });
+        differences = 0;
+        for (std::size_t i = 0; i < p_centres.size(); ++i)
+        {
+            for (std::uint32_t j = debuts[i]; j < debuts[i + 1]; ++j)
+            {
+                if (voisins[j].station != attendus[i][j - debuts[i]])
+                {
+                    ++differences;
+                    break;
+                }
+            }
+        }
+        cout << "  k plus proches: " << differences << " requête(s) différente(s) du parcours complet" << endl;
+    }
+
+    //! \brief index spatial sur les stations du dossier, puis sur des stations synthétiques plus nombreuses
+    void mesurerIndexSpatial(const string &p_dossier)
+    {
+        cout << "=== Index spatial des stations ===" << endl;
+
+        mt19937 generateur(11);
+        vector<Coordonnees> centres;
+        for (std::size_t i = 0; i < NB_REQUETES_SPATIALES; ++i) centres.push_back(pointAuHasard(generateur));
+
+        DonneesGTFS donnees(DATE_MESURE, HEURE_MESURE, HEURE_MESURE);
+        donnees.ajouterStations(p_dossier + "/stops.txt");
+        mesurerRecherchesSpatiales("Dossier", donnees.getStations(), centres);
+
+        Registre<Station> synthetiques;
+        for (std::uint32_t s = 0; s < NB_STATIONS_SYNTHETIQUES; ++s)
+        {
+            synthetiques.inserer(s, Station(to_string(s), "", "", pointAuHasard(generateur)));
+        }
+        mesurerRecherchesSpatiales("Synthétiques", synthetiques, centres);
+        cout << endl;
+    }
+
+    //! \brief distances d'un point à chacune de NB_STATIONS_SYNTHETIQUES stations: Coordonnees::operator- paire par
+    //! paire, puis ColonnesCoordonnees::distancesDepuis(); les écarts sont mesurés par rapport à haversine en std::
+    void mesurerDistancesParLots()
+    {
+        cout << "=== Distances d'un point à toutes les stations ===" << endl;
+
+        mt19937 generateur(13);
+        vector<Coordonnees> stations, origines;
+        ColonnesCoordonnees colonnes;
+        for (std::size_t i = 0; i < NB_STATIONS_SYNTHETIQUES; ++i)
+        {
+            stations.push_back(pointAuHasard(generateur));
+            colonnes.ajouter(stations.back());
+        }
+        for (std::size_t i = 0; i < NB_ORIGINES; ++i) origines.push_back(pointAuHasard(generateur));
+        const double nbPaires = (double) stations.size() * origines.size();
+        cout << stations.size() << " stations, " << origines.size() << " origines" << endl;
+
+        vector<double> distances(stations.size());
+        double ecartMax = 0;
+        auto ecarter = [&](const Coordonnees &p_origine, bool p_relatif) {
+            const double radParDegre = 3.14159265358979323846 / 180.0;
+            double lat1 = p_origine.getLatitude() * radParDegre, lon1 = p_origine.getLongitude() * radParDegre;
+            for (std::size_t j = 0; j < stations.size(); ++j)
+            {
+                double lat2 = stations[j].getLatitude() * radParDegre, lon2 = stations[j].getLongitude() * radParDegre;
+                double a = pow(sin((lat2 - lat1) / 2), 2) + cos(lat1) * cos(lat2) * pow(sin((lon2 - lon1) / 2), 2);
+                double reference = 2 * 6371 * asin(sqrt(a));
+                double ecart = fabs(distances[j] - reference);
+                if (p_relatif && reference > 0) ecart /= reference;
+                ecartMax = max(ecartMax, ecart);
+            }
+        };
+        auto mesurer = [&](const char *p_nom, const std::function<void(const Coordonnees &)> &p_calcul,
+                           double p_reference, bool p_relatif) {
+            double total = 0;
+            ecartMax = 0;
+            for (const Coordonnees &origine : origines)
+            {
+                auto debut = chrono::steady_clock::now();
+                p_calcul(origine);
+                auto fin = chrono::steady_clock::now();
+                total += chrono::duration<double, nano>(fin - debut).count();
+                ecarter(origine, p_relatif);
+            }
+            cout << "  " << p_nom << ": " << total / nbPaires << " ns/paire";
+            if (p_reference > 0) cout << " (x" << p_reference / total << ")";
+            cout << ", écart max " << ecartMax << (p_relatif ? " relatif" : " km") << endl;
+            return total;
+        };
+
+        double reference = mesurer("Coordonnees::operator-", [&](const Coordonnees &p_origine) {
+            for (std::size_t j = 0; j < stations.size(); ++j) distances[j] = stations[j] - p_origine;
+        }, 0, false);
+        mesurer("haversine par lots", [&](const Coordonnees &p_origine) {
+            colonnes.distancesDepuis(p_origine, distances.data(), MethodeDistance::HAVERSINE);
+        }, reference, false);
+        mesurer("équirectangulaire par lots", [&](const Coordonnees &p_origine) {
+            colonnes.distancesDepuis(p_origine, distances.data(), MethodeDistance::EQUIRECTANGULAIRE);
+        }, reference, true);
+        cout << endl;
+    }
+
+    //! \brief transferts sortants de chaque station: parcours de getTransferts(), puis tranche de getGrapheTransferts()
+    void mesurerTransferts(const string &p_dossier)
+    {
+        cout << "=== Transferts sortants par station ===" << endl;
+
+        DonneesGTFS donnees(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3600));
+        donnees.charger(p_dossier);
+        const auto &transferts = donnees.getTransferts();
+        const GrapheTransferts &graphe = donnees.getGrapheTransferts();
+        cout << donnees.getNbStations() << " stations, " << transferts.size() << " transferts" << endl;
+
+        auto mesurer = [&donnees](const char *p_nom, const std::function<std::size_t(std::uint32_t)> &p_enumerer) {
+            auto debut = chrono::steady_clock::now();
+            std::size_t somme = 0;
+            for (auto stationM : donnees.getStations()) somme += p_enumerer(stationM.first);
+            auto fin = chrono::steady_clock::now();
+            cout << "  " << p_nom << ": "
+                 << chrono::duration<double, nano>(fin - debut).count() / donnees.getNbStations()
+                 << " ns/station (somme des temps " << somme << ")" << endl;
+        };
+        mesurer("parcours de tous les transferts", [&](std::uint32_t p_station) {
+            std::size_t somme = 0;
+            for (const auto &transfert : transferts)
+            {
+                if (get<0>(transfert) == p_station) somme += get<2>(transfert);
+            }
+            return somme;
+        });
+        mesurer("GrapheTransferts", [&](std::uint32_t p_station) {
+            std::size_t somme = 0;
+            for (const Transfert &transfert : graphe.plage(p_station)) somme += transfert.temps;
+            return somme;
+        });
+        cout << endl;
+    }
+
+    //! \brief trajets à pied entre stations rapprochées: toutes les paires avec Coordonnees::operator- sur les
+    //! stations du dossier, puis genererTrajetsAPied() sur celles-ci et sur des stations synthétiques
+    void mesurerTrajetsAPied(const string &p_dossier)
+    {
+        cout << "=== Trajets à pied générés ===" << endl;
+
+        DonneesGTFS donnees(DATE_MESURE, HEURE_MESURE, HEURE_MESURE);
+        donnees.ajouterStations(p_dossier + "/stops.txt");
+        const Registre<Station> &stations = donnees.getStations();
+        auto debut = chrono::steady_clock::now();
+        std::size_t nbPaires = 0;
+        for (auto de : stations)
+        {
+            for (auto vers : stations)
+            {
+                nbPaires += de.first != vers.first && de.second.getCoords() - vers.second.getCoords() <= RAYON_MARCHE;
+            }
+        }
+        auto fin = chrono::steady_clock::now();
+        cout << stations.size() << " stations, toutes les paires: "
+             << chrono::duration<double, milli>(fin - debut).count() << " ms (" << nbPaires << " trajets)" << endl;
+
+        Registre<Station> synthetiques;
+        mt19937 generateur(17);
+        for (std::uint32_t s = 0; s < NB_STATIONS_SYNTHETIQUES; ++s)
+        {
+            synthetiques.inserer(s, Station(to_string(s), "", "", pointAuHasard(generateur)));
+        }
+        const Registre<Station> *ensembles[] = {&stations, &synthetiques};
+        for (const Registre<Station> *ensemble : ensembles)
+        {
+            vector<tuple<std::uint32_t, std::uint32_t, unsigned int> > trajets;
+            debut = chrono::steady_clock::now();
+            genererTrajetsAPied(*ensemble, RAYON_MARCHE, VITESSE_MARCHE, trajets);
+            fin = chrono::steady_clock::now();
+            cout << ensemble->size() << " stations, genererTrajetsAPied: "
+                 << chrono::duration<double, milli>(fin - debut).count() << " ms (" << trajets.size() << " trajets)"
+                 << endl;
+        }
+        cout << endl;
+    }
+
+    //! \brief vrai si un profil sur [..., p_fin) n'a pas à contenir p_itineraire: il ne fait que marcher, ou son
+    //! premier voyage part trop tard pour qu'on quitte l'origine avant p_fin
+    bool horsProfil(const Itineraire &p_itineraire, std::uint32_t p_fin)
+    {
+        std::uint32_t marche = 0;
+        for (const Etape &etape : p_itineraire.etapes)
+        {
+            if (!etape.estAPied()) return etape.depart.getCode() - marche >= p_fin;
+            marche += etape.arrivee.getCode() - etape.depart.getCode();
+        }
+        return true;
+    }
+
+    //! \brief profils sur la première heure, en un seul fil puis en tranches parallèles, et une requête par minute,
+    //! pour les mêmes paires de stations
+    void mesurerProfils(PlanificateurRaptor &p_planificateur, const vector<std::uint32_t> &p_stations,
+                        mt19937 &p_generateur)
+    {
+        vector<pair<std::uint32_t, std::uint32_t> > paires;
+        for (std::size_t i = 0; i < NB_PROFILS; ++i)
+        {
+            std::uint32_t de = p_stations[p_generateur() % p_stations.size()];
+            paires.push_back(make_pair(de, p_stations[p_generateur() % p_stations.size()]));
+        }
+        const Heure finProfils = HEURE_MESURE.add_secondes(3600);
+        vector<vector<Itineraire> > profils(NB_PROFILS);
+        std::size_t nbItineraires = 0;
+        std::size_t nbFils = nbFilsDisponibles();
+        double durees[2] = {0, 0};
+        for (int tranches = 0; tranches < 2; ++tranches)
+        {
+            auto debut = chrono::steady_clock::now();
+            for (std::size_t i = 0; i < NB_PROFILS; ++i)
+            {
+                profils[i] = p_planificateur.profil(paires[i].first, paires[i].second, HEURE_MESURE, finProfils,
+                                                    MAX_TRANSFERTS, tranches == 0 ? 1 : nbFils);
+                if (tranches == 0) nbItineraires += profils[i].size();
+            }
+            auto fin = chrono::steady_clock::now();
+            durees[tranches] = chrono::duration<double, milli>(fin - debut).count();
+        }
+        vector<Itineraire> parMinute;
+        parMinute.reserve(NB_PROFILS * 60);
+        auto debut = chrono::steady_clock::now();
+        for (std::size_t i = 0; i < NB_PROFILS; ++i)
+        {
+            for (unsigned int minute = 0; minute < 60; ++minute)
+            {
+                parMinute.push_back(p_planificateur.trouver(paires[i].first, paires[i].second,
+                                                            HEURE_MESURE.add_secondes(60 * minute)));
+            }
+        }
+        auto fin = chrono::steady_clock::now();
+
+        // Chaque requête par minute doit arriver aussi tôt que le premier itinéraire du profil qui part à cette
+        // minute ou après
+        std::size_t nbAtteints = 0, nbEcarts = 0;
+        for (std::size_t i = 0; i < NB_PROFILS; ++i)
+        {
+            for (unsigned int minute = 0; minute < 60; ++minute)
+            {
+                const Itineraire &itineraire = parMinute[i * 60 + minute];
+                nbAtteints += itineraire.existe;
+                if (itineraire.existe && horsProfil(itineraire, finProfils.getCode())) continue;
+                std::uint32_t heure = HEURE_MESURE.getCode() + 60 * minute;
+                std::uint32_t attendue = itineraire.existe ? itineraire.arrivee.getCode() : 0xffffffff;
+                std::uint32_t obtenue = 0xffffffff;
+                for (const Itineraire &candidat : profils[i])
+                {
+                    if (candidat.depart.getCode() < heure) continue;
+                    obtenue = candidat.arrivee.getCode();
+                    break;
+                }
+                nbEcarts += obtenue != attendue;
+            }
+        }
+        cout << "  profil sur une heure: " << durees[0] / NB_PROFILS << " ms (" << nbFils << " tranches: "
+             << durees[1] / NB_PROFILS << " ms), " << static_cast<double>(nbItineraires) / NB_PROFILS
+             << " itinéraires par profil" << endl;
+        cout << "  une requête par minute: " << chrono::duration<double, milli>(fin - debut).count() / NB_PROFILS
+             << " ms (" << nbAtteints << " requêtes abouties, " << nbEcarts << " écarts avec les profils)" << endl;
+    }
+
+    //! \brief construction d'un PlanificateurRaptor, requêtes entre stations tirées au hasard, à une heure tirée
+    //! dans la première heure de l'intervalle, puis profils de cette heure comparés à une requête par minute, sans
+    //! puis avec les trajets à pied
+    void mesurerRaptor(const string &p_dossier)
+    {
+        cout << "=== Itinéraires RAPTOR ===" << endl;
+
+        DonneesGTFS donnees(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3 * 3600));
+        donnees.charger(p_dossier);
+        PlanificateurRaptor planificateur;
+        auto debut = chrono::steady_clock::now();
+        planificateur.construire(donnees);
+        auto fin = chrono::steady_clock::now();
+        cout << planificateur.nbVoyages() << " voyages en " << planificateur.nbParcours() << " parcours, construits en "
+             << chrono::duration<double, milli>(fin - debut).count() << " ms" << endl;
+
+        vector<std::uint32_t> stations;
+        for (auto stationM : donnees.getStations()) stations.push_back(stationM.first);
+        mt19937 generateur(23);
+        std::size_t nbTrouves = 0, nbTransferts = 0;
+        debut = chrono::steady_clock::now();
+        for (std::size_t i = 0; i < NB_ITINERAIRES; ++i)
+        {
+            std::uint32_t de = stations[generateur() % stations.size()];
+            std::uint32_t vers = stations[generateur() % stations.size()];
+            Itineraire itineraire = planificateur.trouver(de, vers, HEURE_MESURE.add_secondes(generateur() % 3600));
+            nbTrouves += itineraire.existe;
+            nbTransferts += itineraire.nbTransferts();
+        }
+        fin = chrono::steady_clock::now();
+        cout << "  trouver: " << chrono::duration<double, milli>(fin - debut).count() / NB_ITINERAIRES
+             << " ms/requête (" << nbTrouves << " itinéraires sur " << NB_ITINERAIRES << ", " << nbTransferts
+             << " transferts)" << endl;
+
+        mesurerProfils(planificateur, stations, generateur);
+
+        // Les trajets à pied multiplient les départs possibles d'un profil
+        donnees.ajouterTrajetsAPied();
+        planificateur.construire(donnees);
+        cout << "  avec les trajets à pied:" << endl;
+        mesurerProfils(planificateur, stations, generateur);
+        cout << endl;
+    }
+
+    //! \brief le trajet d'un voyage entre deux arrêts consécutifs, rangé avec les autres arcs de sa station de départ
+    struct ArcHoraire
+    {
+        std::uint32_t vers;
+        std::uint32_t depart;
+        std::uint32_t arrivee;
+    };
+
+    /*!
+     * \brief les arcs de chaque station, lus directement dans les voyages de p_donnees, indépendamment de
+     * PlanificateurCSA: les arcs de la station s occupent [p_debuts[s], p_debuts[s + 1]) dans le résultat
+     */
+    vector<ArcHoraire> arcsParStation(const DonneesGTFS &p_donnees, vector<std::uint32_t> &p_debuts)
+    {
+        std::uint32_t nbStations = static_cast<std::uint32_t>(p_donnees.getIdsStations().taille());
+        p_debuts.assign(static_cast<std::size_t>(nbStations) + 1, 0);
+        for (auto voyageM : p_donnees.getVoyages())
+        {
+            const PlageArrets &arrets = voyageM.second.getArrets();
+            for (std::size_t i = 0; i + 1 < arrets.nombre; ++i) ++p_debuts[arrets.stations[i] + 1];
+        }
+        for (std::uint32_t s = 0; s < nbStations; ++s) p_debuts[s + 1] += p_debuts[s];
+        vector<ArcHoraire> arcs(p_debuts.back());
+        vector<std::uint32_t> positions(p_debuts.begin(), p_debuts.end() - 1);
+        for (auto voyageM : p_donnees.getVoyages())
+        {
+            const PlageArrets &arrets = voyageM.second.getArrets();
+            for (std::size_t i = 0; i + 1 < arrets.nombre; ++i)
+            {
+                ArcHoraire arc = {arrets.stations[i + 1], arrets.departs[i], arrets.arrivees[i + 1]};
+                arcs[positions[arrets.stations[i]]++] = arc;
+            }
+        }
+        return arcs;
+    }
+
+    /*!
+     * \brief Dijkstra dépendant du temps, pour comparaison: de chaque station retirée de la file, tous ses arcs qui
+     * partent après son arrivée sont relâchés, puis tous ses transferts, de sorte que les transferts s'enchaînent.
+     * Un changement de voyage ne demande aucun délai: rester à bord revient à descendre puis remonter
+     * \return l'heure d'arrivée à p_vers, 0xffffffff si elle n'est pas atteinte
+     */
+    std::uint32_t dijkstraNaif(const vector<ArcHoraire> &p_arcs, const vector<std::uint32_t> &p_debuts,
+                               const GrapheTransferts &p_transferts, std::uint32_t p_de, std::uint32_t p_vers,
+                               std::uint32_t p_depart, vector<std::uint32_t> &p_arrivees)
+    {
+        const std::uint32_t infini = 0xffffffff;
+        std::fill(p_arrivees.begin(), p_arrivees.end(), infini);
+        typedef pair<std::uint32_t, std::uint32_t> Entree; //(arrivée, station)
+        priority_queue<Entree, vector<Entree>, greater<Entree> > file;
+        p_arrivees[p_de] = p_depart;
+        file.push(Entree(p_depart, p_de));
+        while (!file.empty())
+        {
+            Entree entree = file.top();
+            file.pop();
+            std::uint32_t station = entree.second;
+            if (entree.first != p_arrivees[station]) continue;
+            if (station == p_vers) break;
+            for (std::uint32_t i = p_debuts[station]; i < p_debuts[station + 1]; ++i)
+            {
+                const ArcHoraire &arc = p_arcs[i];
+                if (arc.depart < entree.first || arc.arrivee >= p_arrivees[arc.vers]) continue;
+                p_arrivees[arc.vers] = arc.arrivee;
+                file.push(Entree(arc.arrivee, arc.vers));
+            }
+            for (const Transfert &transfert : p_transferts.plage(station))
+            {
+                std::uint32_t arrivee = entree.first + transfert.temps;
+                if (arrivee >= p_arrivees[transfert.vers]) continue;
+                p_arrivees[transfert.vers] = arrivee;
+                file.push(Entree(arrivee, transfert.vers));
+            }
+        }
+        return p_arrivees[p_vers];
+    }
+
+    //! \brief construction d'un PlanificateurCSA, puis les mêmes requêtes au hasard que mesurerRaptor() par CSA et
+    //! par dijkstraNaif(), avec les transferts du dossier, puis avec les trajets à pied en plus
+    void mesurerCSA(const string &p_dossier)
+    {
+        cout << "=== Itinéraires CSA et Dijkstra ===" << endl;
+
+        DonneesGTFS donnees(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3 * 3600));
+        donnees.charger(p_dossier);
+        vector<std::uint32_t> debuts;
+        vector<ArcHoraire> arcs = arcsParStation(donnees, debuts);
+
+        vector<std::uint32_t> stations;
+        for (auto stationM : donnees.getStations()) stations.push_back(stationM.first);
+        vector<std::uint32_t> requetes;
+        mt19937 generateur(23);
+        for (std::size_t i = 0; i < NB_ITINERAIRES; ++i)
+        {
+            requetes.push_back(stations[generateur() % stations.size()]);
+            requetes.push_back(stations[generateur() % stations.size()]);
+            requetes.push_back(HEURE_MESURE.getCode() + generateur() % 3600);
+        }
+
+        for (int aPied = 0; aPied < 2; ++aPied)
+        {
+            if (aPied) donnees.ajouterTrajetsAPied();
+            PlanificateurCSA csa;
+            auto debut = chrono::steady_clock::now();
+            csa.construire(donnees);
+            auto fin = chrono::steady_clock::now();
+            cout << (aPied ? "Avec les trajets à pied: " : "Transferts du dossier: ") << csa.nbConnexions()
+                 << " connexions, construites en " << chrono::duration<double, milli>(fin - debut).count() << " ms"
+                 << endl;
+
+            vector<std::uint32_t> arriveesCSA, arriveesDijkstra;
+            debut = chrono::steady_clock::now();
+            for (std::size_t i = 0; i < requetes.size(); i += 3)
+            {
+                Itineraire itineraire = csa.trouver(requetes[i], requetes[i + 1], Heure::depuisCode(requetes[i + 2]));
+                arriveesCSA.push_back(itineraire.existe ? itineraire.arrivee.getCode() : 0xffffffff);
+            }
+            fin = chrono::steady_clock::now();
+            cout << "  CSA: " << chrono::duration<double, milli>(fin - debut).count() / NB_ITINERAIRES
+                 << " ms/requête" << endl;
+
+            vector<std::uint32_t> arrivees(csa.nbStations());
+            debut = chrono::steady_clock::now();
+            for (std::size_t i = 0; i < requetes.size(); i += 3)
+            {
+                arriveesDijkstra.push_back(dijkstraNaif(arcs, debuts, donnees.getGrapheTransferts(), requetes[i],
+                                                        requetes[i + 1], requetes[i + 2], arrivees));
+            }
+            fin = chrono::steady_clock::now();
+            std::size_t nbIdentiques = 0;
+            for (std::size_t i = 0; i < arriveesCSA.size(); ++i) nbIdentiques += arriveesCSA[i] == arriveesDijkstra[i];
+            cout << "  Dijkstra naïf: " << chrono::duration<double, milli>(fin - debut).count() / NB_ITINERAIRES
+                 << " ms/requête (" << nbIdentiques << " arrivées identiques sur " << NB_ITINERAIRES << ")" << endl;
+        }
+        cout << endl;
+    }
+
+    //! \brief matrice de toutes les stations vers toutes les stations à une heure de départ, avec les trajets à pied,
+    //! comparée à la même matrice estimée par des requêtes trouver() d'une paire chacune; les paires mesurées sont
+    //! vérifiées par PlanificateurRaptor::trouver()
+    void mesurerMatrice(const string &p_dossier)
+    {
+        cout << "=== Matrice des temps de parcours ===" << endl;
+
+        DonneesGTFS donnees(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3 * 3600));
+        donnees.charger(p_dossier);
+        donnees.ajouterTrajetsAPied();
+        PlanificateurCSA csa;
+        csa.construire(donnees);
+        PlanificateurRaptor raptor;
+        raptor.construire(donnees);
+
+        MatriceTemps matrice;
+        auto debut = chrono::steady_clock::now();
+        matrice.calculer(csa, vector<Heure>(1, HEURE_MESURE), 2 * 3600);
+        auto fin = chrono::steady_clock::now();
+        double duree = chrono::duration<double, milli>(fin - debut).count();
+        std::size_t nbAtteintes = 0;
+        for (std::uint32_t de = 0; de < matrice.nbStations(); ++de)
+        {
+            const std::uint16_t *rangee = matrice.rangee(0, de);
+            for (std::uint32_t vers = 0; vers < matrice.nbStations(); ++vers)
+            {
+                nbAtteintes += rangee[vers] != TEMPS_NON_ATTEINT;
+            }
+        }
+        double nbPaires = static_cast<double>(matrice.nbStations()) * matrice.nbStations();
+        cout << matrice.nbStations() << " origines sur " << nbFilsDisponibles() << " fils: " << duree << " ms ("
+             << duree / matrice.nbStations() << " ms/origine), " << nbAtteintes << " paires atteintes en 2 h, "
+             << nbPaires * sizeof(std::uint16_t) / (1 << 20) << " Mo" << endl;
+
+        vector<std::uint32_t> paires;
+        mt19937 generateur(23);
+        for (std::size_t i = 0; i < 2 * NB_ITINERAIRES; ++i) paires.push_back(generateur() % csa.nbStations());
+        debut = chrono::steady_clock::now();
+        for (std::size_t i = 0; i < paires.size(); i += 2) csa.trouver(paires[i], paires[i + 1], HEURE_MESURE);
+        fin = chrono::steady_clock::now();
+        std::size_t nbIdentiques = 0;
+        for (std::size_t i = 0; i < paires.size(); i += 2)
+        {
+            // Le nombre de transferts n'est pas borné dans la matrice
+            Itineraire itineraire = raptor.trouver(paires[i], paires[i + 1], HEURE_MESURE, 1000);
+            std::uint32_t duree = itineraire.arrivee.getCode() - HEURE_MESURE.getCode();
+            std::uint16_t attendu = TEMPS_NON_ATTEINT;
+            if (itineraire.existe && duree < 2 * 3600) attendu = static_cast<std::uint16_t>((duree + 59) / 60);
+            nbIdentiques += matrice.minutes(0, paires[i], paires[i + 1]) == attendu;
+        }
+        cout << "  une requête trouver() par paire (estimé): "
+             << chrono::duration<double, milli>(fin - debut).count() / NB_ITINERAIRES * nbPaires << " ms; "
+             << nbIdentiques << " cases identiques à PlanificateurRaptor::trouver() sur " << NB_ITINERAIRES << endl;
+
+        // Les marches plus longues que la borne de la fermeture sont prolongées: la matrice ne doit pas en dépendre
+        PlanificateurCSA csaCourt;
+        csaCourt.construire(donnees, 5 * 60);
+        MatriceTemps matriceCourte;
+        debut = chrono::steady_clock::now();
+        matriceCourte.calculer(csaCourt, vector<Heure>(1, HEURE_MESURE), 2 * 3600);
+        fin = chrono::steady_clock::now();
+        std::size_t nbDifferentes = 0;
+        for (std::uint32_t de = 0; de < matrice.nbStations(); ++de)
+        {
+            const std::uint16_t *rangee = matrice.rangee(0, de);
+            const std::uint16_t *rangeeCourte = matriceCourte.rangee(0, de);
+            for (std::uint32_t vers = 0; vers < matrice.nbStations(); ++vers)
+            {
+                nbDifferentes += rangee[vers] != rangeeCourte[vers];
+            }
+        }
+        cout << "  fermeture bornée à 5 min: " << chrono::duration<double, milli>(fin - debut).count() << " ms; "
+             << nbDifferentes << " case(s) différente(s)" << endl
+             << endl;
+    }
+
+    //! \brief les 10 prochains départs de stations au hasard: index des stations et registres, comme
+    //! afficherArretsParStations(), puis TableauDeparts, une requête à la fois et par lots
+    void mesurerTableauDeparts(const string &p_dossier)
+    {
+        cout << "=== Tableaux des départs ===" << endl;
+
+        DonneesGTFS donnees(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3 * 3600));
+        donnees.charger(p_dossier);
+        TableauDeparts tableau;
+        auto debut = chrono::steady_clock::now();
+        tableau.construire(donnees);
+        auto fin = chrono::steady_clock::now();
+        cout << tableau.taille() << " départs, construits en " << chrono::duration<double, milli>(fin - debut).count()
+             << " ms" << endl;
+
+        vector<RequeteTableau> requetes;
+        mt19937 generateur(23);
+        for (std::size_t i = 0; i < NB_TABLEAUX; ++i)
+        {
+            RequeteTableau requete = {static_cast<std::uint32_t>(generateur() % tableau.nbStations()),
+                                      static_cast<std::uint32_t>(HEURE_MESURE.getCode() + generateur() % (3 * 3600)),
+                                      10};
+            requetes.push_back(requete);
+        }
+
+        auto mesurer = [](const char *p_nom, const std::function<std::size_t()> &p_tableaux) {
+            auto debut = chrono::steady_clock::now();
+            std::size_t nbLignes = p_tableaux();
+            auto fin = chrono::steady_clock::now();
+            cout << "  " << p_nom << ": " << NB_TABLEAUX / chrono::duration<double, milli>(fin - debut).count()
+                 << " tableaux/ms (" << nbLignes << " lignes)" << endl;
+        };
+        const TableArrets &table = donnees.getTableArrets();
+        mesurer("index des stations et registres", [&]() {
+            std::size_t nbLignes = 0;
+            for (const RequeteTableau &requete : requetes)
+            {
+                PlageStation plage = donnees.getIndexStations().plage(requete.station);
+                std::size_t n = 0;
+                for (std::size_t i = plage.premierDepart(requete.heure); i < plage.size() && n < requete.nombre; ++i)
+                {
+                    std::uint32_t voyageId = table.getVoyages()[plage.rangees[i]];
+                    if (plage.rangees[i] + 1 == table.getDebuts()[voyageId + 1]) continue;
+                    const Voyage &voyage = donnees.getVoyages()[voyageId];
+                    std::string numero = donnees.getLignes()[voyage.getLigne()].getNumero();
+                    nbLignes += !numero.empty() || !voyage.getDestination().empty();
+                    ++n;
+                }
+            }
+            return nbLignes;
+        });
+        mesurer("TableauDeparts::prochains", [&]() {
+            std::size_t nbLignes = 0;
+            for (const RequeteTableau &requete : requetes)
+            {
+                nbLignes += tableau.prochains(requete.station, requete.heure, requete.nombre).size();
+            }
+            return nbLignes;
+        });
+        vector<PlageDeparts> tableaux;
+        mesurer("TableauDeparts::prochains par lots", [&]() {
+            tableau.prochains(requetes, tableaux);
+            std::size_t nbLignes = 0;
+            for (const PlageDeparts &plage : tableaux) nbLignes += plage.size();
+            return nbLignes;
+        });
+        cout << endl;
+    }
+
+    //! \brief copie les six fichiers GTFS de p_dossier dans p_copie, qui doit exister
+    void copierDossier(const string &p_dossier, const string &p_copie)
+    {
+        for (const char *nom : {"routes.txt", "stops.txt", "calendar_dates.txt", "trips.txt", "stop_times.txt",
+                                "transfers.txt"})
+        {
+            ifstream source(p_dossier + "/" + nom, ios::binary);
+            ofstream copie(p_copie + "/" + nom, ios::binary | ios::trunc);
+            copie << source.rdbuf();
+        }
+    }
+
+    //! \brief retarde de dix minutes les heures du premier arrêt de stop_times.txt qui termine son voyage et dont
+    //! l'arrivée commence par p_prefixe ("HH:M", avec M < 5), sans changer la taille du fichier; les heures du voyage
+    //! restent ainsi cohérentes avec ses numéros de séquence
+    void retarderUnArret(const string &p_dossier, const string &p_prefixe)
+    {
+        string nom = p_dossier + "/stop_times.txt";
+        ifstream source(nom, ios::binary);
+        string contenu((istreambuf_iterator<char>(source)), istreambuf_iterator<char>());
+        source.close();
+        for (std::size_t position = contenu.find("," + p_prefixe); position != string::npos;
+             position = contenu.find("," + p_prefixe, position + 1))
+        {
+            std::size_t debutLigne = contenu.rfind('\n', position) + 1;
+            std::size_t finLigne = contenu.find('\n', position);
+            if (finLigne == string::npos) return;
+            string voyage = contenu.substr(debutLigne, contenu.find(',', debutLigne) - debutLigne);
+            if (contenu.compare(finLigne + 1, voyage.size() + 1, voyage + ",") == 0) continue;
+
+            for (; position < finLigne; position = contenu.find("," + p_prefixe, position + 1))
+            {
+                ++contenu[position + p_prefixe.size()];
+            }
+            ofstream(nom, ios::binary | ios::trunc) << contenu;
+            return;
+        }
+    }
+
+    //! \brief vrai si p_a et p_b ont les mêmes voyages, chacun avec les mêmes arrêts, et si chaque station a ses
+    //! arrêts dans le même ordre; les identifiants denses des deux objets peuvent différer, les stop_id et trip_id
+    //! sont donc comparés
+    bool memesArrets(const DonneesGTFS &p_a, const DonneesGTFS &p_b)
+    {
+        if (p_a.getNbVoyages() != p_b.getNbVoyages() || p_a.getNbArrets() != p_b.getNbArrets()) return false;
+        for (const auto &voyageM : p_a.getVoyages())
+        {
+            std::uint32_t v = p_b.getIdsVoyages().trouver(p_a.getIdsVoyages().chaine(voyageM.first));
+            if (!p_b.getVoyages().contient(v)) return false;
+            const PlageArrets &a = voyageM.second.getArrets();
+            const PlageArrets &b = p_b.getVoyages()[v].getArrets();
+            if (a.size() != b.size()) return false;
+            for (std::size_t i = 0; i < a.size(); ++i)
+            {
+                if (a.arrivees[i] != b.arrivees[i] || a.departs[i] != b.departs[i] ||
+                    p_a.getIdsStations().chaine(a.stations[i]) != p_b.getIdsStations().chaine(b.stations[i]))
+                    return false;
+            }
+        }
+        if (p_a.getNbStations() != p_b.getNbStations()) return false;
+        for (const auto &stationM : p_a.getStations())
+        {
+            std::uint32_t s = p_b.getIdsStations().trouver(p_a.getIdsStations().chaine(stationM.first));
+            if (!p_b.getStations().contient(s)) return false;
+            const PlageStation &a = stationM.second.getArrets();
+            const PlageStation &b = p_b.getStations()[s].getArrets();
+            //à départ égal, l'ordre suit les identifiants denses des voyages: il est comparé par trip_id
+            std::vector<std::pair<std::uint32_t, string> > arretsA, arretsB;
+            for (std::size_t i = 0; i < a.size(); ++i)
+            {
+                arretsA.push_back(std::make_pair(a.departs[i], p_a.getIdsVoyages().chaine(
+                        p_a.getTableArrets().getVoyages()[a.rangees[i]])));
+            }
+            for (std::size_t i = 0; i < b.size(); ++i)
+            {
+                arretsB.push_back(std::make_pair(b.departs[i], p_b.getIdsVoyages().chaine(
+                        p_b.getTableArrets().getVoyages()[b.rangees[i]])));
+            }
+            if (!std::is_sorted(arretsA.begin(), arretsA.end(),
+                                [](const std::pair<std::uint32_t, string> &p_x,
+                                   const std::pair<std::uint32_t, string> &p_y) { return p_x.first < p_y.first; }))
+                return false;
+            std::sort(arretsA.begin(), arretsA.end());
+            std::sort(arretsB.begin(), arretsB.end());
+            if (arretsA != arretsB) return false;
+        }
+        return true;
+    }
+
+    //! \brief premier chargement par recharger(), puis rechargement d'un dossier inchangé; enfin, rechargement après
+    //! chargerInstantane(), qui remplace tous les arrêts de l'objet, comparé au chargement complet du même dossier
+    void mesurerRechargement(const string &p_dossier)
+    {
+        cout << "=== Rechargement incrémental ===" << endl;
+
+        DonneesGTFS donnees(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3600));
+        RapportRechargement premier = donnees.recharger(p_dossier);
+        cout << "Premier chargement: " << premier.nbVoyagesAjoutes << " voyages, " << premier.nbArretsAjoutes
+             << " arrêts en " << 1e3 * premier.duree << " ms" << endl;
+        RapportRechargement second = donnees.recharger(p_dossier);
+        cout << "Dossier inchangé: " << second.nbFichiersModifies << " fichier modifié, " << second.nbArretsAjoutes
+             << " arrêt ajouté en " << 1e3 * second.duree << " ms" << endl;
+
+        char modele[] = "/tmp/rechargementXXXXXX";
+        if (mkdtemp(modele) == nullptr)
+        {
+            cout << endl;
+            return;
+        }
+        string copie = modele;
+        copierDossier(p_dossier, copie);
+        DonneesGTFS apresInstantane(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3600));
+        apresInstantane.recharger(copie);
+        apresInstantane.sauvegarderInstantane(copie + "/instantane.bin", copie);
+        bool instantane = apresInstantane.chargerInstantane(copie + "/instantane.bin", copie);
+        retarderUnArret(copie, "07:4"); //un arrêt de la première heure après HEURE_MESURE
+        RapportRechargement troisieme = apresInstantane.recharger(copie);
+        DonneesGTFS complet(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3600));
+        complet.charger(copie);
+        cout << "Après chargerInstantane()" << (instantane ? "" : " (instantané refusé)") << ": rechargement "
+             << (troisieme.complet ? "complet" : "incrémental") << " en " << 1e3 * troisieme.duree << " ms, "
+             << (memesArrets(apresInstantane, complet) ? "identique" : "DIFFÉRENT") << " au chargement complet"
+             << endl;
+
+        retarderUnArret(copie, "07:4"); //un autre voyage: ses rangées sont réécrites sur place
+        RapportRechargement quatrieme = apresInstantane.recharger(copie);
+        DonneesGTFS completRetarde(DATE_MESURE, HEURE_MESURE, HEURE_MESURE.add_secondes(3600));
+        completRetarde.charger(copie);
+        cout << "Un voyage retardé: " << quatrieme.nbVoyagesModifies << " voyage modifié en " << 1e3 * quatrieme.duree
+             << " ms, " << (memesArrets(apresInstantane, completRetarde) ? "identique" : "DIFFÉRENT")
+             << " au chargement complet" << endl << endl;
+
+        for (const char *nom : {"routes.txt", "stops.txt", "calendar_dates.txt", "trips.txt", "stop_times.txt",
+                                "transfers.txt", "instantane.bin"})
+        {
+            std::remove((copie + "/" + nom).c_str());
+        }
+        rmdir(modele);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const std::string chemin_dossier = argc > 1 ? argv[1] : "../RTC-1aout-25nov";
+
+    mesurerConversions();
+    mesurerRejetArrets(chemin_dossier);
+    mesurerChargement(chemin_dossier);
+    if (argc > 2) mesurerArchive(chemin_dossier, argv[2]);
+    mesurerHoraire(chemin_dossier);
+    mesurerOperationsHeures(chemin_dossier);
+    mesurerTransferts(chemin_dossier);
+    mesurerRechargement(chemin_dossier);
+    mesurerIndexSpatial(chemin_dossier);
+    mesurerDistancesParLots();
+    mesurerTrajetsAPied(chemin_dossier);
+    mesurerRaptor(chemin_dossier);
+    mesurerCSA(chemin_dossier);
+    mesurerMatrice(chemin_dossier);
+    mesurerTableauDeparts(chemin_dossier);
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+//
+// Chargement concurrent des six fichiers d'un dossier GTFS, selon les dépendances entre les phases.
+//
+
+#include "DonneesGTFS.h"
+#include "archivezip.h"
+#include "parallele.h"
+
+#include <cstring>
+#include <memory>
+
+using namespace std;
+
+namespace
+{
+    const std::size_t TAILLE_PAGE = 4096;
+
+    enum Fichier {ROUTES, STOPS, CALENDAR_DATES, TRIPS, STOP_TIMES, TRANSFERS, NB_FICHIERS};
+    const char *const NOMS_FICHIERS[NB_FICHIERS] = {"routes.txt", "stops.txt", "calendar_dates.txt", "trips.txt",
+                                                    "stop_times.txt", "transfers.txt"};
+
+    //! \brief lit une fois chacune des pages d'un fichier ouvert, pour qu'il soit en mémoire lorsque sa phase démarrera
+    void lirePages(const FichierMappe &p_fichier)
+    {
+        if (!p_fichier.estOuvert()) return; //l'erreur sera signalée par la phase qui lit le fichier
+
+        volatile char somme = 0;
+        for (const char *p = p_fichier.debut(); p < p_fichier.fin(); p += TAILLE_PAGE) somme += *p;
+    }
+
+    /*!
+     * \brief projette l'archive zip que désigne p_dossier, s'il en désigne une, et lit son répertoire central
+     * \param[out] p_prefixe: le chemin du dossier dans l'archive, "" ou terminé par '/', à placer devant les noms
+     * \return false si p_dossier n'est pas dans une archive
+     * \throws logic_error si l'archive est corrompue
+     */
+    bool ouvrirArchive(const std::string &p_dossier, std::unique_ptr<FichierMappe> &p_fichier,
+                       std::unique_ptr<ArchiveZip> &p_archive, std::string &p_prefixe)
+    {
+        std::string nomArchive, nomMembre;
+        if (!separerCheminArchive(p_dossier + "/" + NOMS_FICHIERS[ROUTES], nomArchive, nomMembre)) return false;
+        p_fichier.reset(new FichierMappe(nomArchive));
+        if (!p_fichier->estOuvert()) return false;
+        p_archive.reset(new ArchiveZip(p_fichier->debut(), p_fichier->fin()));
+        p_prefixe = nomMembre.substr(0, nomMembre.size() - std::strlen(NOMS_FICHIERS[ROUTES]));
+        return true;
+    }
+}
+
+/*!
+ * \brief charge les six fichiers du dossier GTFS en exécutant les phases indépendantes en même temps
+ * \brief Chaque fichier est d'abord ouvert par sa propre tâche, toutes en même temps. Les lignes, les stations,
+ * les services et la lecture des transferts ne dépendent ensuite que de leur fichier; les voyages dépendent des
+ * services et des lignes (ils internent leur route_id dans la même table), les arrêts des voyages et des stations, et
+ * l'ajout des transferts des arrêts. Le résultat est celui des six méthodes ajouter* appelées dans l'ordre
+ * \param[in] p_dossier: le dossier contenant routes.txt, stops.txt, calendar_dates.txt, trips.txt, stop_times.txt
+ * et transfers.txt, ou une archive zip qui les contient. L'archive est alors projetée et son répertoire lu une seule
+ * fois, avant les tâches. stop_times.txt est décompressé par tranches par sa propre tâche, et ses arrêts sont lus à
+ * mesure que les tranches sont produites; les autres membres, petits, sont décompressés au complet par la tâche qui
+ * les ouvre. La décompression d'un membre reste séquentielle et ne chevauche les autres phases que s'il reste des
+ * cœurs libres: sur un seul cœur, charger une archive coûte autant que le dossier plus la décompression
+ * \post getDureesChargement() donne le début et la durée de chaque phase
+ * \throws logic_error si un problème survient avec la lecture d'un fichier
+ */
+void DonneesGTFS::charger(const std::string &p_dossier)
+{
+    m_etatRechargement = EtatRechargement();
+
+    // Les tâches d'ouverture se partagent le répertoire de l'archive, qui n'est que consulté
+    std::unique_ptr<FichierMappe> fichierArchive;
+    std::unique_ptr<ArchiveZip> archive;
+    std::string prefixe;
+    ouvrirArchive(p_dossier, fichierArchive, archive, prefixe);
+
+    std::unique_ptr<FichierMappe> fichiers[NB_FICHIERS];
+    std::vector<std::tuple<std::string, std::string, unsigned int> > transferts;
+    GrapheDeTaches graphe;
+
+    std::size_t ouvertures[NB_FICHIERS];
+    for (std::size_t f = 0; f < NB_FICHIERS; ++f)
+    {
+        ouvertures[f] = graphe.ajouter(std::string("ouverture de ") + NOMS_FICHIERS[f], [&, f]() {
+            if (!archive)
+            {
+                fichiers[f].reset(new FichierMappe(p_dossier + "/" + NOMS_FICHIERS[f]));
+                lirePages(*fichiers[f]);
+            }
+            else if (f == STOP_TIMES)
+            {
+                fichiers[f].reset(new FichierMappe(*archive, prefixe + NOMS_FICHIERS[f], true));
+            }
+            else
+            {
+                fichiers[f].reset(new FichierMappe(*archive, prefixe + NOMS_FICHIERS[f]));
+            }
+        });
+    }
+
+    // La lecture des arrêts décompresse elle-même les tranches qui lui manquent si cette tâche n'a pas de fil libre
+    std::vector<std::size_t> avantTransferts;
+    if (archive)
+    {
+        avantTransferts.push_back(graphe.ajouter("décompression de stop_times.txt", [&]() {
+            if (fichiers[STOP_TIMES]->estOuvert()) fichiers[STOP_TIMES]->attendre(fichiers[STOP_TIMES]->taille());
+        }, {ouvertures[STOP_TIMES]}));
+    }
+
+    std::size_t lignes = graphe.ajouter("lignes", [&]() { ajouterLignes(*fichiers[ROUTES]); }, {ouvertures[ROUTES]});
+    std::size_t stations = graphe.ajouter("stations", [&]() { ajouterStations(*fichiers[STOPS]); },
+                                          {ouvertures[STOPS]});
+    std::size_t services = graphe.ajouter("services", [&]() { ajouterServices(*fichiers[CALENDAR_DATES]); },
+                                          {ouvertures[CALENDAR_DATES]});
+    std::size_t lectureTransferts = graphe.ajouter("lecture des transferts", [&]() {
+        lireTransferts(*fichiers[TRANSFERS], transferts);
+    }, {ouvertures[TRANSFERS]});
+    std::size_t voyages = graphe.ajouter("voyages", [&]() { ajouterVoyagesDeLaDate(*fichiers[TRIPS]); },
+                                         {lignes, services, ouvertures[TRIPS]});
+    std::size_t arrets = graphe.ajouter("arrêts", [&]() { ajouterArretsDesVoyagesDeLaDate(*fichiers[STOP_TIMES]); },
+                                        {stations, voyages, ouvertures[STOP_TIMES]});
+    avantTransferts.push_back(lectureTransferts);
+    avantTransferts.push_back(arrets);
+    graphe.ajouter("transferts", [&]() {
+        fichiers[STOP_TIMES].reset(); //plus aucune tâche ne s'en sert
+        appliquerTransferts(transferts);
+    }, avantTransferts);
+
+    graphe.executer();
+
+    m_dureesChargement.clear();
+    for (std::size_t i = 0; i < graphe.taille(); ++i)
+    {
+        DureePhase phase;
+        phase.nom = graphe.nom(i);
+        phase.debut = graphe.debut(i);
+        phase.duree = graphe.duree(i);
+        m_dureesChargement.push_back(phase);
+    }
+}
@@ -3,6 +3,10 @@
 //
 
 #include "coordonnees.h"
+#include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 /*!
  * \brief Constructeur de la classe, permet de construire une coordonnéees à partir de la longitude et de la latitude.
@@ -17,25 +21,6 @@ Coordonnees::Coordonnees(double latitude, double longitude) : m_latitude(latitud
 
 };
 
-/*!
- * \brief Constructeur de copie de la classe, permet de construire une coordonnéees à partir d'une autre coordonnée.
- * \exception logic_error si La latitude et/ou la longitude de cette coordonnée est invalide
- */
-Coordonnees::Coordonnees(const Coordonnees & rhs)
-{
-    if (this != &rhs)
-    {
-        double longitude = rhs.getLongitude();
-        double latitude = rhs.getLatitude();
-        if (!Coordonnees::is_valide_coord(latitude, longitude))
-        {
-            throw std::logic_error("Coordonnees::Coordonnees(): rhs est une coordonnée invalide");
-        }
-        m_longitude = rhs.getLongitude();
-        m_latitude = rhs.getLatitude();
-    }
-}
-
 double Coordonnees::getLatitude() const
 {
     return m_latitude;
@@ -93,3 +78,200 @@ std::ostream &operator<<(std::ostream &flux, const Coordonnees &p_coord)
     flux << ")";
     return flux;
 }
+
+namespace
+{
+    const double PI = 3.14159265358979323846;
+    const double RAYON_TERRE = 6371; //en km, celui de Coordonnees::operator-
+
+    // asin(x) = x + x R(x²) sur [0, 1/2], R = P / Q (approximation rationnelle de fdlibm)
+    const double ASIN_P[6] = {1.66666666666666657415e-01, -3.25565818622400915405e-01, 2.01212532134862925881e-01,
+                              -4.00555345006794114027e-02, 7.91534994289814532176e-04, 3.47933107596021167570e-05};
+    const double ASIN_Q[4] = {-2.40339491173441421878e+00, 2.02094576023350569471e+00, -6.88283971605453293030e-01,
+                              7.70381505559019352791e-02};
+
+    inline double rationnelleAsin(double p_t)
+    {
+        double p = ASIN_P[5];
+        for (int k = 4; k >= 0; --k) p = p * p_t + ASIN_P[k];
+        double q = ASIN_Q[3];
+        for (int k = 2; k >= 0; --k) q = q * p_t + ASIN_Q[k];
+        return p_t * p / (q * p_t + 1);
+    }
+
+    //! \brief asin(sqrt(p_a)), pour p_a dans [0, 1]; au-delà de 1/4, asin(s) = pi/2 - 2 asin(sqrt((1 - s) / 2))
+    inline double asinRacine(double p_a)
+    {
+        double s = std::sqrt(p_a);
+        if (p_a <= 0.25) return s + s * rationnelleAsin(p_a);
+        double t = (1 - s) / 2;
+        double r = std::sqrt(t);
+        return PI / 2 - 2 * (r + r * rationnelleAsin(t));
+    }
+
+    //! \brief ramène un écart de longitudes dans [-pi, pi]
+    inline double ramener(double p_ecart)
+    {
+        if (p_ecart > PI) return p_ecart - 2 * PI;
+        if (p_ecart < -PI) return p_ecart + 2 * PI;
+        return p_ecart;
+    }
+
+#if defined(__SSE2__)
+    inline __m128d rationnelleAsin(__m128d p_t)
+    {
+        __m128d p = _mm_set1_pd(ASIN_P[5]);
+        for (int k = 4; k >= 0; --k) p = _mm_add_pd(_mm_mul_pd(p, p_t), _mm_set1_pd(ASIN_P[k]));
+        __m128d q = _mm_set1_pd(ASIN_Q[3]);
+        for (int k = 2; k >= 0; --k) q = _mm_add_pd(_mm_mul_pd(q, p_t), _mm_set1_pd(ASIN_Q[k]));
+        q = _mm_add_pd(_mm_mul_pd(q, p_t), _mm_set1_pd(1.0));
+        return _mm_div_pd(_mm_mul_pd(p_t, p), q);
+    }
+
+    //! \brief les deux branches de asinRacine(double) sont calculées, puis choisies voie par voie
+    inline __m128d asinRacine(__m128d p_a)
+    {
+        const __m128d un = _mm_set1_pd(1.0), demi = _mm_set1_pd(0.5);
+        __m128d s = _mm_sqrt_pd(p_a);
+        __m128d petit = _mm_add_pd(s, _mm_mul_pd(s, rationnelleAsin(p_a)));
+        __m128d choix = _mm_cmple_pd(p_a, _mm_set1_pd(0.25));
+        if (_mm_movemask_pd(choix) == 3) return petit; //deux points à moins de 6671 km: le cas courant
+        __m128d t = _mm_mul_pd(_mm_sub_pd(un, s), demi);
+        __m128d r = _mm_sqrt_pd(t);
+        __m128d grand = _mm_sub_pd(_mm_set1_pd(PI / 2),
+                                   _mm_mul_pd(_mm_set1_pd(2.0), _mm_add_pd(r, _mm_mul_pd(r, rationnelleAsin(t)))));
+        return _mm_or_pd(_mm_and_pd(choix, petit), _mm_andnot_pd(choix, grand));
+    }
+
+    inline __m128d ramener(__m128d p_ecart)
+    {
+        const __m128d pi = _mm_set1_pd(PI), periode = _mm_set1_pd(2 * PI);
+        __m128d moins = _mm_and_pd(_mm_cmpgt_pd(p_ecart, pi), periode);
+        __m128d plus = _mm_and_pd(_mm_cmplt_pd(p_ecart, _mm_sub_pd(_mm_setzero_pd(), pi)), periode);
+        return _mm_add_pd(_mm_sub_pd(p_ecart, moins), plus);
+    }
+#endif
+}
+
+//! \brief ajoute une coordonnée à la fin des colonnes
+void ColonnesCoordonnees::ajouter(const Coordonnees &p_coords)
+{
+    double latitude = p_coords.getLatitude() * PI / 180.0;
+    double longitude = p_coords.getLongitude() * PI / 180.0;
+    m_latitudes.push_back(latitude);
+    m_longitudes.push_back(longitude);
+    m_sinLatitudes.push_back(std::sin(latitude));
+    m_cosLatitudes.push_back(std::cos(latitude));
+    m_sinDemiLatitudes.push_back(std::sin(latitude / 2));
+    m_cosDemiLatitudes.push_back(std::cos(latitude / 2));
+    m_sinDemiLongitudes.push_back(std::sin(longitude / 2));
+    m_cosDemiLongitudes.push_back(std::cos(longitude / 2));
+}
+
+void ColonnesCoordonnees::reserver(std::size_t p_nombre)
+{
+    m_latitudes.reserve(p_nombre);
+    m_longitudes.reserve(p_nombre);
+    m_sinLatitudes.reserve(p_nombre);
+    m_cosLatitudes.reserve(p_nombre);
+    m_sinDemiLatitudes.reserve(p_nombre);
+    m_cosDemiLatitudes.reserve(p_nombre);
+    m_sinDemiLongitudes.reserve(p_nombre);
+    m_cosDemiLongitudes.reserve(p_nombre);
+}
+
+void ColonnesCoordonnees::vider()
+{
+    m_latitudes.clear();
+    m_longitudes.clear();
+    m_sinLatitudes.clear();
+    m_cosLatitudes.clear();
+    m_sinDemiLatitudes.clear();
+    m_cosDemiLatitudes.clear();
+    m_sinDemiLongitudes.clear();
+    m_cosDemiLongitudes.clear();
+}
+
+std::size_t ColonnesCoordonnees::taille() const
+{
+    return m_latitudes.size();
+}
+
+/*!
+ * \brief calcule la distance, en km, entre p_origine et chacune des coordonnées
+ * \brief HAVERSINE est la distance à vol d'oiseau de Coordonnees::operator-, mais sans sa perte de précision pour les
+ * points rapprochés. EQUIRECTANGULAIRE projette les deux points sur le plan tangent à leur latitude moyenne: plus
+ * rapide, son erreur relative croît avec le carré de la distance et reste sous 1e-4 jusqu'à 100 km pour des
+ * latitudes d'au plus 70 degrés (4e-4 à 80 degrés)
+ * \param[out] p_distances: un tableau d'au moins taille() distances, dans l'ordre des coordonnées
+ */
+void ColonnesCoordonnees::distancesDepuis(const Coordonnees &p_origine, double *p_distances,
+                                          MethodeDistance p_methode) const
+{
+    const double latitude = p_origine.getLatitude() * PI / 180.0;
+    const double longitude = p_origine.getLongitude() * PI / 180.0;
+    const std::size_t n = taille();
+    std::size_t i = 0;
+
+    if (p_methode == MethodeDistance::HAVERSINE)
+    {
+        // a = sin²(dlat / 2) + cos(lat1) cos(lat2) sin²(dlon / 2), d = 2 R asin(sqrt(a)); les sinus des demi-écarts
+        // viennent de sin(u - v) = sin(u) cos(v) - cos(u) sin(v), sur les demi-angles mémorisés
+        const double sinDemiLat = std::sin(latitude / 2), cosDemiLat = std::cos(latitude / 2);
+        const double sinDemiLon = std::sin(longitude / 2), cosDemiLon = std::cos(longitude / 2);
+        const double cosLatitude = std::cos(latitude);
+        const double *sinDemiLats = m_sinDemiLatitudes.data(), *cosDemiLats = m_cosDemiLatitudes.data();
+        const double *sinDemiLons = m_sinDemiLongitudes.data(), *cosDemiLons = m_cosDemiLongitudes.data();
+        const double *cosLatitudes = m_cosLatitudes.data();
+#if defined(__SSE2__)
+        const __m128d un = _mm_set1_pd(1.0), diametre = _mm_set1_pd(2 * RAYON_TERRE);
+        const __m128d sinLat1 = _mm_set1_pd(sinDemiLat), cosLat1 = _mm_set1_pd(cosDemiLat);
+        const __m128d sinLon1 = _mm_set1_pd(sinDemiLon), cosLon1 = _mm_set1_pd(cosDemiLon);
+        const __m128d cos1 = _mm_set1_pd(cosLatitude);
+        for (; i + 2 <= n; i += 2)
+        {
+            __m128d sinLat = _mm_sub_pd(_mm_mul_pd(_mm_loadu_pd(sinDemiLats + i), cosLat1),
+                                        _mm_mul_pd(_mm_loadu_pd(cosDemiLats + i), sinLat1));
+            __m128d sinLon = _mm_sub_pd(_mm_mul_pd(_mm_loadu_pd(sinDemiLons + i), cosLon1),
+                                        _mm_mul_pd(_mm_loadu_pd(cosDemiLons + i), sinLon1));
+            __m128d cos12 = _mm_mul_pd(cos1, _mm_loadu_pd(cosLatitudes + i));
+            __m128d a = _mm_add_pd(_mm_mul_pd(sinLat, sinLat), _mm_mul_pd(cos12, _mm_mul_pd(sinLon, sinLon)));
+            _mm_storeu_pd(p_distances + i, _mm_mul_pd(diametre, asinRacine(_mm_min_pd(a, un))));
+        }
+#endif
+        for (; i < n; ++i)
+        {
+            double sinLat = sinDemiLats[i] * cosDemiLat - cosDemiLats[i] * sinDemiLat;
+            double sinLon = sinDemiLons[i] * cosDemiLon - cosDemiLons[i] * sinDemiLon;
+            double a = sinLat * sinLat + (cosLatitude * cosLatitudes[i]) * (sinLon * sinLon);
+            p_distances[i] = 2 * RAYON_TERRE * asinRacine(std::min(a, 1.0));
+        }
+        return;
+    }
+
+    // x = dlon cos(latm), y = dlat, d = R sqrt(x² + y²); cos²(latm) = (1 + cos(lat1 + lat2)) / 2, latm dans [0, pi/2]
+    const double sinLatitude = std::sin(latitude), cosLatitude = std::cos(latitude);
+    const double *latitudes = m_latitudes.data(), *longitudes = m_longitudes.data();
+    const double *sinLatitudes = m_sinLatitudes.data(), *cosLatitudes = m_cosLatitudes.data();
+#if defined(__SSE2__)
+    const __m128d demi = _mm_set1_pd(0.5), un = _mm_set1_pd(1.0), rayon = _mm_set1_pd(RAYON_TERRE);
+    const __m128d lat1 = _mm_set1_pd(latitude), lon1 = _mm_set1_pd(longitude);
+    const __m128d sin1 = _mm_set1_pd(sinLatitude), cos1 = _mm_set1_pd(cosLatitude);
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d cosSomme = _mm_sub_pd(_mm_mul_pd(cos1, _mm_loadu_pd(cosLatitudes + i)),
+                                      _mm_mul_pd(sin1, _mm_loadu_pd(sinLatitudes + i)));
+        __m128d cosMoyenne = _mm_sqrt_pd(_mm_max_pd(_mm_mul_pd(_mm_add_pd(un, cosSomme), demi), _mm_setzero_pd()));
+        __m128d x = _mm_mul_pd(ramener(_mm_sub_pd(_mm_loadu_pd(longitudes + i), lon1)), cosMoyenne);
+        __m128d y = _mm_sub_pd(_mm_loadu_pd(latitudes + i), lat1);
+        _mm_storeu_pd(p_distances + i, _mm_mul_pd(rayon, _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y)))));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        double cosSomme = cosLatitude * cosLatitudes[i] - sinLatitude * sinLatitudes[i];
+        double x = ramener(longitudes[i] - longitude) * std::sqrt(std::max((1 + cosSomme) / 2, 0.0));
+        double y = latitudes[i] - latitude;
+        p_distances[i] = RAYON_TERRE * std::sqrt(x * x + y * y);
+    }
+}
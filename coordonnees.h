@@ -11,6 +11,8 @@
 #include <stdexcept>
 #include <iostream>
 #include <sstream>
+#include <vector>
+#include <cstddef>
 
 /*!
  * \class Coordonnees
@@ -21,7 +23,7 @@ class Coordonnees {
 public:
 
     Coordonnees(double latitude, double longitude);
-    Coordonnees(const Coordonnees & rhs);
+    Coordonnees(const Coordonnees & rhs) = default; //une coordonnée construite est toujours valide
     double getLatitude() const ;
     double getLongitude() const ;
     static bool is_valide_coord(double p_latitude, double p_longitude) ;
@@ -34,4 +36,40 @@ private:
 };
 
 
+/*!
+ * \enum MethodeDistance
+ * \brief Calcul des distances de ColonnesCoordonnees::distancesDepuis()
+ */
+enum class MethodeDistance {HAVERSINE, EQUIRECTANGULAIRE};
+
+/*!
+ * \class ColonnesCoordonnees
+ * \brief Des coordonnées rangées en colonnes, pour calculer d'un coup la distance d'un point à chacune d'elles
+ *
+ *  Les fonctions trigonométriques de chaque coordonnée (latitude et longitude en radians, sinus et cosinus de la
+ *  latitude et des demi-angles) sont calculées une fois, à l'ajout: distancesDepuis() n'évalue plus qu'un asin par
+ *  paire, par une approximation rationnelle précise au double près. Deux coordonnées sont traitées à la fois (SSE2);
+ *  la boucle scalaire de repli fait les mêmes opérations et donne les mêmes distances.
+ */
+class ColonnesCoordonnees
+{
+public:
+    void ajouter(const Coordonnees &p_coords);
+    void reserver(std::size_t p_nombre);
+    void vider();
+    std::size_t taille() const;
+    void distancesDepuis(const Coordonnees &p_origine, double *p_distances,
+                         MethodeDistance p_methode = MethodeDistance::HAVERSINE) const;
+
+private:
+    std::vector<double> m_latitudes;  //en radians
+    std::vector<double> m_longitudes; //en radians
+    std::vector<double> m_sinLatitudes;
+    std::vector<double> m_cosLatitudes;
+    std::vector<double> m_sinDemiLatitudes;
+    std::vector<double> m_cosDemiLatitudes;
+    std::vector<double> m_sinDemiLongitudes;
+    std::vector<double> m_cosDemiLongitudes;
+};
+
 #endif //RTC_COORDONNEES_H
@@ -0,0 +1,186 @@
+//
+// Planificateur d'itinéraires CSA: arrivée la plus tôt, par un seul balayage des connexions triées par départ.
+//
+
+#include "csa.h"
+#include "DonneesGTFS.h"
+#include "parallele.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    const std::uint32_t INFINI = 0xffffffff; //heure d'arrivée d'une station non atteinte
+    const std::uint32_t AUCUN = TableIdentifiants::ABSENT;
+}
+
+PlanificateurCSA::PlanificateurCSA() : m_nbStations(0)
+{
+}
+
+/*!
+ * \brief reconstruit le tableau des connexions à partir des arrêts consécutifs de chaque voyage de p_donnees
+ *
+ *  Les connexions sont créées voyage par voyage, dans l'ordre des arrêts, puis triées par heure de départ avec
+ *  trierParCles(): le tri est stable, ce qui garde en ordre les connexions d'un même voyage qui partent à la
+ *  même heure.
+ * \param[in] p_marcheMax: la durée maximale, en secondes, des transferts enchaînés entre deux voyages; chaque
+ * transfert du réseau est gardé, quelle que soit sa durée
+ */
+void PlanificateurCSA::construire(const DonneesGTFS &p_donnees, std::uint32_t p_marcheMax)
+{
+    vider();
+    m_nbStations = static_cast<std::uint32_t>(p_donnees.getIdsStations().taille());
+
+    std::vector<Connexion> connexions;
+    for (auto voyageM : p_donnees.getVoyages())
+    {
+        const PlageArrets &arrets = voyageM.second.getArrets();
+        if (arrets.nombre < 2) continue;
+        std::uint32_t rang = static_cast<std::uint32_t>(m_voyages.size());
+        m_voyages.push_back(voyageM.first);
+        for (std::size_t i = 0; i + 1 < arrets.nombre; ++i)
+        {
+            Connexion connexion = {arrets.stations[i], arrets.stations[i + 1], arrets.departs[i],
+                                   arrets.arrivees[i + 1], rang};
+            connexions.push_back(connexion);
+        }
+    }
+
+    std::vector<std::uint32_t> departs(connexions.size());
+    std::vector<std::uint32_t> ordre(connexions.size());
+    for (std::uint32_t i = 0; i < connexions.size(); ++i)
+    {
+        departs[i] = connexions[i].depart;
+        ordre[i] = i;
+    }
+    trierParCles(departs, ordre);
+    m_connexions.resize(connexions.size());
+    for (std::size_t i = 0; i < ordre.size(); ++i) m_connexions[i] = connexions[ordre[i]];
+
+    m_transferts = p_donnees.getGrapheTransferts().fermeture(p_marcheMax);
+    m_arrivees.assign(m_nbStations, INFINI);
+    m_parents.resize(m_nbStations);
+    m_embarquements.resize(m_voyages.size());
+}
+
+void PlanificateurCSA::vider()
+{
+    m_nbStations = 0;
+    m_connexions.clear();
+    m_voyages.clear();
+    m_transferts.vider();
+    m_arrivees.clear();
+    m_parents.clear();
+    m_embarquements.clear();
+}
+
+/*!
+ * \brief l'itinéraire qui arrive le plus tôt à p_vers en partant de p_de à p_depart
+ * \return un itinéraire dont existe est false si p_vers n'est pas atteignable
+ * \throws logic_error si p_de ou p_vers n'est pas une station du réseau
+ */
+Itineraire PlanificateurCSA::trouver(std::uint32_t p_de, std::uint32_t p_vers, const Heure &p_depart)
+{
+    if (p_de >= m_nbStations || p_vers >= m_nbStations)
+    {
+        throw std::logic_error("PlanificateurCSA::trouver(): station hors borne");
+    }
+    std::fill(m_arrivees.begin(), m_arrivees.end(), INFINI);
+    Embarquement absent = {AUCUN, 0};
+    std::fill(m_embarquements.begin(), m_embarquements.end(), absent);
+
+    std::uint32_t depart = p_depart.getCode();
+    m_arrivees[p_de] = depart;
+    m_parents[p_de] = Parent{p_de, AUCUN, depart};
+    marcher(p_de, p_vers);
+
+    auto premiere = std::lower_bound(m_connexions.begin(), m_connexions.end(), depart,
+                                     [](const Connexion &p_connexion, std::uint32_t p_code) {
+                                         return p_connexion.depart < p_code;
+                                     });
+    for (auto it = premiere; it != m_connexions.end(); ++it)
+    {
+        const Connexion &connexion = *it;
+        if (connexion.depart >= m_arrivees[p_vers]) break;
+        Embarquement &embarquement = m_embarquements[connexion.voyage];
+        if (embarquement.station == AUCUN)
+        {
+            if (m_arrivees[connexion.de] > connexion.depart) continue;
+            embarquement.station = connexion.de;
+            embarquement.depart = connexion.depart;
+        }
+        if (connexion.arrivee >= m_arrivees[connexion.vers]) continue;
+        m_arrivees[connexion.vers] = connexion.arrivee;
+        m_parents[connexion.vers] = Parent{embarquement.station, m_voyages[connexion.voyage], embarquement.depart};
+        marcher(connexion.vers, p_vers);
+    }
+    return reconstituer(p_de, p_vers, p_depart);
+}
+
+//! \brief le nombre de connexions: les paires d'arrêts consécutifs des voyages
+std::size_t PlanificateurCSA::nbConnexions() const
+{
+    return m_connexions.size();
+}
+
+//! \brief borne des identifiants de stations acceptés par trouver()
+std::uint32_t PlanificateurCSA::nbStations() const
+{
+    return m_nbStations;
+}
+
+//! \brief les connexions, par départ croissant
+const std::vector<Connexion> &PlanificateurCSA::getConnexions() const
+{
+    return m_connexions;
+}
+
+//! \brief l'identifiant dense du trip_id de chaque rang de voyage de Connexion::voyage
+const std::vector<std::uint32_t> &PlanificateurCSA::getVoyages() const
+{
+    return m_voyages;
+}
+
+const GrapheTransferts &PlanificateurCSA::getTransferts() const
+{
+    return m_transferts;
+}
+
+/*!
+ * \brief les transferts de la fermeture à partir de p_station, à son heure d'arrivée, jusqu'au premier qui
+ * n'arrive pas avant p_vers. Les connexions qui partent des stations atteintes à pied n'ont pas encore été
+ * balayées, puisque ces arrivées suivent l'arrivée de la connexion courante
+ */
+void PlanificateurCSA::marcher(std::uint32_t p_station, std::uint32_t p_vers)
+{
+    std::uint32_t depart = m_arrivees[p_station];
+    for (const Transfert &transfert : m_transferts.plage(p_station))
+    {
+        std::uint32_t arrivee = depart + transfert.temps;
+        if (arrivee >= m_arrivees[p_vers]) break; //les suivants durent plus longtemps
+        if (arrivee >= m_arrivees[transfert.vers]) continue;
+        m_arrivees[transfert.vers] = arrivee;
+        m_parents[transfert.vers] = Parent{p_station, AUCUN, depart};
+    }
+}
+
+//! \brief remonte les étapes de p_vers jusqu'à p_de
+Itineraire PlanificateurCSA::reconstituer(std::uint32_t p_de, std::uint32_t p_vers, const Heure &p_depart) const
+{
+    Itineraire itineraire;
+    itineraire.depart = p_depart;
+    if (m_arrivees[p_vers] == INFINI) return itineraire;
+    itineraire.existe = true;
+    itineraire.arrivee = Heure::depuisCode(m_arrivees[p_vers]);
+    for (std::uint32_t station = p_vers; station != p_de;)
+    {
+        const Parent &parent = m_parents[station];
+        Etape etape = {parent.voyage, parent.de, station, Heure::depuisCode(parent.depart),
+                       Heure::depuisCode(m_arrivees[station])};
+        itineraire.etapes.push_back(etape);
+        station = parent.de;
+    }
+    std::reverse(itineraire.etapes.begin(), itineraire.etapes.end());
+    return itineraire;
+}
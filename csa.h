@@ -0,0 +1,94 @@
+//
+// Planificateur d'itinéraires CSA: arrivée la plus tôt, par un seul balayage des connexions triées par départ.
+//
+
+#ifndef RTC_CSA_H
+#define RTC_CSA_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "auxiliaires.h"
+#include "graphetransferts.h"
+#include "itineraire.h"
+
+class DonneesGTFS;
+
+const std::uint32_t MARCHE_MAX_CSA = 20 * 60; //en secondes, durée maximale d'une suite de transferts enchaînés
+
+/*!
+ * \struct Connexion
+ * \brief Le trajet d'un voyage entre deux arrêts consécutifs
+ */
+struct Connexion
+{
+    std::uint32_t de;      //identifiants denses des stations
+    std::uint32_t vers;
+    std::uint32_t depart;  //codes des heures, en secondes depuis 00h00m00s
+    std::uint32_t arrivee;
+    std::uint32_t voyage;  //rang du voyage dans PlanificateurCSA::getVoyages()
+};
+
+/*!
+ * \class PlanificateurCSA
+ * \brief Répond aux requêtes «partir de la station A à l'heure t pour aller à la station B» par l'algorithme CSA
+ * (Connection Scan Algorithm)
+ *
+ *  Toutes les connexions sont rangées dans un seul tableau, par heure de départ croissante (à départ égal, dans
+ *  l'ordre des arrêts de chaque voyage). Une requête cherche par dichotomie la première connexion qui part à
+ *  l'heure demandée ou après, puis balaie le tableau en séquence jusqu'à ce que les départs dépassent la meilleure
+ *  arrivée à destination: une connexion est prise si l'on est déjà à bord de son voyage, ou si l'on est à sa
+ *  station de départ à temps. Les transferts partent de chaque station dont l'arrivée est améliorée par une
+ *  connexion, et de l'origine. Ils sont tirés de la fermeture des transferts (GrapheTransferts::fermeture()),
+ *  calculée une fois par construire(): chaque transfert du réseau y est gardé, quelle que soit sa durée, et un seul
+ *  transfert de la fermeture couvre une suite de transferts enchaînés qui ne dure pas plus que le p_marcheMax de
+ *  construire(). Une suite plus longue entre deux voyages n'est pas trouvée.
+ *
+ *  Comme PlanificateurRaptor, le planificateur est une photographie de DonneesGTFS et garde ses tableaux de travail
+ *  d'une requête à l'autre: un planificateur par fil. Le nombre de transferts n'est pas borné.
+ */
+class PlanificateurCSA
+{
+public:
+    PlanificateurCSA();
+
+    void construire(const DonneesGTFS &p_donnees, std::uint32_t p_marcheMax = MARCHE_MAX_CSA);
+    void vider();
+    Itineraire trouver(std::uint32_t p_de, std::uint32_t p_vers, const Heure &p_depart);
+
+    std::size_t nbConnexions() const;
+    std::uint32_t nbStations() const;
+    const std::vector<Connexion> &getConnexions() const;
+    const std::vector<std::uint32_t> &getVoyages() const;
+    const GrapheTransferts &getTransferts() const;
+
+private:
+    struct Parent
+    {
+        std::uint32_t de;     //station où commence la dernière étape
+        std::uint32_t voyage; //identifiant dense du trip_id; TableIdentifiants::ABSENT pour un transfert à pied
+        std::uint32_t depart; //code de l'heure de départ de l'étape
+    };
+
+    struct Embarquement
+    {
+        std::uint32_t station; //TableIdentifiants::ABSENT tant que le voyage n'est pas atteint
+        std::uint32_t depart;
+    };
+
+    void marcher(std::uint32_t p_station, std::uint32_t p_vers);
+    Itineraire reconstituer(std::uint32_t p_de, std::uint32_t p_vers, const Heure &p_depart) const;
+
+    //Le réseau, construit par construire()
+    std::uint32_t m_nbStations;
+    std::vector<Connexion> m_connexions; //par départ croissant
+    std::vector<std::uint32_t> m_voyages; //identifiant dense du trip_id de chaque rang de voyage
+    GrapheTransferts m_transferts; //la fermeture de ceux de DonneesGTFS
+
+    //Les tableaux de travail des requêtes
+    std::vector<std::uint32_t> m_arrivees;         //par station
+    std::vector<Parent> m_parents;                 //par station
+    std::vector<Embarquement> m_embarquements;     //par rang de voyage
+};
+
+#endif //RTC_CSA_H
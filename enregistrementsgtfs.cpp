@@ -0,0 +1,47 @@
+//
+// Schémas typés des enregistrements des fichiers GTFS.
+//
+
+#include "enregistrementsgtfs.h"
+
+const ColonneSchema<EnregistrementLigne> EnregistrementLigne::colonnes[] = {
+        RTC_COLONNE(EnregistrementLigne, "route_id", ligneId, true),
+        RTC_COLONNE(EnregistrementLigne, "route_short_name", numero, true),
+        RTC_COLONNE(EnregistrementLigne, "route_desc", description, false),
+        RTC_COLONNE(EnregistrementLigne, "route_color", couleur, false)};
+const std::size_t EnregistrementLigne::nbColonnes = sizeof(colonnes) / sizeof(colonnes[0]);
+
+const ColonneSchema<EnregistrementStation> EnregistrementStation::colonnes[] = {
+        RTC_COLONNE(EnregistrementStation, "stop_id", stationId, true),
+        RTC_COLONNE(EnregistrementStation, "stop_name", nom, true),
+        RTC_COLONNE(EnregistrementStation, "stop_desc", description, false),
+        RTC_COLONNE(EnregistrementStation, "stop_lat", latitude, true),
+        RTC_COLONNE(EnregistrementStation, "stop_lon", longitude, true)};
+const std::size_t EnregistrementStation::nbColonnes = sizeof(colonnes) / sizeof(colonnes[0]);
+
+const ColonneSchema<EnregistrementService> EnregistrementService::colonnes[] = {
+        RTC_COLONNE(EnregistrementService, "service_id", serviceId, true),
+        RTC_COLONNE(EnregistrementService, "date", date, true),
+        RTC_COLONNE(EnregistrementService, "exception_type", typeException, true)};
+const std::size_t EnregistrementService::nbColonnes = sizeof(colonnes) / sizeof(colonnes[0]);
+
+const ColonneSchema<EnregistrementVoyage> EnregistrementVoyage::colonnes[] = {
+        RTC_COLONNE(EnregistrementVoyage, "route_id", ligneId, true),
+        RTC_COLONNE(EnregistrementVoyage, "service_id", serviceId, true),
+        RTC_COLONNE(EnregistrementVoyage, "trip_id", voyageId, true),
+        RTC_COLONNE(EnregistrementVoyage, "trip_headsign", destination, false)};
+const std::size_t EnregistrementVoyage::nbColonnes = sizeof(colonnes) / sizeof(colonnes[0]);
+
+const ColonneSchema<EnregistrementArret> EnregistrementArret::colonnes[] = {
+        RTC_COLONNE_PREFILTRE(EnregistrementArret, "trip_id", voyageId, true),
+        RTC_COLONNE_PREFILTRE(EnregistrementArret, "arrival_time", heureArrivee, true),
+        RTC_COLONNE_PREFILTRE(EnregistrementArret, "departure_time", heureDepart, true),
+        RTC_COLONNE(EnregistrementArret, "stop_id", stationId, true),
+        RTC_COLONNE(EnregistrementArret, "stop_sequence", numeroSequence, true)};
+const std::size_t EnregistrementArret::nbColonnes = sizeof(colonnes) / sizeof(colonnes[0]);
+
+const ColonneSchema<EnregistrementTransfert> EnregistrementTransfert::colonnes[] = {
+        RTC_COLONNE(EnregistrementTransfert, "from_stop_id", deStationId, true),
+        RTC_COLONNE(EnregistrementTransfert, "to_stop_id", versStationId, true),
+        RTC_COLONNE(EnregistrementTransfert, "min_transfer_time", tempsMinimal, false)};
+const std::size_t EnregistrementTransfert::nbColonnes = sizeof(colonnes) / sizeof(colonnes[0]);
@@ -0,0 +1,308 @@
+//
+// Schémas typés des enregistrements des fichiers GTFS.
+//
+
+#ifndef RTC_ENREGISTREMENTSGTFS_H
+#define RTC_ENREGISTREMENTSGTFS_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+
+#include "lecteurcsv.h"
+#include "auxiliaires.h"
+
+//! \brief conversions d'un champ vers le type d'un membre d'enregistrement
+inline void convertirChamp(const Champ &p_champ, Champ &p_membre) { p_membre = p_champ; }
+inline void convertirChamp(const Champ &p_champ, unsigned int &p_membre) { p_membre = champVersEntier(p_champ); }
+inline void convertirChamp(const Champ &p_champ, double &p_membre) { p_membre = champVersReel(p_champ); }
+inline void convertirChamp(const Champ &p_champ, Heure &p_membre) { p_membre = champVersHeure(p_champ); }
+inline void convertirChamp(const Champ &p_champ, Date &p_membre) { p_membre = champVersDate(p_champ); }
+
+/*!
+ * \struct ColonneSchema
+ * \brief Décrit une colonne d'un fichier GTFS: son nom dans l'en-tête et le membre de l'enregistrement qui la reçoit
+ * \note Une colonne facultative doit être associée à un membre de type Champ: elle vaut un champ vide si elle est absente
+ * \note Les colonnes du préfiltre sont décodées avant les autres, pour qu'un filtre puisse rejeter la ligne
+ * sans que le reste soit converti (voir LecteurEnregistrements::lire)
+ */
+template<typename T>
+struct ColonneSchema
+{
+    const char *nom;
+    bool obligatoire;
+    bool prefiltre;
+    void (*affecter)(T &, const Champ &);
+};
+
+template<typename T, typename M, M T::*membre>
+void affecterMembre(T &p_enregistrement, const Champ &p_champ)
+{
+    convertirChamp(p_champ, p_enregistrement.*membre);
+}
+
+//! \brief déclare une entrée de ColonneSchema<Type> qui reçoit la colonne nom dans Type::membre
+#define RTC_COLONNE(Type, nom, membre, obligatoire) \
+    { nom, obligatoire, false, &affecterMembre<Type, decltype(Type::membre), &Type::membre> }
+
+//! \brief comme RTC_COLONNE, pour une colonne du préfiltre
+#define RTC_COLONNE_PREFILTRE(Type, nom, membre, obligatoire) \
+    { nom, obligatoire, true, &affecterMembre<Type, decltype(Type::membre), &Type::membre> }
+
+//! \brief routes.txt
+struct EnregistrementLigne
+{
+    Champ ligneId;
+    Champ numero;
+    Champ description;
+    Champ couleur;
+
+    static const ColonneSchema<EnregistrementLigne> colonnes[];
+    static const std::size_t nbColonnes;
+};
+
+//! \brief stops.txt
+struct EnregistrementStation
+{
+    Champ stationId;
+    Champ nom;
+    Champ description;
+    double latitude;
+    double longitude;
+
+    static const ColonneSchema<EnregistrementStation> colonnes[];
+    static const std::size_t nbColonnes;
+};
+
+//! \brief calendar_dates.txt
+struct EnregistrementService
+{
+    Champ serviceId;
+    Date date;
+    unsigned int typeException;
+
+    static const ColonneSchema<EnregistrementService> colonnes[];
+    static const std::size_t nbColonnes;
+};
+
+//! \brief trips.txt
+struct EnregistrementVoyage
+{
+    Champ ligneId;
+    Champ serviceId;
+    Champ voyageId;
+    Champ destination;
+
+    static const ColonneSchema<EnregistrementVoyage> colonnes[];
+    static const std::size_t nbColonnes;
+};
+
+//! \brief stop_times.txt
+struct EnregistrementArret
+{
+    Champ voyageId;
+    Heure heureArrivee;
+    Heure heureDepart;
+    Champ stationId;
+    unsigned int numeroSequence;
+
+    static const ColonneSchema<EnregistrementArret> colonnes[];
+    static const std::size_t nbColonnes;
+};
+
+//! \brief transfers.txt
+struct EnregistrementTransfert
+{
+    Champ deStationId;
+    Champ versStationId;
+    Champ tempsMinimal; //facultatif: min_transfer_time peut être vide
+
+    static const ColonneSchema<EnregistrementTransfert> colonnes[];
+    static const std::size_t nbColonnes;
+};
+
+/*!
+ * \class LecteurEnregistrements
+ * \brief Lit les enregistrements typés T d'un tampon CSV dont la première ligne est l'en-tête
+ *
+ *  L'en-tête est lu une seule fois pour associer chaque colonne du fichier à une entrée de T::colonnes, quel que soit
+ *  l'ordre des colonnes. Pour chaque ligne, seules les colonnes projetées sont converties; la lecture de la ligne
+ *  s'arrête après la dernière colonne utile et le reste est sauté sans être converti.
+ *  Avec un filtre, les colonnes du préfiltre sont décodées en premier; les autres colonnes déjà rencontrées sont
+ *  gardées comme de simples vues. Une ligne rejetée par le filtre est sautée sans que le reste soit découpé ni converti.
+ *  Un lecteur peut aussi être construit sur un morceau du même fichier en réutilisant la projection d'un lecteur
+ *  existant: c'est ce qui permet de lire les différents morceaux d'un fichier en parallèle.
+ */
+template<typename T>
+class LecteurEnregistrements
+{
+public:
+    LecteurEnregistrements(const char *p_debut, const char *p_fin);
+    LecteurEnregistrements(const LecteurEnregistrements &p_entete, const char *p_debut, const char *p_fin);
+
+    bool lire(T &p_enregistrement);
+    template<typename Filtre>
+    bool lire(T &p_enregistrement, Filtre &p_filtre);
+    const char *position() const;
+
+private:
+    struct AucunFiltre
+    {
+        bool operator()(const T &) const { return true; }
+    };
+
+    void affecterAbsente(T &p_enregistrement, const ColonneSchema<T> &p_colonne) const;
+
+    LecteurCSV m_lecteur;
+    std::vector<const ColonneSchema<T> *> m_projection; //par position dans le fichier; nullptr si la colonne est ignorée
+    std::vector<const ColonneSchema<T> *> m_absentes;   //colonnes facultatives absentes de l'en-tête
+    std::size_t m_finPrefiltre;  //position suivant la dernière colonne du préfiltre (0 s'il n'y en a pas)
+    std::vector<Champ> m_differes; //colonnes hors préfiltre rencontrées avant m_finPrefiltre, converties après le filtre
+};
+
+/*!
+ * \brief Lit l'en-tête du tampon et construit la projection des colonnes
+ * \param[in] p_debut: le premier caractère du tampon
+ * \param[in] p_fin: la position suivant le dernier caractère du tampon
+ * \throws logic_error si une colonne obligatoire de T est absente de l'en-tête
+ */
+template<typename T>
+LecteurEnregistrements<T>::LecteurEnregistrements(const char *p_debut, const char *p_fin)
+        : m_lecteur(p_debut, p_fin), m_finPrefiltre(0)
+{
+    std::vector<Champ> entete;
+    m_lecteur.lireEntete(entete);
+
+    std::size_t nbUtiles = 0;
+    m_projection.assign(entete.size(), nullptr);
+    for (std::size_t c = 0; c < T::nbColonnes; ++c)
+    {
+        const ColonneSchema<T> &colonne = T::colonnes[c];
+        std::size_t i = 0;
+        while (i < entete.size() && !(entete[i] == colonne.nom)) ++i;
+        if (i < entete.size())
+        {
+            m_projection[i] = &colonne;
+            if (i + 1 > nbUtiles) nbUtiles = i + 1;
+            if (colonne.prefiltre && i + 1 > m_finPrefiltre) m_finPrefiltre = i + 1;
+        }
+        else if (colonne.obligatoire)
+            throw std::logic_error(std::string("LecteurEnregistrements: colonne ") + colonne.nom + " absente de l'en-tête");
+        else
+            m_absentes.push_back(&colonne);
+    }
+    m_projection.resize(nbUtiles);
+    m_differes.resize(m_finPrefiltre);
+}
+
+/*!
+ * \brief Construit un lecteur sur un morceau sans en-tête, avec la projection de p_entete
+ * \param[in] p_entete: un lecteur construit sur le début du même fichier
+ * \param[in] p_debut: le début du morceau (en début de ligne)
+ * \param[in] p_fin: la fin du morceau
+ */
+template<typename T>
+LecteurEnregistrements<T>::LecteurEnregistrements(const LecteurEnregistrements &p_entete, const char *p_debut,
+                                                  const char *p_fin)
+        : m_lecteur(p_debut, p_fin), m_projection(p_entete.m_projection), m_absentes(p_entete.m_absentes),
+          m_finPrefiltre(p_entete.m_finPrefiltre), m_differes(p_entete.m_differes.size())
+{
+}
+
+//! \brief retourne la position du début de la prochaine ligne (juste après l'en-tête si rien n'a encore été lu)
+template<typename T>
+const char *LecteurEnregistrements<T>::position() const
+{
+    return m_lecteur.position();
+}
+
+/*!
+ * \brief lit le prochain enregistrement
+ * \param[out] p_enregistrement: l'enregistrement dont les membres projetés sont assignés
+ * \return false s'il n'y a plus d'enregistrement
+ * \throws logic_error si une colonne obligatoire manque à la ligne ou ne peut être convertie
+ */
+template<typename T>
+bool LecteurEnregistrements<T>::lire(T &p_enregistrement)
+{
+    AucunFiltre filtre;
+    return lire(p_enregistrement, filtre);
+}
+
+/*!
+ * \brief lit le prochain enregistrement accepté par p_filtre
+ * \param[out] p_enregistrement: l'enregistrement dont les membres projetés sont assignés
+ * \param[in] p_filtre: appelé avec l'enregistrement dont seules les colonnes du préfiltre sont assignées;
+ * retourne false pour rejeter la ligne
+ * \return false s'il n'y a plus d'enregistrement accepté
+ * \throws logic_error si une colonne obligatoire manque à la ligne ou ne peut être convertie
+ */
+template<typename T>
+template<typename Filtre>
+bool LecteurEnregistrements<T>::lire(T &p_enregistrement, Filtre &p_filtre)
+{
+    for (;;)
+    {
+        if (!m_lecteur.debutLigne()) return false;
+        for (std::size_t k = 0; k < m_absentes.size(); ++k) m_absentes[k]->affecter(p_enregistrement, Champ());
+
+        //étape 1: les colonnes du préfiltre; les autres colonnes rencontrées sont gardées sans être converties
+        Champ champ;
+        std::size_t nbLus = 0;
+        while (nbLus < m_finPrefiltre && m_lecteur.champSuivant(champ))
+        {
+            const ColonneSchema<T> *colonne = m_projection[nbLus];
+            if (colonne != nullptr)
+            {
+                if (colonne->prefiltre) colonne->affecter(p_enregistrement, champ);
+                else m_differes[nbLus] = champ;
+            }
+            ++nbLus;
+        }
+        for (std::size_t i = nbLus; i < m_finPrefiltre; ++i)
+        {
+            if (m_projection[i] != nullptr && m_projection[i]->prefiltre) affecterAbsente(p_enregistrement, *m_projection[i]);
+        }
+
+        if (!p_filtre(static_cast<const T &>(p_enregistrement)))
+        {
+            m_lecteur.finLigne();
+            continue;
+        }
+
+        //étape 2: le reste de la ligne
+        for (std::size_t i = 0; i < nbLus; ++i)
+        {
+            if (m_projection[i] != nullptr && !m_projection[i]->prefiltre)
+                m_projection[i]->affecter(p_enregistrement, m_differes[i]);
+        }
+        std::size_t i = nbLus;
+        if (nbLus == m_finPrefiltre)
+        {
+            for (; i < m_projection.size() && m_lecteur.champSuivant(champ); ++i)
+            {
+                if (m_projection[i] != nullptr) m_projection[i]->affecter(p_enregistrement, champ);
+            }
+        }
+        for (; i < m_projection.size(); ++i)
+        {
+            if (m_projection[i] != nullptr && !m_projection[i]->prefiltre) affecterAbsente(p_enregistrement, *m_projection[i]);
+        }
+
+        m_lecteur.finLigne();
+        return true;
+    }
+}
+
+//! \brief assigne une colonne manquante à la ligne courante
+//! \throws logic_error si la colonne est obligatoire
+template<typename T>
+void LecteurEnregistrements<T>::affecterAbsente(T &p_enregistrement, const ColonneSchema<T> &p_colonne) const
+{
+    if (p_colonne.obligatoire)
+        throw std::logic_error(std::string("LecteurEnregistrements: colonne ") + p_colonne.nom + " manquante");
+    p_colonne.affecter(p_enregistrement, Champ());
+}
+
+#endif //RTC_ENREGISTREMENTSGTFS_H
@@ -0,0 +1,170 @@
+//
+// Graphe des transferts entre stations, en listes d'adjacence compressées.
+//
+
+#include "graphetransferts.h"
+#include <stdexcept>
+#include <algorithm>
+
+GrapheTransferts::GrapheTransferts() : m_borne(0xffffffff)
+{
+}
+
+/*!
+ * \brief reconstruit le graphe à partir des transferts <from_station, to_station, min_transfer_time>
+ * \param[in] p_transferts: les transferts, dans l'ordre du fichier; cet ordre est conservé pour chaque station
+ * \param[in] p_nbStations: borne des identifiants de stations
+ * \throws logic_error si un transfert désigne une station >= p_nbStations
+ */
+void GrapheTransferts::construire(
+        const std::vector<std::tuple<std::uint32_t, std::uint32_t, unsigned int> > &p_transferts,
+        std::uint32_t p_nbStations)
+{
+    m_borne = 0xffffffff;
+    m_prolongements.clear();
+    m_debuts.assign(static_cast<std::size_t>(p_nbStations) + 1, 0);
+    for (const auto &transfert : p_transferts)
+    {
+        if (std::get<0>(transfert) >= p_nbStations || std::get<1>(transfert) >= p_nbStations)
+        {
+            throw std::logic_error("GrapheTransferts::construire(): station hors borne");
+        }
+        ++m_debuts[std::get<0>(transfert) + 1];
+    }
+    for (std::uint32_t s = 0; s < p_nbStations; ++s) m_debuts[s + 1] += m_debuts[s];
+
+    std::vector<std::uint32_t> positions(m_debuts.begin(), m_debuts.end() - 1);
+    m_transferts.resize(p_transferts.size());
+    for (const auto &transfert : p_transferts)
+    {
+        Transfert &t = m_transferts[positions[std::get<0>(transfert)]++];
+        t.vers = std::get<1>(transfert);
+        t.temps = std::get<2>(transfert);
+    }
+}
+
+void GrapheTransferts::vider()
+{
+    m_transferts.clear();
+    m_debuts.clear();
+    m_borne = 0xffffffff;
+    m_prolongements.clear();
+}
+
+//! \brief les transferts sortants de p_station; une plage vide pour une station hors borne
+PlageTransferts GrapheTransferts::plage(std::uint32_t p_station) const
+{
+    PlageTransferts plage;
+    if (p_station >= nbStations()) return plage;
+    std::uint32_t debut = m_debuts[p_station];
+    plage.nombre = m_debuts[p_station + 1] - debut;
+    if (plage.nombre != 0) plage.transferts = m_transferts.data() + debut;
+    return plage;
+}
+
+//! \brief le nombre de transferts
+std::size_t GrapheTransferts::taille() const
+{
+    return m_transferts.size();
+}
+
+std::uint32_t GrapheTransferts::nbStations() const
+{
+    return m_debuts.empty() ? 0 : static_cast<std::uint32_t>(m_debuts.size() - 1);
+}
+
+/*!
+ * \brief la fermeture transitive du graphe, bornée: de chaque station s, un transfert vers chaque autre station
+ * atteinte par des transferts enchaînés d'au plus p_dureeMax secondes au total, avec la durée du plus court. Les
+ * transferts du graphe y sont tous, même ceux qui durent plus longtemps, sauf si un enchaînement est plus court
+ * \brief Les transferts de chaque station y sont rangés par durée croissante: un balayage qui ne retient que les
+ * arrivées avant une borne peut s'arrêter au premier transfert qui la dépasse
+ * \brief Un enchaînement plus long que p_dureeMax n'y est pas: une station atteinte par un transfert d'au moins
+ * prolongement() secondes doit être à son tour le départ de ses transferts (voir aussi borne())
+ * \param[in] p_dureeMax: la durée maximale, en secondes, d'une suite de transferts enchaînés
+ */
+GrapheTransferts GrapheTransferts::fermeture(std::uint32_t p_dureeMax) const
+{
+    const std::uint32_t infini = 0xffffffff;
+    std::uint32_t borne = p_dureeMax < infini ? p_dureeMax + 1 : infini;
+    std::vector<std::uint32_t> durees(nbStations(), infini);
+    std::vector<EntreeTas> tas;
+    std::vector<EntreeTas> atteintes; //(durée, station) depuis la station courante
+    std::vector<std::tuple<std::uint32_t, std::uint32_t, unsigned int> > transferts;
+    for (std::uint32_t s = 0; s < nbStations(); ++s)
+    {
+        if (plage(s).empty()) continue;
+        atteintes.clear();
+        durees[s] = 0;
+        tas.assign(1, EntreeTas(0, s));
+        enchainer(durees.data(), tas, borne, [&](std::uint32_t p_atteinte, std::uint32_t, std::uint32_t) {
+            atteintes.push_back(EntreeTas(0, p_atteinte));
+        });
+        //les transferts directs plus longs que la borne sont gardés
+        for (const Transfert &transfert : plage(s))
+        {
+            if (transfert.temps >= durees[transfert.vers]) continue;
+            durees[transfert.vers] = transfert.temps;
+            atteintes.push_back(EntreeTas(0, transfert.vers));
+        }
+        //une station améliorée plusieurs fois est notée plusieurs fois: ses doublons prennent la même durée
+        for (EntreeTas &atteinte : atteintes) atteinte.first = durees[atteinte.second];
+        for (const EntreeTas &atteinte : atteintes) durees[atteinte.second] = infini;
+        durees[s] = infini;
+        std::sort(atteintes.begin(), atteintes.end());
+        atteintes.erase(std::unique(atteintes.begin(), atteintes.end()), atteintes.end());
+        for (const EntreeTas &atteinte : atteintes)
+        {
+            transferts.push_back(std::make_tuple(s, atteinte.second, atteinte.first));
+        }
+    }
+
+    GrapheTransferts resultat;
+    resultat.construire(transferts, nbStations());
+    resultat.m_borne = p_dureeMax;
+
+    // Un enchaînement qui passe par s après une durée d ne manque à la fermeture que si d plus le plus long
+    // transfert sortant de s dépasse p_dureeMax
+    resultat.m_prolongements.assign(nbStations(), infini);
+    for (std::uint32_t s = 0; s < nbStations(); ++s)
+    {
+        std::uint32_t plusLong = 0;
+        for (const Transfert &transfert : plage(s)) plusLong = std::max(plusLong, transfert.temps);
+        if (plusLong == 0) continue;
+        resultat.m_prolongements[s] = plusLong > p_dureeMax ? 0 : p_dureeMax - plusLong + 1;
+    }
+    return resultat;
+}
+
+/*!
+ * \brief pour une fermeture, la durée d'un transfert vers p_station à partir de laquelle p_station doit à son tour
+ * être le départ de ses transferts: un enchaînement plus long que la borne de fermeture() peut alors la prolonger
+ * \brief Relâcher ainsi les stations atteintes par un tel transfert, et toutes celles atteintes autrement (par un
+ * voyage, ou l'origine), donne les mêmes arrivées que des transferts enchaînés sans borne
+ * \return 0xffffffff pour une station sans transfert sortant, ou si le graphe n'est pas une fermeture
+ */
+std::uint32_t GrapheTransferts::prolongement(std::uint32_t p_station) const
+{
+    return p_station < m_prolongements.size() ? m_prolongements[p_station] : 0xffffffff;
+}
+
+/*!
+ * \brief pour une fermeture, la durée maximale des enchaînements qu'elle couvre (le p_dureeMax de fermeture())
+ * \brief Une station atteinte par un transfert de t secondes qui part à son tour n'a besoin que de ses transferts
+ * de plus de borne() - t secondes: les autres prolongent un enchaînement que la fermeture couvre déjà
+ * \return 0xffffffff si le graphe n'est pas une fermeture
+ */
+std::uint32_t GrapheTransferts::borne() const
+{
+    return m_borne;
+}
+
+const std::vector<Transfert> &GrapheTransferts::getTransferts() const
+{
+    return m_transferts;
+}
+
+const std::vector<std::uint32_t> &GrapheTransferts::getDebuts() const
+{
+    return m_debuts;
+}
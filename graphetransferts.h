@@ -0,0 +1,131 @@
+//
+// Graphe des transferts entre stations, en listes d'adjacence compressées.
+//
+
+#ifndef RTC_GRAPHETRANSFERTS_H
+#define RTC_GRAPHETRANSFERTS_H
+
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+/*!
+ * \struct Transfert
+ * \brief Un transfert sortant d'une station: la station d'arrivée et le temps minimal, rangés côte à côte
+ */
+struct Transfert
+{
+    std::uint32_t vers;  //identifiant dense du to_stop_id
+    std::uint32_t temps; //min_transfer_time, en secondes
+};
+
+/*!
+ * \struct PlageTransferts
+ * \brief Les transferts sortants d'une station: une tranche contiguë de GrapheTransferts, dans l'ordre du fichier
+ * \note Les pointeurs sont valides jusqu'à la prochaine construction du graphe
+ */
+struct PlageTransferts
+{
+    PlageTransferts() : transferts(nullptr), nombre(0) {}
+
+    const Transfert *transferts;
+    std::size_t nombre;
+
+    std::size_t size() const
+    {
+        return nombre;
+    }
+
+    bool empty() const
+    {
+        return nombre == 0;
+    }
+
+    const Transfert *begin() const
+    {
+        return transferts;
+    }
+
+    const Transfert *end() const
+    {
+        return transferts + nombre;
+    }
+};
+
+typedef std::pair<std::uint32_t, std::uint32_t> EntreeTas; //(arrivée, station) du tas de GrapheTransferts::enchainer()
+
+/*!
+ * \class GrapheTransferts
+ * \brief Pour chaque station, ses transferts sortants: les transferts de la station s occupent les positions
+ * [getDebuts()[s], getDebuts()[s + 1]) de getTransferts()
+ *
+ *  Le graphe est compilé d'un coup, par un tri par dénombrement stable des transferts selon leur station de départ;
+ *  énumérer les transferts d'une station parcourt une tranche contiguë, sans consulter les autres.
+ */
+class GrapheTransferts
+{
+public:
+    GrapheTransferts();
+
+    void construire(const std::vector<std::tuple<std::uint32_t, std::uint32_t, unsigned int> > &p_transferts,
+                    std::uint32_t p_nbStations);
+    void vider();
+    PlageTransferts plage(std::uint32_t p_station) const;
+    std::size_t taille() const;
+    std::uint32_t nbStations() const;
+    GrapheTransferts fermeture(std::uint32_t p_dureeMax) const;
+    std::uint32_t prolongement(std::uint32_t p_station) const;
+    std::uint32_t borne() const;
+
+    template<typename Noter>
+    void enchainer(std::uint32_t *p_arrivees, std::vector<EntreeTas> &p_tas, const std::uint32_t &p_borne,
+                   Noter p_noter) const;
+
+    const std::vector<Transfert> &getTransferts() const;
+    const std::vector<std::uint32_t> &getDebuts() const;
+
+private:
+    std::vector<Transfert> m_transferts;
+    std::vector<std::uint32_t> m_debuts;        //nbStations() + 1 positions
+    std::uint32_t m_borne;                      //le p_dureeMax d'une fermeture, 0xffffffff sinon
+    std::vector<std::uint32_t> m_prolongements; //par station, pour une fermeture seulement (voir prolongement())
+};
+
+/*!
+ * \brief enchaîne les transferts à partir des stations de p_tas: un Dijkstra sur le graphe, qui abaisse p_arrivees
+ * \param[in,out] p_arrivees: l'arrivée de chaque station; une arrivée améliorée y est écrite avant d'être notée
+ * \param[in,out] p_tas: les (p_arrivees[s], s) des stations de départ, dans n'importe quel ordre; vide au retour
+ * \param[in] p_borne: aucune arrivée égale ou postérieure n'est retenue; elle est relue à chaque transfert, de sorte
+ * qu'elle peut être un élément de p_arrivees (la destination) ou une variable que p_noter abaisse
+ * \param[in] p_noter: appelé comme p_noter(vers, de, depart) pour chaque amélioration de p_arrivees[vers] par un
+ * transfert qui part de la station de à son arrivée depart
+ */
+template<typename Noter>
+void GrapheTransferts::enchainer(std::uint32_t *p_arrivees, std::vector<EntreeTas> &p_tas,
+                                 const std::uint32_t &p_borne, Noter p_noter) const
+{
+    std::make_heap(p_tas.begin(), p_tas.end(), std::greater<EntreeTas>());
+    while (!p_tas.empty())
+    {
+        std::pop_heap(p_tas.begin(), p_tas.end(), std::greater<EntreeTas>());
+        EntreeTas entree = p_tas.back();
+        p_tas.pop_back();
+        std::uint32_t station = entree.second;
+        if (entree.first != p_arrivees[station]) continue; //déjà améliorée depuis
+        for (const Transfert &transfert : plage(station))
+        {
+            std::uint32_t arrivee = entree.first + transfert.temps;
+            if (arrivee >= p_arrivees[transfert.vers] || arrivee >= p_borne) continue;
+            p_arrivees[transfert.vers] = arrivee;
+            p_noter(transfert.vers, station, entree.first);
+            p_tas.push_back(EntreeTas(arrivee, transfert.vers));
+            std::push_heap(p_tas.begin(), p_tas.end(), std::greater<EntreeTas>());
+        }
+    }
+}
+
+#endif //RTC_GRAPHETRANSFERTS_H
@@ -0,0 +1,415 @@
+//
+// Horaire complet d'un dossier GTFS, chargé une seule fois pour toutes les dates et tous les intervalles.
+//
+
+#include "horaire.h"
+#include "DonneesGTFS.h"
+#include "enregistrementsgtfs.h"
+#include "parallele.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+    //! taille minimale (en octets) d'un morceau de stop_times.txt lu par un fil
+    const std::size_t TAILLE_MIN_MORCEAU_ARRETS = 1 << 20;
+
+    //! arrêts lus par un fil; les stations absentes de stops.txt sont gardées à part jusqu'à la fusion
+    struct MorceauArrets
+    {
+        std::vector<ArretHoraire> arrets;
+        std::vector<std::pair<std::size_t, std::string> > stationsInconnues; //<position dans arrets, stop_id>
+    };
+}
+
+HoraireGTFS::HoraireGTFS() : m_attenteMax(0)
+{
+}
+
+/*!
+ * \brief charge tout le dossier GTFS: lignes, stations, services de toutes les dates, voyages de tous les services,
+ * tous leurs arrêts et les transferts, puis indexe les arrêts par service et heure de départ
+ * \param[in] p_dossier: le dossier contenant routes.txt, stops.txt, calendar_dates.txt, trips.txt, stop_times.txt
+ * et transfers.txt
+ * \throws logic_error si un problème survient avec la lecture d'un fichier
+ */
+void HoraireGTFS::charger(const std::string &p_dossier)
+{
+    // Les lignes et les stations ne dépendent pas de la date: on réutilise le chargement de DonneesGTFS
+    DonneesGTFS tampon{Date(), Heure(), Heure()};
+    tampon.ajouterLignes(p_dossier + "/routes.txt");
+    tampon.ajouterStations(p_dossier + "/stops.txt");
+    m_idsLignes = tampon.getIdsLignes();
+    m_lignes = tampon.getLignes();
+    m_lignes_par_numero = tampon.getLignesParNumero();
+
+    // Toutes les stations de stops.txt sont présentes dans le tampon: l'identifiant d'une station est son indice
+    m_idsStations = tampon.getIdsStations();
+    m_stations.clear();
+    for (const auto &station : tampon.getStations()) m_stations.push_back(station.second);
+
+    chargerServices(p_dossier + "/calendar_dates.txt");
+    chargerVoyages(p_dossier + "/trips.txt");
+    chargerArrets(p_dossier + "/stop_times.txt");
+    indexerArrets();
+    chargerTransferts(p_dossier + "/transfers.txt");
+}
+
+//! \brief lit les services de toutes les dates (exception_type == 1) dans m_servicesParDate
+//! \param[in] p_nomFichier: le nom du fichier contenant les services
+//! \throws logic_error si un problème survient avec la lecture du fichier
+void HoraireGTFS::chargerServices(const std::string &p_nomFichier)
+{
+    FichierMappe fichier(p_nomFichier);
+    if (!fichier.estOuvert())
+    {
+        throw std::logic_error("Erreur lors de l'ouverture du fichier de services.");
+    }
+
+    m_services.vider();
+    m_servicesParDate.clear();
+
+    LecteurEnregistrements<EnregistrementService> lecteur(fichier.debut(), fichier.fin());
+    EnregistrementService enregistrement;
+    while (lecteur.lire(enregistrement))
+    {
+        if (enregistrement.typeException == 1)
+        {
+            std::vector<std::uint32_t> &services = m_servicesParDate[enregistrement.date.getCode()];
+            std::uint32_t indice = m_services.interner(enregistrement.serviceId);
+            if (std::find(services.begin(), services.end(), indice) == services.end())
+            {
+                services.push_back(indice);
+            }
+        }
+    }
+}
+
+//! \brief lit les voyages de tous les services
+//! \param[in] p_nomFichier: le nom du fichier contenant les voyages
+//! \throws logic_error si un problème survient avec la lecture du fichier
+void HoraireGTFS::chargerVoyages(const std::string &p_nomFichier)
+{
+    FichierMappe fichier(p_nomFichier);
+    if (!fichier.estOuvert())
+    {
+        throw std::logic_error("Erreur lors de l'ouverture du fichier des voyages.");
+    }
+
+    m_voyages.clear();
+    m_idsVoyages.vider();
+
+    LecteurEnregistrements<EnregistrementVoyage> lecteur(fichier.debut(), fichier.fin());
+    EnregistrementVoyage enregistrement;
+    while (lecteur.lire(enregistrement))
+    {
+        // Comme dans DonneesGTFS::ajouterVoyagesDeLaDate(), un trip_id répété remplace le voyage précédent
+        std::uint32_t id = m_idsVoyages.interner(enregistrement.voyageId);
+        Voyage voyage(id, m_idsLignes.interner(enregistrement.ligneId), m_services.interner(enregistrement.serviceId),
+                      enregistrement.destination.str());
+        if (id == m_voyages.size())
+        {
+            m_voyages.push_back(voyage);
+        }
+        else
+        {
+            m_voyages[id] = voyage;
+        }
+    }
+}
+
+//! \brief lit tous les arrêts des voyages de trips.txt, en parallèle sur des morceaux alignés sur les lignes
+//! \param[in] p_nomFichier: le nom du fichier contenant les arrets
+//! \throws logic_error si un problème survient avec la lecture du fichier
+void HoraireGTFS::chargerArrets(const std::string &p_nomFichier)
+{
+    FichierMappe fichier(p_nomFichier);
+    if (!fichier.estOuvert())
+    {
+        throw std::logic_error("Impossible d'ouvrir le fichier contenant les arrêts");
+    }
+
+    LecteurEnregistrements<EnregistrementArret> entete(fichier.debut(), fichier.fin());
+    std::size_t nbMorceaux = std::min<std::size_t>(nbFilsDisponibles(),
+                                                   1 + fichier.taille() / TAILLE_MIN_MORCEAU_ARRETS);
+    std::vector<const char *> bornes = decouperSurLignes(entete.position(), fichier.fin(), nbMorceaux);
+    std::vector<MorceauArrets> morceaux(bornes.size() - 1);
+
+    executerEnParallele(morceaux.size(), [&](std::size_t k) {
+        LecteurEnregistrements<EnregistrementArret> lecteur(entete, bornes[k], bornes[k + 1]);
+        EnregistrementArret enregistrement;
+        MorceauArrets &morceau = morceaux[k];
+
+        // Seul le voyage est filtré: un arrêt d'un voyage absent de trips.txt n'est jamais retenu
+        std::uint32_t voyage = 0;
+        auto filtre = [&](const EnregistrementArret &p_arret) -> bool {
+            voyage = m_idsVoyages.trouver(p_arret.voyageId);
+            return voyage != TableIdentifiants::ABSENT;
+        };
+
+        while (lecteur.lire(enregistrement, filtre))
+        {
+            ArretHoraire arret;
+            arret.voyage = voyage;
+            arret.station = 0;
+            arret.arrivee = enregistrement.heureArrivee.getCode();
+            arret.depart = enregistrement.heureDepart.getCode();
+            arret.sequence = enregistrement.numeroSequence;
+
+            arret.station = m_idsStations.trouver(enregistrement.stationId);
+            if (arret.station == TableIdentifiants::ABSENT)
+            {
+                morceau.stationsInconnues.push_back(std::make_pair(morceau.arrets.size(),
+                                                                   enregistrement.stationId.str()));
+            }
+            morceau.arrets.push_back(arret);
+        }
+    });
+
+    // Fusion dans l'ordre du fichier; les stations inconnues reçoivent leur indice ici, dans l'ordre de leur apparition
+    std::size_t nbArrets = 0;
+    for (const auto &morceau : morceaux) nbArrets += morceau.arrets.size();
+    m_arrets.clear();
+    m_arrets.reserve(nbArrets);
+    for (auto &morceau : morceaux)
+    {
+        for (const auto &inconnue : morceau.stationsInconnues)
+        {
+            morceau.arrets[inconnue.first].station = m_idsStations.interner(inconnue.second);
+        }
+        m_arrets.insert(m_arrets.end(), morceau.arrets.begin(), morceau.arrets.end());
+    }
+}
+
+//! \brief construit l'index des arrêts par service, trié par heure de départ
+void HoraireGTFS::indexerArrets()
+{
+    const std::size_t nbServices = m_services.taille();
+    m_debutsServices.assign(nbServices + 1, 0);
+    m_attenteMax = 0;
+    for (const auto &arret : m_arrets)
+    {
+        ++m_debutsServices[m_voyages[arret.voyage].getServiceId() + 1];
+        if (arret.depart > arret.arrivee) m_attenteMax = std::max(m_attenteMax, arret.depart - arret.arrivee);
+    }
+    for (std::size_t s = 0; s < nbServices; ++s) m_debutsServices[s + 1] += m_debutsServices[s];
+
+    std::vector<std::uint32_t> prochain(m_debutsServices.begin(), m_debutsServices.end() - 1);
+    m_arretsParDepart.resize(m_arrets.size());
+    for (std::uint32_t i = 0; i < m_arrets.size(); ++i)
+    {
+        m_arretsParDepart[prochain[m_voyages[m_arrets[i].voyage].getServiceId()]++] = i;
+    }
+
+    executerEnParallele(nbServices, [&](std::size_t s) {
+        std::sort(m_arretsParDepart.begin() + m_debutsServices[s], m_arretsParDepart.begin() + m_debutsServices[s + 1],
+                  [&](std::uint32_t a, std::uint32_t b) {
+                      return m_arrets[a].depart < m_arrets[b].depart
+                             || (m_arrets[a].depart == m_arrets[b].depart && a < b);
+                  });
+    });
+}
+
+//! \brief lit les transferts dont les deux stations sont dans stops.txt
+//! \param[in] p_nomFichier: le nom du fichier contenant les transferts
+//! \throws logic_error si un problème survient avec la lecture du fichier
+void HoraireGTFS::chargerTransferts(const std::string &p_nomFichier)
+{
+    FichierMappe fichier(p_nomFichier);
+    if (!fichier.estOuvert())
+    {
+        throw std::logic_error("Erreur lors de l'ouverture du fichier de transferts.");
+    }
+
+    m_transferts.clear();
+
+    LecteurEnregistrements<EnregistrementTransfert> lecteur(fichier.debut(), fichier.fin());
+    EnregistrementTransfert enregistrement;
+    string deStationId;
+    string versStationId;
+    while (lecteur.lire(enregistrement))
+    {
+        if (enregistrement.tempsMinimal.empty()) continue;
+
+        enregistrement.deStationId.copierDans(deStationId);
+        enregistrement.versStationId.copierDans(versStationId);
+        std::uint32_t de = m_idsStations.trouver(deStationId);
+        std::uint32_t vers = m_idsStations.trouver(versStationId);
+        if (de < m_stations.size() && vers < m_stations.size())
+        {
+            TransfertHoraire transfert;
+            transfert.de = de;
+            transfert.vers = vers;
+            transfert.temps = champVersEntier(enregistrement.tempsMinimal);
+            m_transferts.push_back(transfert);
+        }
+    }
+}
+
+/*!
+ * \brief donne les services offerts à une date
+ * \param[in] p_date: la date d'intérêt
+ * \return les indices des services dans getServices()
+ */
+std::vector<std::uint32_t> HoraireGTFS::servicesDeLaDate(const Date &p_date) const
+{
+    auto itr = m_servicesParDate.find(p_date.getCode());
+    return itr == m_servicesParDate.end() ? std::vector<std::uint32_t>() : itr->second;
+}
+
+/*!
+ * \brief donne les arrêts des voyages de la date dont l'heure de départ est >= now1 et l'heure d'arrivée est < now2
+ * \brief Pour chaque service de la date, la recherche commence au premier départ >= now1 et s'arrête au premier départ
+ * >= now2 + m_attenteMax, après lequel aucune arrivée ne peut précéder now2
+ * \param[in] p_date: la date d'intérêt
+ * \param[in] p_now1: le début de l'intervalle
+ * \param[in] p_now2: la fin de l'intervalle (exclue)
+ * \param[out] p_arrets: les indices des arrêts dans getArrets(), dans l'ordre du fichier
+ */
+void HoraireGTFS::arretsDeLaFenetre(const Date &p_date, const Heure &p_now1, const Heure &p_now2,
+                                    std::vector<std::uint32_t> &p_arrets) const
+{
+    p_arrets.clear();
+    const std::uint32_t now1 = p_now1.getCode();
+    const std::uint32_t now2 = p_now2.getCode();
+    const std::uint64_t borne = static_cast<std::uint64_t>(now2) + m_attenteMax;
+
+    for (std::uint32_t s : servicesDeLaDate(p_date))
+    {
+        auto fin = m_arretsParDepart.begin() + m_debutsServices[s + 1];
+        auto itr = std::lower_bound(m_arretsParDepart.begin() + m_debutsServices[s], fin, now1,
+                                    [&](std::uint32_t p_arret, std::uint32_t p_heure) {
+                                        return m_arrets[p_arret].depart < p_heure;
+                                    });
+        for (; itr != fin && m_arrets[*itr].depart < borne; ++itr)
+        {
+            if (m_arrets[*itr].arrivee < now2) p_arrets.push_back(*itr);
+        }
+    }
+    std::sort(p_arrets.begin(), p_arrets.end());
+}
+
+const Registre<Ligne> &HoraireGTFS::getLignes() const
+{
+    return m_lignes;
+}
+
+const TableIdentifiants &HoraireGTFS::getIdsLignes() const
+{
+    return m_idsLignes;
+}
+
+const std::multimap<std::string, Ligne> &HoraireGTFS::getLignesParNumero() const
+{
+    return m_lignes_par_numero;
+}
+
+const std::vector<Station> &HoraireGTFS::getStations() const
+{
+    return m_stations;
+}
+
+const TableIdentifiants &HoraireGTFS::getIdsStations() const
+{
+    return m_idsStations;
+}
+
+const TableIdentifiants &HoraireGTFS::getServices() const
+{
+    return m_services;
+}
+
+const std::vector<Voyage> &HoraireGTFS::getVoyages() const
+{
+    return m_voyages;
+}
+
+const TableIdentifiants &HoraireGTFS::getIdsVoyages() const
+{
+    return m_idsVoyages;
+}
+
+const std::vector<ArretHoraire> &HoraireGTFS::getArrets() const
+{
+    return m_arrets;
+}
+
+const std::vector<TransfertHoraire> &HoraireGTFS::getTransferts() const
+{
+    return m_transferts;
+}
+
+/*!
+ * \brief remplit l'objet avec les lignes, stations, services, voyages, arrêts et transferts de sa date et de son
+ * intervalle [now1, now2), à partir d'un horaire déjà chargé et sans relire les fichiers
+ * \brief Le résultat est identique à celui des méthodes ajouter* appelées sur les fichiers de l'horaire
+ * \param[in] p_horaire: l'horaire complet du dossier GTFS
+ * \post assigne m_tousLesArretsPresents à true
+ */
+void DonneesGTFS::chargerDepuisHoraire(const HoraireGTFS &p_horaire)
+{
+    // Les tables des lignes, des stations et des services sont reprises telles quelles: les identifiants de
+    // l'horaire restent valides. Seuls les voyages de la fenêtre sont internés, à leur premier arrêt
+    m_etatRechargement = EtatRechargement();
+    m_idsLignes = p_horaire.getIdsLignes();
+    m_idsStations = p_horaire.getIdsStations();
+    m_idsServices = p_horaire.getServices();
+    m_idsVoyages.vider();
+    m_lignes = p_horaire.getLignes();
+    m_lignes_par_numero = p_horaire.getLignesParNumero();
+    m_stations.clear();
+    m_services.clear();
+    m_voyages.clear();
+    m_transferts.clear();
+    m_stationsDeTransfert.clear();
+    m_grapheTransferts.vider();
+    m_arrets.vider();
+    m_nbArrets = 0;
+    m_statistiquesArrets = StatistiquesArrets();
+
+    for (std::uint32_t s : p_horaire.servicesDeLaDate(m_date))
+    {
+        m_services.ajouter(s);
+    }
+
+    std::vector<std::uint32_t> indices;
+    p_horaire.arretsDeLaFenetre(m_date, m_now1, m_now2, indices);
+    m_arrets.reserver(indices.size());
+
+    // Les voyages et les stations ne sont créés qu'à leur premier arrêt: ceux sans arrêt n'apparaissent jamais
+    const std::vector<Voyage> &voyages = p_horaire.getVoyages();
+    const std::vector<Station> &stations = p_horaire.getStations();
+    std::vector<std::uint32_t> voyageDe(voyages.size(), TableIdentifiants::ABSENT);
+    for (std::uint32_t i : indices)
+    {
+        const ArretHoraire &a = p_horaire.getArrets()[i];
+        std::uint32_t &voyage = voyageDe[a.voyage];
+        if (voyage == TableIdentifiants::ABSENT)
+        {
+            const Voyage &v = voyages[a.voyage];
+            voyage = m_idsVoyages.interner(p_horaire.getIdsVoyages().chaine(a.voyage));
+            m_voyages.inserer(voyage, Voyage(voyage, v.getLigne(), v.getServiceId(), v.getDestination()));
+        }
+
+        m_arrets.creer(a.station, Heure::depuisCode(a.arrivee), Heure::depuisCode(a.depart), a.sequence, voyage);
+        if (a.station < stations.size() && !m_stations.contient(a.station))
+        {
+            m_stations.inserer(a.station, stations[a.station]);
+        }
+        ++m_nbArrets;
+    }
+    indexerArrets();
+    m_tousLesArretsPresents = true;
+
+    for (const auto &transfert : p_horaire.getTransferts())
+    {
+        if (m_stations.contient(transfert.de) && m_stations.contient(transfert.vers))
+        {
+            m_transferts.push_back(std::make_tuple(transfert.de, transfert.vers, transfert.temps));
+            m_stationsDeTransfert.ajouter(transfert.de);
+        }
+    }
+    indexerTransferts();
+    appliquerTrajetsAPied();
+}
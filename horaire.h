@@ -0,0 +1,101 @@
+//
+// Horaire complet d'un dossier GTFS, chargé une seule fois pour toutes les dates et tous les intervalles.
+//
+
+#ifndef RTC_HORAIRE_H
+#define RTC_HORAIRE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+
+#include "auxiliaires.h"
+#include "ligne.h"
+#include "station.h"
+#include "voyage.h"
+#include "identifiants.h"
+
+/*!
+ * \struct ArretHoraire
+ * \brief Un arrêt de stop_times.txt sous forme compacte: indices de voyage et de station, heures encodées en secondes
+ */
+struct ArretHoraire
+{
+    std::uint32_t voyage;  //identifiant dans HoraireGTFS::getIdsVoyages(), indice dans getVoyages()
+    std::uint32_t station; //identifiant dans HoraireGTFS::getIdsStations(); >= getStations().size() si absente de stops.txt
+    std::uint32_t arrivee;
+    std::uint32_t depart;
+    std::uint32_t sequence;
+};
+
+/*!
+ * \struct TransfertHoraire
+ * \brief Un transfert de transfers.txt entre deux stations de stops.txt
+ */
+struct TransfertHoraire
+{
+    std::uint32_t de;
+    std::uint32_t vers;
+    unsigned int temps;
+};
+
+/*!
+ * \class HoraireGTFS
+ * \brief Tous les services, voyages et arrêts d'un dossier GTFS, indexés pour répondre à n'importe quelle date et
+ * n'importe quel intervalle [now1, now2) sans relire les fichiers.
+ *
+ *  Les arrêts sont gardés dans l'ordre du fichier. Pour chaque service, un index trie les arrêts par heure de départ:
+ *  les arrêts d'un intervalle se trouvent par recherche dichotomique dans les services de la date.
+ *  DonneesGTFS::chargerDepuisHoraire() construit à partir de cet index le même contenu que les méthodes ajouter*.
+ */
+class HoraireGTFS
+{
+public:
+    HoraireGTFS();
+    void charger(const std::string &p_dossier);
+
+    std::vector<std::uint32_t> servicesDeLaDate(const Date &p_date) const;
+    void arretsDeLaFenetre(const Date &p_date, const Heure &p_now1, const Heure &p_now2,
+                           std::vector<std::uint32_t> &p_arrets) const;
+
+    const Registre<Ligne> &getLignes() const;
+    const TableIdentifiants &getIdsLignes() const;
+    const std::multimap<std::string, Ligne> &getLignesParNumero() const;
+    const std::vector<Station> &getStations() const;
+    const TableIdentifiants &getIdsStations() const;
+    const TableIdentifiants &getServices() const;
+    const std::vector<Voyage> &getVoyages() const;
+    const TableIdentifiants &getIdsVoyages() const;
+    const std::vector<ArretHoraire> &getArrets() const;
+    const std::vector<TransfertHoraire> &getTransferts() const;
+
+private:
+    void chargerServices(const std::string &p_nomFichier);
+    void chargerVoyages(const std::string &p_nomFichier);
+    void chargerArrets(const std::string &p_nomFichier);
+    void chargerTransferts(const std::string &p_nomFichier);
+    void indexerArrets();
+
+    TableIdentifiants m_idsLignes;
+    Registre<Ligne> m_lignes;
+    std::multimap<std::string, Ligne> m_lignes_par_numero;
+    std::vector<Station> m_stations; //sans arrêts, dans l'ordre de leurs identifiants
+    TableIdentifiants m_idsStations; //celles de m_stations, puis les stations de stop_times.txt absentes de stops.txt
+
+    TableIdentifiants m_services;
+    std::map<int, std::vector<std::uint32_t> > m_servicesParDate; //la clé est le code de la date
+
+    std::vector<Voyage> m_voyages; //sans arrêts, indexés par identifiant; Voyage::getServiceId() est dans m_services
+    TableIdentifiants m_idsVoyages;
+
+    std::vector<ArretHoraire> m_arrets; //dans l'ordre du fichier
+    std::vector<std::uint32_t> m_debutsServices; //m_arretsParDepart[m_debutsServices[s], m_debutsServices[s + 1]): service s
+    std::vector<std::uint32_t> m_arretsParDepart; //indices dans m_arrets, triés par (service, départ)
+    std::uint32_t m_attenteMax; //plus grand écart départ - arrivée d'un arrêt, pour borner la recherche par départ
+
+    std::vector<TransfertHoraire> m_transferts;
+};
+
+#endif //RTC_HORAIRE_H
@@ -0,0 +1,270 @@
+//
+// Identifiants entiers denses des stations, voyages, lignes et services, attribués une seule fois au chargement.
+//
+
+#include "identifiants.h"
+#include "lecteurcsv.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+const std::uint32_t TableIdentifiants::ABSENT = 0xffffffff;
+
+EnsembleIdentifiants::EnsembleIdentifiants() : m_nombre(0)
+{
+}
+
+bool EnsembleIdentifiants::contient(std::uint32_t p_id) const
+{
+    return p_id < m_presents.size() && m_presents[p_id];
+}
+
+//! \brief ajoute un identifiant
+//! \return false s'il était déjà présent
+bool EnsembleIdentifiants::ajouter(std::uint32_t p_id)
+{
+    if (p_id >= m_presents.size()) m_presents.resize(static_cast<std::size_t>(p_id) + 1, false);
+    if (m_presents[p_id]) return false;
+    m_presents[p_id] = true;
+    ++m_nombre;
+    return true;
+}
+
+//! \brief retire un identifiant
+//! \return false s'il était absent
+bool EnsembleIdentifiants::retirer(std::uint32_t p_id)
+{
+    if (!contient(p_id)) return false;
+    m_presents[p_id] = false;
+    --m_nombre;
+    return true;
+}
+
+std::size_t EnsembleIdentifiants::size() const
+{
+    return m_nombre;
+}
+
+bool EnsembleIdentifiants::empty() const
+{
+    return m_nombre == 0;
+}
+
+void EnsembleIdentifiants::clear()
+{
+    m_presents.clear();
+    m_nombre = 0;
+}
+
+//! \brief tous les identifiants présents sont < borne()
+std::uint32_t EnsembleIdentifiants::borne() const
+{
+    return static_cast<std::uint32_t>(m_presents.size());
+}
+
+namespace
+{
+    const std::size_t TAILLE_GROUPE = 16;
+    const std::int8_t VIDE = -128; //les octets de contrôle des cases pleines sont dans [0, 127]
+
+    //! \brief empreinte de 64 bits d'une chaîne, lue par mots de 8 octets
+    std::uint64_t hacher(const char *p_debut, std::size_t p_taille)
+    {
+        const std::uint64_t multiplicateur = 0x9e3779b97f4a7c15ull;
+        std::uint64_t h = p_taille * multiplicateur;
+        for (; p_taille >= 8; p_debut += 8, p_taille -= 8)
+        {
+            std::uint64_t mot;
+            std::memcpy(&mot, p_debut, 8);
+            h = (h ^ mot) * multiplicateur;
+            h ^= h >> 29;
+        }
+        if (p_taille != 0)
+        {
+            std::uint64_t mot = 0;
+            std::memcpy(&mot, p_debut, p_taille);
+            h = (h ^ mot) * multiplicateur;
+        }
+        h ^= h >> 32;
+        h *= multiplicateur;
+        return h ^ (h >> 29);
+    }
+
+    //! \brief masque des cases d'un groupe dont l'octet de contrôle vaut p_octet (bit i pour la case i)
+    inline std::uint32_t correspondances(const std::int8_t *p_groupe, std::int8_t p_octet)
+    {
+#if defined(__SSE2__)
+        __m128i groupe = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_groupe));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(groupe, _mm_set1_epi8(p_octet))));
+#else
+        std::uint32_t masque = 0;
+        for (std::size_t i = 0; i < TAILLE_GROUPE; ++i)
+        {
+            if (p_groupe[i] == p_octet) masque |= 1u << i;
+        }
+        return masque;
+#endif
+    }
+
+    inline unsigned int premierBit(std::uint32_t p_masque)
+    {
+#if defined(__GNUC__)
+        return static_cast<unsigned int>(__builtin_ctz(p_masque));
+#else
+        unsigned int i = 0;
+        while ((p_masque & 1) == 0)
+        {
+            p_masque >>= 1;
+            ++i;
+        }
+        return i;
+#endif
+    }
+
+    inline std::int8_t controleDe(std::uint64_t p_empreinte)
+    {
+        return static_cast<std::int8_t>(p_empreinte & 0x7f);
+    }
+}
+
+/*!
+ * \brief donne l'identifiant d'une chaîne, en lui en attribuant un nouveau à sa première apparition
+ * \param[in] p_debut, p_taille: l'identifiant GTFS (stop_id, trip_id, route_id ou service_id)
+ * \return l'identifiant dense, < taille()
+ * \throws logic_error si la table est pleine
+ */
+std::uint32_t TableIdentifiants::interner(const char *p_debut, std::size_t p_taille)
+{
+    std::uint32_t id = trouver(p_debut, p_taille);
+    if (id != ABSENT) return id;
+    if (m_chaines.size() >= ABSENT) throw std::logic_error("TableIdentifiants::interner(): table pleine");
+
+    // Les cases restent pleines à au plus 7/8
+    if (8 * (m_chaines.size() + 1) > 7 * m_cases.size())
+    {
+        agrandir(m_cases.empty() ? 2 * TAILLE_GROUPE : 2 * m_cases.size());
+    }
+    id = static_cast<std::uint32_t>(m_chaines.size());
+    std::uint64_t empreinte = hacher(p_debut, p_taille);
+    m_chaines.push_back(std::string(p_debut, p_taille));
+    m_empreintes.push_back(empreinte);
+    placer(empreinte, id);
+    return id;
+}
+
+std::uint32_t TableIdentifiants::interner(const std::string &p_chaine)
+{
+    return interner(p_chaine.data(), p_chaine.size());
+}
+
+//! \brief comme interner(const std::string &), sans copier le champ s'il n'a pas de guillemets échappés
+std::uint32_t TableIdentifiants::interner(const Champ &p_champ)
+{
+    return p_champ.estContigu() ? interner(p_champ.data(), p_champ.size()) : interner(p_champ.str());
+}
+
+/*!
+ * \brief donne l'identifiant d'une chaîne sans modifier la table; plusieurs fils peuvent l'appeler en même temps
+ *
+ *  Les groupes sont visités par pas croissants (1, 2, 3...), ce qui les parcourt tous puisque leur nombre
+ *  est une puissance de 2; un groupe qui contient une case vide termine la recherche
+ * \return ABSENT si la chaîne n'a jamais été internée
+ */
+std::uint32_t TableIdentifiants::trouver(const char *p_debut, std::size_t p_taille) const
+{
+    if (m_cases.empty()) return ABSENT;
+    std::uint64_t empreinte = hacher(p_debut, p_taille);
+    std::int8_t controle = controleDe(empreinte);
+    std::size_t masqueGroupes = m_cases.size() / TAILLE_GROUPE - 1;
+    std::size_t groupe = static_cast<std::size_t>(empreinte >> 7) & masqueGroupes;
+    for (std::size_t pas = 1;; ++pas)
+    {
+        const std::int8_t *controles = &m_controles[groupe * TAILLE_GROUPE];
+        for (std::uint32_t candidats = correspondances(controles, controle); candidats != 0; candidats &= candidats - 1)
+        {
+            std::uint32_t id = m_cases[groupe * TAILLE_GROUPE + premierBit(candidats)];
+            const std::string &chaine = m_chaines[id];
+            if (chaine.size() == p_taille && std::memcmp(chaine.data(), p_debut, p_taille) == 0) return id;
+        }
+        if (correspondances(controles, VIDE) != 0) return ABSENT;
+        groupe = (groupe + pas) & masqueGroupes;
+    }
+}
+
+std::uint32_t TableIdentifiants::trouver(const std::string &p_chaine) const
+{
+    return trouver(p_chaine.data(), p_chaine.size());
+}
+
+//! \brief comme trouver(const std::string &), sans copier le champ s'il n'a pas de guillemets échappés
+std::uint32_t TableIdentifiants::trouver(const Champ &p_champ) const
+{
+    return p_champ.estContigu() ? trouver(p_champ.data(), p_champ.size()) : trouver(p_champ.str());
+}
+
+//! \pre p_id < taille()
+const std::string &TableIdentifiants::chaine(std::uint32_t p_id) const
+{
+    return m_chaines[p_id];
+}
+
+std::size_t TableIdentifiants::taille() const
+{
+    return m_chaines.size();
+}
+
+//! \brief oublie toutes les chaînes; les identifiants déjà distribués ne sont plus valides
+void TableIdentifiants::vider()
+{
+    m_chaines.clear();
+    m_empreintes.clear();
+    m_controles.clear();
+    m_cases.clear();
+}
+
+//! \brief range p_id dans la première case vide de sa suite de groupes
+void TableIdentifiants::placer(std::uint64_t p_empreinte, std::uint32_t p_id)
+{
+    std::size_t masqueGroupes = m_cases.size() / TAILLE_GROUPE - 1;
+    std::size_t groupe = static_cast<std::size_t>(p_empreinte >> 7) & masqueGroupes;
+    for (std::size_t pas = 1;; ++pas)
+    {
+        std::uint32_t vides = correspondances(&m_controles[groupe * TAILLE_GROUPE], VIDE);
+        if (vides != 0)
+        {
+            std::size_t position = groupe * TAILLE_GROUPE + premierBit(vides);
+            m_controles[position] = controleDe(p_empreinte);
+            m_cases[position] = p_id;
+            return;
+        }
+        groupe = (groupe + pas) & masqueGroupes;
+    }
+}
+
+//! \brief reconstruit les cases à partir des empreintes mémorisées
+//! \param[in] p_nbCases: une puissance de 2, multiple de TAILLE_GROUPE
+void TableIdentifiants::agrandir(std::size_t p_nbCases)
+{
+    m_controles.assign(p_nbCases, VIDE);
+    m_cases.assign(p_nbCases, 0);
+    for (std::uint32_t id = 0; id < m_chaines.size(); ++id) placer(m_empreintes[id], id);
+}
+
+//! \brief donne les identifiants d'un ensemble dans l'ordre de leurs chaînes, celui des anciennes std::map
+//! \pre tous les identifiants de p_ensemble sont < taille()
+std::vector<std::uint32_t> TableIdentifiants::trier(const EnsembleIdentifiants &p_ensemble) const
+{
+    std::vector<std::uint32_t> ids;
+    ids.reserve(p_ensemble.size());
+    for (std::uint32_t id = 0; id < p_ensemble.borne(); ++id)
+    {
+        if (p_ensemble.contient(id)) ids.push_back(id);
+    }
+    std::sort(ids.begin(), ids.end(), [this](std::uint32_t a, std::uint32_t b) {
+        return m_chaines[a] < m_chaines[b];
+    });
+    return ids;
+}
@@ -0,0 +1,218 @@
+//
+// Identifiants entiers denses des stations, voyages, lignes et services, attribués une seule fois au chargement.
+//
+
+#ifndef RTC_IDENTIFIANTS_H
+#define RTC_IDENTIFIANTS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+class Champ;
+
+/*!
+ * \class EnsembleIdentifiants
+ * \brief Ensemble d'identifiants denses, un bit par identifiant
+ */
+class EnsembleIdentifiants
+{
+public:
+    EnsembleIdentifiants();
+
+    bool contient(std::uint32_t p_id) const;
+    bool ajouter(std::uint32_t p_id);
+    bool retirer(std::uint32_t p_id);
+    std::size_t size() const;
+    bool empty() const;
+    void clear();
+    std::uint32_t borne() const;
+
+private:
+    std::vector<bool> m_presents;
+    std::size_t m_nombre;
+};
+
+/*!
+ * \class TableIdentifiants
+ * \brief Attribue à chaque chaîne (stop_id, trip_id, route_id ou service_id) un identifiant entier dense, dans l'ordre
+ * de leur première apparition
+ *
+ *  Une chaîne garde son identifiant tant que la table n'est pas vidée: les objets qui le conservent (Arret, Voyage,
+ *  transferts, EtatRechargement) restent valides d'un chargement à l'autre. Les chaînes ne servent plus qu'aux
+ *  frontières: lecture des fichiers, affichage et instantanés.
+ *
+ *  La recherche se fait dans une table à adressage ouvert, par groupes de 16 cases: un octet de contrôle par case
+ *  (vide, ou 7 bits de l'empreinte) permet de comparer tout un groupe d'un coup (SSE2) avant de comparer une seule
+ *  chaîne. Une clé se cherche directement depuis le tampon du fichier (pointeur et longueur, ou Champ), sans
+ *  construire de std::string. Aucune chaîne n'est jamais retirée: il n'y a pas de case effacée.
+ */
+class TableIdentifiants
+{
+public:
+    static const std::uint32_t ABSENT; //rendu par trouver() pour une chaîne inconnue
+
+    std::uint32_t interner(const char *p_debut, std::size_t p_taille);
+    std::uint32_t interner(const std::string &p_chaine);
+    std::uint32_t interner(const Champ &p_champ);
+    std::uint32_t trouver(const char *p_debut, std::size_t p_taille) const;
+    std::uint32_t trouver(const std::string &p_chaine) const;
+    std::uint32_t trouver(const Champ &p_champ) const;
+    const std::string &chaine(std::uint32_t p_id) const;
+    std::size_t taille() const;
+    void vider();
+    std::vector<std::uint32_t> trier(const EnsembleIdentifiants &p_ensemble) const;
+
+private:
+    void placer(std::uint64_t p_empreinte, std::uint32_t p_id);
+    void agrandir(std::size_t p_nbCases);
+
+    std::vector<std::string> m_chaines;      //indexé par identifiant
+    std::vector<std::uint64_t> m_empreintes; //indexé par identifiant; évite de rehacher les chaînes en agrandissant
+    std::vector<std::int8_t> m_controles;    //un octet par case: VIDE, ou les 7 bits de poids faible de l'empreinte
+    std::vector<std::uint32_t> m_cases;      //l'identifiant rangé dans chaque case pleine
+};
+
+/*!
+ * \class Registre
+ * \brief Objets (Station, Voyage, Ligne) indexés par leur identifiant dense
+ *
+ *  Un tableau remplace la table associative: trouver l'objet d'un identifiant est un accès indicé. Le parcours se fait
+ *  dans l'ordre des identifiants et donne des paires {first: identifiant, second: objet}, comme celui d'une std::map;
+ *  TableIdentifiants::trier() donne l'ordre des chaînes lorsqu'il importe (affichage).
+ */
+template<typename T>
+class Registre
+{
+public:
+    template<bool Constant>
+    class Iterateur
+    {
+    public:
+        typedef typename std::conditional<Constant, const Registre, Registre>::type Conteneur;
+        typedef typename std::conditional<Constant, const T, T>::type Valeur;
+
+        struct Element
+        {
+            std::uint32_t first;
+            Valeur &second;
+        };
+
+        Iterateur(Conteneur *p_registre, std::uint32_t p_id) : m_registre(p_registre), m_id(p_id)
+        {
+            avancer();
+        }
+
+        Element operator*() const
+        {
+            return Element{m_id, m_registre->m_elements[m_id]};
+        }
+
+        Iterateur &operator++()
+        {
+            ++m_id;
+            avancer();
+            return *this;
+        }
+
+        bool operator!=(const Iterateur &p_autre) const
+        {
+            return m_id != p_autre.m_id;
+        }
+
+    private:
+        void avancer()
+        {
+            while (m_id < m_registre->m_elements.size() && !m_registre->contient(m_id)) ++m_id;
+        }
+
+        Conteneur *m_registre;
+        std::uint32_t m_id;
+    };
+
+    typedef Iterateur<false> iterator;
+    typedef Iterateur<true> const_iterator;
+
+    bool contient(std::uint32_t p_id) const
+    {
+        return m_presents.contient(p_id);
+    }
+
+    //! \pre contient(p_id)
+    T &operator[](std::uint32_t p_id)
+    {
+        return m_elements[p_id];
+    }
+
+    //! \pre contient(p_id)
+    const T &operator[](std::uint32_t p_id) const
+    {
+        return m_elements[p_id];
+    }
+
+    //! \brief ajoute l'objet d'identifiant p_id, ou remplace celui qui s'y trouve
+    T &inserer(std::uint32_t p_id, const T &p_element)
+    {
+        if (p_id >= m_elements.size()) m_elements.resize(static_cast<std::size_t>(p_id) + 1);
+        m_presents.ajouter(p_id);
+        m_elements[p_id] = p_element;
+        return m_elements[p_id];
+    }
+
+    //! \brief retire l'objet d'identifiant p_id; sa case est remise à neuf pour libérer ce qu'il contient
+    bool retirer(std::uint32_t p_id)
+    {
+        if (!m_presents.retirer(p_id)) return false;
+        m_elements[p_id] = T();
+        return true;
+    }
+
+    std::size_t size() const
+    {
+        return m_presents.size();
+    }
+
+    bool empty() const
+    {
+        return m_presents.empty();
+    }
+
+    void clear()
+    {
+        m_elements.clear();
+        m_presents.clear();
+    }
+
+    const EnsembleIdentifiants &identifiants() const
+    {
+        return m_presents;
+    }
+
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    iterator end()
+    {
+        return iterator(this, static_cast<std::uint32_t>(m_elements.size()));
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, static_cast<std::uint32_t>(m_elements.size()));
+    }
+
+private:
+    std::vector<T> m_elements;
+    EnsembleIdentifiants m_presents;
+};
+
+#endif //RTC_IDENTIFIANTS_H
@@ -0,0 +1,335 @@
+//
+// Index spatial des stations: stations dans un rayon et k plus proches voisins.
+//
+
+#include "indexspatial.h"
+#include "parallele.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+const double IndexSpatial::RAYON_TERRE = 6371;
+
+namespace
+{
+    const std::size_t TAILLE_FEUILLE = 16;
+    const std::size_t NB_REQUETES_PAR_MORCEAU = 512; //requêtes d'une tâche des recherches par lots
+    const std::size_t TAILLE_PILE = 128;             //deux tranches en attente par niveau de l'arbre, au plus
+
+    const double RAD_PAR_DEGRE = 3.14159265358979323846 / 180.0;
+
+    struct Tranche
+    {
+        std::uint32_t debut;
+        std::uint32_t fin;
+        double borne; //carré de la distance minimale entre le point cherché et la tranche, selon les coupes connues
+    };
+
+    //! \brief ordre des voisins par corde (ou distance) croissante, puis par station
+    inline bool plusPres(const Voisin &p_a, const Voisin &p_b)
+    {
+        return p_a.distance < p_b.distance || (p_a.distance == p_b.distance && p_a.station < p_b.station);
+    }
+
+    //! \brief la distance à vol d'oiseau, en km, qui correspond au carré d'une corde de la sphère unité
+    inline double distanceDeCorde2(double p_corde2)
+    {
+        return 2 * IndexSpatial::RAYON_TERRE * std::asin(std::min(1.0, std::sqrt(p_corde2) / 2));
+    }
+
+    //! \brief le carré de la corde de la sphère unité qui correspond à une distance de p_rayon km
+    inline double corde2DeDistance(double p_rayon)
+    {
+        if (p_rayon >= 3.14159265358979323846 * IndexSpatial::RAYON_TERRE) return 4;
+        double corde = 2 * std::sin(p_rayon / (2 * IndexSpatial::RAYON_TERRE));
+        return corde * corde;
+    }
+
+    inline void versDistances(std::vector<Voisin> &p_voisins, std::size_t p_debut)
+    {
+        for (std::size_t i = p_debut; i < p_voisins.size(); ++i)
+        {
+            p_voisins[i].distance = distanceDeCorde2(p_voisins[i].distance);
+        }
+    }
+}
+
+IndexSpatial::IndexSpatial()
+{
+}
+
+/*!
+ * \brief reconstruit l'index avec les stations présentes de p_stations
+ * \throws logic_error s'il y a plus de stations que n'en peut désigner un entier de 32 bits
+ */
+void IndexSpatial::construire(const Registre<Station> &p_stations)
+{
+    vider();
+    std::vector<Point> points;
+    std::vector<std::uint32_t> ordre;
+    points.reserve(p_stations.size());
+    ordre.reserve(p_stations.size());
+    for (auto stationM : p_stations)
+    {
+        points.push_back(versSphere(stationM.second.getCoords()));
+        ordre.push_back(stationM.first);
+    }
+    if (points.size() >= 0xffffffff) throw std::logic_error("IndexSpatial::construire(): trop de stations");
+
+    // ordre[i] désigne d'abord la station de points[i]; on le permute en gardant les points alignés
+    std::vector<std::uint32_t> positions(points.size());
+    for (std::uint32_t i = 0; i < positions.size(); ++i) positions[i] = i;
+    m_axes.assign(points.size(), 0);
+    construireNoeud(positions, points, 0, positions.size());
+
+    m_x.resize(points.size());
+    m_y.resize(points.size());
+    m_z.resize(points.size());
+    m_stations.resize(points.size());
+    for (std::size_t i = 0; i < positions.size(); ++i)
+    {
+        const Point &point = points[positions[i]];
+        m_x[i] = point.x;
+        m_y[i] = point.y;
+        m_z[i] = point.z;
+        m_stations[i] = ordre[positions[i]];
+    }
+}
+
+void IndexSpatial::vider()
+{
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_stations.clear();
+    m_axes.clear();
+}
+
+//! \brief le nombre de stations indexées
+std::size_t IndexSpatial::taille() const
+{
+    return m_stations.size();
+}
+
+/*!
+ * \brief les stations à au plus p_rayon km de p_centre, par distance croissante (puis par station)
+ * \param[out] p_voisins: vidé puis rempli; sa capacité est réutilisée d'un appel à l'autre
+ */
+void IndexSpatial::dansRayon(const Coordonnees &p_centre, double p_rayon, std::vector<Voisin> &p_voisins) const
+{
+    p_voisins.clear();
+    if (p_rayon < 0) return;
+    chercherRayon(versSphere(p_centre), corde2DeDistance(p_rayon), p_voisins);
+    std::sort(p_voisins.begin(), p_voisins.end(), plusPres);
+    versDistances(p_voisins, 0);
+}
+
+/*!
+ * \brief les min(p_k, taille()) stations les plus proches de p_centre, par distance croissante (puis par station)
+ * \param[out] p_voisins: vidé puis rempli; sa capacité est réutilisée d'un appel à l'autre
+ */
+void IndexSpatial::plusProches(const Coordonnees &p_centre, std::size_t p_k, std::vector<Voisin> &p_voisins) const
+{
+    p_voisins.clear();
+    if (p_k == 0) return;
+    chercherProches(versSphere(p_centre), p_k, p_voisins);
+    std::sort_heap(p_voisins.begin(), p_voisins.end(), plusPres);
+    versDistances(p_voisins, 0);
+}
+
+/*!
+ * \brief dansRayon() pour plusieurs points, répartis entre les fils d'exécution
+ * \param[out] p_debuts: p_centres.size() + 1 positions; les voisins de p_centres[i] sont
+ * p_voisins[p_debuts[i]], ..., p_voisins[p_debuts[i + 1] - 1]
+ */
+void IndexSpatial::dansRayon(const std::vector<Coordonnees> &p_centres, double p_rayon,
+                             std::vector<std::uint32_t> &p_debuts, std::vector<Voisin> &p_voisins) const
+{
+    std::size_t nbMorceaux = (p_centres.size() + NB_REQUETES_PAR_MORCEAU - 1) / NB_REQUETES_PAR_MORCEAU;
+    std::vector<std::vector<Voisin> > morceaux(nbMorceaux);
+    p_debuts.assign(p_centres.size() + 1, 0);
+    double corde2Max = p_rayon < 0 ? -1 : corde2DeDistance(p_rayon);
+
+    executerEnParallele(nbMorceaux, [&](std::size_t k) {
+        std::vector<Voisin> &voisins = morceaux[k];
+        std::size_t fin = std::min(p_centres.size(), (k + 1) * NB_REQUETES_PAR_MORCEAU);
+        for (std::size_t i = k * NB_REQUETES_PAR_MORCEAU; i < fin; ++i)
+        {
+            std::size_t debut = voisins.size();
+            if (corde2Max >= 0) chercherRayon(versSphere(p_centres[i]), corde2Max, voisins);
+            std::sort(voisins.begin() + debut, voisins.end(), plusPres);
+            versDistances(voisins, debut);
+            p_debuts[i + 1] = static_cast<std::uint32_t>(voisins.size() - debut);
+        }
+    });
+
+    for (std::size_t i = 0; i < p_centres.size(); ++i) p_debuts[i + 1] += p_debuts[i];
+    p_voisins.clear();
+    p_voisins.reserve(p_debuts.back());
+    for (const auto &morceau : morceaux) p_voisins.insert(p_voisins.end(), morceau.begin(), morceau.end());
+}
+
+/*!
+ * \brief plusProches() pour plusieurs points, répartis entre les fils d'exécution
+ * \param[out] p_debuts: p_centres.size() + 1 positions; les voisins de p_centres[i] sont
+ * p_voisins[p_debuts[i]], ..., p_voisins[p_debuts[i + 1] - 1]
+ */
+void IndexSpatial::plusProches(const std::vector<Coordonnees> &p_centres, std::size_t p_k,
+                               std::vector<std::uint32_t> &p_debuts, std::vector<Voisin> &p_voisins) const
+{
+    std::size_t parCentre = std::min(p_k, taille());
+    p_debuts.resize(p_centres.size() + 1);
+    for (std::size_t i = 0; i <= p_centres.size(); ++i) p_debuts[i] = static_cast<std::uint32_t>(i * parCentre);
+    p_voisins.resize(p_centres.size() * parCentre);
+    if (parCentre == 0) return;
+
+    std::size_t nbMorceaux = (p_centres.size() + NB_REQUETES_PAR_MORCEAU - 1) / NB_REQUETES_PAR_MORCEAU;
+    executerEnParallele(nbMorceaux, [&](std::size_t k) {
+        std::vector<Voisin> voisins;
+        voisins.reserve(parCentre);
+        std::size_t fin = std::min(p_centres.size(), (k + 1) * NB_REQUETES_PAR_MORCEAU);
+        for (std::size_t i = k * NB_REQUETES_PAR_MORCEAU; i < fin; ++i)
+        {
+            voisins.clear();
+            chercherProches(versSphere(p_centres[i]), parCentre, voisins);
+            std::sort_heap(voisins.begin(), voisins.end(), plusPres);
+            versDistances(voisins, 0);
+            std::copy(voisins.begin(), voisins.end(), p_voisins.begin() + p_debuts[i]);
+        }
+    });
+}
+
+//! \brief le point de la sphère unité d'une latitude et d'une longitude
+IndexSpatial::Point IndexSpatial::versSphere(const Coordonnees &p_coords)
+{
+    double latitude = p_coords.getLatitude() * RAD_PAR_DEGRE;
+    double longitude = p_coords.getLongitude() * RAD_PAR_DEGRE;
+    Point point = {std::cos(latitude) * std::cos(longitude), std::cos(latitude) * std::sin(longitude),
+                   std::sin(latitude)};
+    return point;
+}
+
+//! \brief le carré de la corde entre p_point et la station à la position p_position de l'arbre
+inline double IndexSpatial::corde2(const Point &p_point, std::size_t p_position) const
+{
+    double dx = p_point.x - m_x[p_position];
+    double dy = p_point.y - m_y[p_position];
+    double dz = p_point.z - m_z[p_position];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+//! \brief range la tranche [p_debut, p_fin) de p_ordre: médiane au milieu selon l'axe le plus étendu, puis les
+//! deux moitiés, récursivement
+void IndexSpatial::construireNoeud(std::vector<std::uint32_t> &p_ordre, const std::vector<Point> &p_points,
+                                   std::size_t p_debut, std::size_t p_fin)
+{
+    if (p_fin - p_debut <= TAILLE_FEUILLE) return;
+
+    Point minimum = p_points[p_ordre[p_debut]], maximum = minimum;
+    for (std::size_t i = p_debut + 1; i < p_fin; ++i)
+    {
+        const Point &point = p_points[p_ordre[i]];
+        minimum.x = std::min(minimum.x, point.x);
+        minimum.y = std::min(minimum.y, point.y);
+        minimum.z = std::min(minimum.z, point.z);
+        maximum.x = std::max(maximum.x, point.x);
+        maximum.y = std::max(maximum.y, point.y);
+        maximum.z = std::max(maximum.z, point.z);
+    }
+    double etendues[3] = {maximum.x - minimum.x, maximum.y - minimum.y, maximum.z - minimum.z};
+    std::uint8_t axe = static_cast<std::uint8_t>(std::max_element(etendues, etendues + 3) - etendues);
+
+    std::size_t milieu = p_debut + (p_fin - p_debut) / 2;
+    std::nth_element(p_ordre.begin() + p_debut, p_ordre.begin() + milieu, p_ordre.begin() + p_fin,
+                     [&p_points, axe](std::uint32_t a, std::uint32_t b) {
+                         const double *pa = &p_points[a].x, *pb = &p_points[b].x;
+                         return pa[axe] < pb[axe] || (pa[axe] == pb[axe] && a < b);
+                     });
+    m_axes[milieu] = axe;
+    construireNoeud(p_ordre, p_points, p_debut, milieu);
+    construireNoeud(p_ordre, p_points, milieu + 1, p_fin);
+}
+
+//! \brief ajoute à p_voisins les stations dont la corde au carré avec p_centre est <= p_corde2Max (distance: la
+//! corde au carré), dans l'ordre de l'arbre
+void IndexSpatial::chercherRayon(const Point &p_centre, double p_corde2Max, std::vector<Voisin> &p_voisins) const
+{
+    if (m_stations.empty()) return;
+    const double *colonnes[3] = {m_x.data(), m_y.data(), m_z.data()};
+    const double centre[3] = {p_centre.x, p_centre.y, p_centre.z};
+
+    Tranche pile[TAILLE_PILE];
+    std::size_t hauteur = 0;
+    pile[hauteur++] = Tranche{0, static_cast<std::uint32_t>(m_stations.size()), 0};
+    while (hauteur != 0)
+    {
+        Tranche tranche = pile[--hauteur];
+        if (tranche.fin - tranche.debut <= TAILLE_FEUILLE)
+        {
+            for (std::uint32_t i = tranche.debut; i < tranche.fin; ++i)
+            {
+                double d = corde2(p_centre, i);
+                if (d <= p_corde2Max) p_voisins.push_back(Voisin{m_stations[i], d});
+            }
+            continue;
+        }
+        std::uint32_t milieu = tranche.debut + (tranche.fin - tranche.debut) / 2;
+        double d = corde2(p_centre, milieu);
+        if (d <= p_corde2Max) p_voisins.push_back(Voisin{m_stations[milieu], d});
+
+        std::uint8_t axe = m_axes[milieu];
+        double ecart = centre[axe] - colonnes[axe][milieu];
+        Tranche gauche = {tranche.debut, milieu, 0}, droite = {milieu + 1, tranche.fin, 0};
+        if (ecart * ecart <= p_corde2Max) pile[hauteur++] = ecart < 0 ? droite : gauche;
+        pile[hauteur++] = ecart < 0 ? gauche : droite;
+    }
+}
+
+//! \brief laisse dans p_voisins, en tas (le plus loin en tête), les min(p_k, taille()) stations les plus proches de
+//! p_centre (distance: la corde au carré)
+void IndexSpatial::chercherProches(const Point &p_centre, std::size_t p_k, std::vector<Voisin> &p_voisins) const
+{
+    if (m_stations.empty()) return;
+    const double *colonnes[3] = {m_x.data(), m_y.data(), m_z.data()};
+    const double centre[3] = {p_centre.x, p_centre.y, p_centre.z};
+
+    auto considerer = [&](std::uint32_t p_position) {
+        Voisin voisin = {m_stations[p_position], corde2(p_centre, p_position)};
+        if (p_voisins.size() < p_k)
+        {
+            p_voisins.push_back(voisin);
+            std::push_heap(p_voisins.begin(), p_voisins.end(), plusPres);
+        }
+        else if (plusPres(voisin, p_voisins.front()))
+        {
+            std::pop_heap(p_voisins.begin(), p_voisins.end(), plusPres);
+            p_voisins.back() = voisin;
+            std::push_heap(p_voisins.begin(), p_voisins.end(), plusPres);
+        }
+    };
+
+    Tranche pile[TAILLE_PILE];
+    std::size_t hauteur = 0;
+    pile[hauteur++] = Tranche{0, static_cast<std::uint32_t>(m_stations.size()), 0};
+    while (hauteur != 0)
+    {
+        Tranche tranche = pile[--hauteur];
+        if (p_voisins.size() == p_k && tranche.borne > p_voisins.front().distance) continue;
+        if (tranche.fin - tranche.debut <= TAILLE_FEUILLE)
+        {
+            for (std::uint32_t i = tranche.debut; i < tranche.fin; ++i) considerer(i);
+            continue;
+        }
+        std::uint32_t milieu = tranche.debut + (tranche.fin - tranche.debut) / 2;
+        considerer(milieu);
+
+        // La moitié du côté de p_centre est explorée d'abord; l'autre est au moins à |ecart| de p_centre
+        std::uint8_t axe = m_axes[milieu];
+        double ecart = centre[axe] - colonnes[axe][milieu];
+        double borneLoin = std::max(tranche.borne, ecart * ecart);
+        Tranche gauche = {tranche.debut, milieu, ecart < 0 ? tranche.borne : borneLoin};
+        Tranche droite = {milieu + 1, tranche.fin, ecart < 0 ? borneLoin : tranche.borne};
+        pile[hauteur++] = ecart < 0 ? droite : gauche;
+        pile[hauteur++] = ecart < 0 ? gauche : droite;
+    }
+}
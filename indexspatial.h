@@ -0,0 +1,76 @@
+//
+// Index spatial des stations: stations dans un rayon et k plus proches voisins.
+//
+
+#ifndef RTC_INDEXSPATIAL_H
+#define RTC_INDEXSPATIAL_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "coordonnees.h"
+#include "identifiants.h"
+#include "station.h"
+
+/*!
+ * \struct Voisin
+ * \brief Une station trouvée par IndexSpatial et sa distance au point cherché
+ */
+struct Voisin
+{
+    std::uint32_t station; //identifiant dense du stop_id
+    double distance;       //en km, à vol d'oiseau comme Coordonnees::operator-
+};
+
+/*!
+ * \class IndexSpatial
+ * \brief Arbre k-d compact des stations, pour les recherches par rayon et des k plus proches voisins
+ *
+ *  Chaque station est placée sur la sphère unité (x, y, z): la distance euclidienne (la corde) croît avec la distance
+ *  à vol d'oiseau, de sorte qu'une recherche n'évalue aucune fonction trigonométrique par station; seules les
+ *  stations retenues voient leur corde convertie en km. L'arbre est implicite: la station médiane d'une tranche
+ *  [debut, fin) est à sa position milieu, les deux moitiés sont les sous-arbres, et les tranches d'au plus
+ *  TAILLE_FEUILLE stations sont parcourues d'un bloc. Les coordonnées sont rangées en colonnes dans l'ordre de l'arbre.
+ *
+ *  L'index est une photographie: il se construit une fois les stations chargées, et doit être reconstruit si
+ *  elles changent (recharger(), chargerInstantane()...).
+ */
+class IndexSpatial
+{
+public:
+    IndexSpatial();
+
+    void construire(const Registre<Station> &p_stations);
+    void vider();
+    std::size_t taille() const;
+
+    void dansRayon(const Coordonnees &p_centre, double p_rayon, std::vector<Voisin> &p_voisins) const;
+    void plusProches(const Coordonnees &p_centre, std::size_t p_k, std::vector<Voisin> &p_voisins) const;
+    void dansRayon(const std::vector<Coordonnees> &p_centres, double p_rayon, std::vector<std::uint32_t> &p_debuts,
+                   std::vector<Voisin> &p_voisins) const;
+    void plusProches(const std::vector<Coordonnees> &p_centres, std::size_t p_k, std::vector<std::uint32_t> &p_debuts,
+                     std::vector<Voisin> &p_voisins) const;
+
+    static const double RAYON_TERRE; //en km, celui de Coordonnees::operator-
+
+private:
+    struct Point
+    {
+        double x, y, z;
+    };
+
+    static Point versSphere(const Coordonnees &p_coords);
+    double corde2(const Point &p_point, std::size_t p_position) const;
+    void construireNoeud(std::vector<std::uint32_t> &p_ordre, const std::vector<Point> &p_points, std::size_t p_debut,
+                         std::size_t p_fin);
+    void chercherRayon(const Point &p_centre, double p_corde2Max, std::vector<Voisin> &p_voisins) const;
+    void chercherProches(const Point &p_centre, std::size_t p_k, std::vector<Voisin> &p_voisins) const;
+
+    std::vector<double> m_x; //dans l'ordre de l'arbre
+    std::vector<double> m_y;
+    std::vector<double> m_z;
+    std::vector<std::uint32_t> m_stations;
+    std::vector<std::uint8_t> m_axes; //axe de coupe (0: x, 1: y, 2: z) du noeud dont la médiane est à cette position
+};
+
+#endif //RTC_INDEXSPATIAL_H
@@ -0,0 +1,149 @@
+//
+// Index inversé des arrêts par station, trié par heure de départ.
+//
+
+#include "indexstations.h"
+#include "parallele.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+//! \brief position du premier arrêt qui part à p_code ou plus tard; size() s'il n'y en a pas
+std::size_t PlageStation::premierDepart(std::uint32_t p_code) const
+{
+    return static_cast<std::size_t>(std::lower_bound(departs, departs + nombre, p_code) - departs);
+}
+
+/*!
+ * \brief reconstruit l'index à partir de la table des arrêts
+ * \param[in] p_table: la table des arrêts des voyages
+ * \param[in] p_nbStations: borne des identifiants de stations
+ * \throws logic_error si une rangée désigne une station >= p_nbStations
+ */
+void IndexStations::construire(const TableArrets &p_table, std::uint32_t p_nbStations)
+{
+    const std::vector<std::uint32_t> &stations = p_table.getStations();
+    const std::vector<std::uint32_t> &departs = p_table.getDeparts();
+    std::size_t n = p_table.taille();
+
+    // Deux tris stables des rangées: par départ, puis par station; le second donne l'ordre (station, départ, rangée)
+    std::vector<std::uint32_t> cles(departs);
+    m_rangees.resize(n);
+    for (std::size_t i = 0; i < n; ++i) m_rangees[i] = static_cast<std::uint32_t>(i);
+    trierParCles(cles, m_rangees);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        std::uint32_t s = stations[m_rangees[i]];
+        if (s >= p_nbStations) throw std::logic_error("IndexStations::construire(): station hors borne");
+        cles[i] = s;
+    }
+    trierParCles(cles, m_rangees);
+    m_departs.resize(n);
+    for (std::size_t i = 0; i < n; ++i) m_departs[i] = departs[m_rangees[i]];
+
+    m_debuts.assign(static_cast<std::size_t>(p_nbStations) + 1, 0);
+    for (std::uint32_t s : cles) ++m_debuts[s + 1];
+    for (std::uint32_t s = 0; s < p_nbStations; ++s) m_debuts[s + 1] += m_debuts[s];
+}
+
+/*!
+ * \brief corrige l'index après la réécriture sur place de quelques rangées de la table (TableArrets::remplacer())
+ * \brief Seules les plages des stations de ces rangées, avant ou après leur réécriture, sont triées de nouveau; le
+ * résultat est celui que construire() donnerait
+ * \param[in] p_table: la table, déjà réécrite
+ * \param[in] p_rangees: les rangées réécrites, sans doublon
+ * \param[in] p_anciennesStations: la station de chacune de ces rangées avant sa réécriture
+ * \return false (sans modifier l'index) si une station changerait de nombre d'arrêts ou serait hors borne
+ */
+bool IndexStations::corriger(const TableArrets &p_table, const std::vector<std::uint32_t> &p_rangees,
+                             const std::vector<std::uint32_t> &p_anciennesStations)
+{
+    const std::vector<std::uint32_t> &stations = p_table.getStations();
+    const std::vector<std::uint32_t> &departs = p_table.getDeparts();
+    std::unordered_map<std::uint32_t, long> ecarts; //station -> arrêts gagnés
+    for (std::size_t i = 0; i < p_rangees.size(); ++i)
+    {
+        std::uint32_t s = stations[p_rangees[i]];
+        if (s >= nbStations() || p_anciennesStations[i] >= nbStations()) return false;
+        --ecarts[p_anciennesStations[i]];
+        ++ecarts[s];
+    }
+    for (const auto &ecart : ecarts)
+    {
+        if (ecart.second != 0) return false;
+    }
+
+    // Une plage perd les rangées réécrites et reçoit celles qui désignent maintenant sa station; elle garde sa taille
+    std::unordered_set<std::uint32_t> reecrites(p_rangees.begin(), p_rangees.end());
+    std::vector<std::pair<std::uint32_t, std::uint32_t> > arrets; //(départ, rangée)
+    for (const auto &ecart : ecarts)
+    {
+        std::uint32_t s = ecart.first;
+        std::uint32_t debut = m_debuts[s];
+        std::uint32_t fin = m_debuts[s + 1];
+        arrets.clear();
+        for (std::uint32_t i = debut; i < fin; ++i)
+        {
+            if (!reecrites.count(m_rangees[i])) arrets.push_back(std::make_pair(m_departs[i], m_rangees[i]));
+        }
+        for (std::uint32_t r : p_rangees)
+        {
+            if (stations[r] == s) arrets.push_back(std::make_pair(departs[r], r));
+        }
+        std::sort(arrets.begin(), arrets.end());
+        for (std::size_t i = 0; i < arrets.size(); ++i)
+        {
+            m_departs[debut + i] = arrets[i].first;
+            m_rangees[debut + i] = arrets[i].second;
+        }
+    }
+    return true;
+}
+
+void IndexStations::vider()
+{
+    m_rangees.clear();
+    m_departs.clear();
+    m_debuts.clear();
+}
+
+//! \brief les arrêts de la station p_station; une plage vide pour une station hors borne
+PlageStation IndexStations::plage(std::uint32_t p_station) const
+{
+    PlageStation plage;
+    if (p_station >= nbStations()) return plage;
+    std::uint32_t debut = m_debuts[p_station];
+    plage.nombre = m_debuts[p_station + 1] - debut;
+    if (plage.nombre == 0) return plage;
+    plage.rangees = m_rangees.data() + debut;
+    plage.departs = m_departs.data() + debut;
+    return plage;
+}
+
+//! \brief le nombre d'arrêts indexés
+std::size_t IndexStations::taille() const
+{
+    return m_rangees.size();
+}
+
+std::uint32_t IndexStations::nbStations() const
+{
+    return m_debuts.empty() ? 0 : static_cast<std::uint32_t>(m_debuts.size() - 1);
+}
+
+const std::vector<std::uint32_t> &IndexStations::getRangees() const
+{
+    return m_rangees;
+}
+
+const std::vector<std::uint32_t> &IndexStations::getDeparts() const
+{
+    return m_departs;
+}
+
+const std::vector<std::uint32_t> &IndexStations::getDebuts() const
+{
+    return m_debuts;
+}
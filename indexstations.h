@@ -0,0 +1,68 @@
+//
+// Index inversé des arrêts par station, trié par heure de départ.
+//
+
+#ifndef RTC_INDEXSTATIONS_H
+#define RTC_INDEXSTATIONS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "tablearrets.h"
+
+/*!
+ * \struct PlageStation
+ * \brief Les arrêts d'une station: une tranche contiguë de IndexStations, par heure de départ croissante
+ * \note Les pointeurs sont valides jusqu'à la prochaine construction de l'index
+ */
+struct PlageStation
+{
+    PlageStation() : rangees(nullptr), departs(nullptr), nombre(0) {}
+
+    const std::uint32_t *rangees; //rangées de TableArrets
+    const std::uint32_t *departs; //codes des heures de départ, en secondes depuis 00h00m00s
+    std::size_t nombre;
+
+    std::size_t size() const
+    {
+        return nombre;
+    }
+
+    bool empty() const
+    {
+        return nombre == 0;
+    }
+
+    std::size_t premierDepart(std::uint32_t p_code) const;
+};
+
+/*!
+ * \class IndexStations
+ * \brief Pour chaque station, les rangées de TableArrets qui s'y arrêtent, triées par heure de départ
+ *
+ *  L'index est construit d'un coup après le chargement, par un tri par base parallèle des rangées selon
+ *  (station, départ); les arrêts d'une station occupent les positions [getDebuts()[s], getDebuts()[s + 1]).
+ *  À départ égal, l'ordre est celui de la table: par voyage, puis par numéro de séquence.
+ */
+class IndexStations
+{
+public:
+    void construire(const TableArrets &p_table, std::uint32_t p_nbStations);
+    bool corriger(const TableArrets &p_table, const std::vector<std::uint32_t> &p_rangees,
+                  const std::vector<std::uint32_t> &p_anciennesStations);
+    void vider();
+    PlageStation plage(std::uint32_t p_station) const;
+    std::size_t taille() const;
+    std::uint32_t nbStations() const;
+
+    const std::vector<std::uint32_t> &getRangees() const;
+    const std::vector<std::uint32_t> &getDeparts() const;
+    const std::vector<std::uint32_t> &getDebuts() const;
+
+private:
+    std::vector<std::uint32_t> m_rangees;
+    std::vector<std::uint32_t> m_departs;
+    std::vector<std::uint32_t> m_debuts; //nbStations() + 1 positions
+};
+
+#endif //RTC_INDEXSTATIONS_H
@@ -0,0 +1,584 @@
+//
+// Instantané binaire d'un objet DonneesGTFS.
+//
+
+#include "DonneesGTFS.h"
+#include "archivezip.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace
+{
+    const char MAGIE_INSTANTANE[8] = {'R', 'T', 'C', 'G', 'T', 'F', 'S', '\0'};
+    const std::uint32_t VERSION_INSTANTANE = 2;
+
+    //! les fichiers du dossier GTFS dont dépend un instantané, dans l'ordre de EnteteInstantane::sources
+    const char *const FICHIERS_SOURCES[] = {"routes.txt", "stops.txt", "calendar_dates.txt", "trips.txt",
+                                            "stop_times.txt", "transfers.txt"};
+    const std::size_t NB_SOURCES = sizeof(FICHIERS_SOURCES) / sizeof(FICHIERS_SOURCES[0]);
+
+    enum Section
+    {
+        CHAINES, LIGNES, LIGNES_PAR_NUMERO, STATIONS, SERVICES, VOYAGES, ARRETS, TRANSFERTS, NB_SECTIONS
+    };
+
+    struct SourceInstantane
+    {
+        std::uint64_t taille;
+        std::int64_t dateModification;
+    };
+
+    struct DescripteurSection
+    {
+        std::uint64_t decalage; //en octets, depuis le début des données
+        std::uint64_t nombre;   //nombre d'éléments de la section
+    };
+
+    //! \brief en-tête d'un instantané; il est suivi des données, dont chaque section est alignée sur 8 octets
+    struct EnteteInstantane
+    {
+        char magie[8];
+        std::uint32_t version;
+        std::uint32_t tousLesArretsPresents;
+        SourceInstantane sources[NB_SOURCES];
+        std::int32_t date;
+        std::uint32_t now1;
+        std::uint32_t now2;
+        std::uint32_t nbArrets;
+        double rayonMarche;   //trajets à pied fusionnés aux transferts (0: aucun), voir ajouterTrajetsAPied()
+        double vitesseMarche;
+        DescripteurSection sections[NB_SECTIONS];
+        std::uint64_t tailleDonnees;
+        std::uint64_t sommeControle;
+    };
+
+    //! \brief référence à une chaîne de la section CHAINES
+    struct RefChaine
+    {
+        std::uint32_t decalage;
+        std::uint32_t taille;
+    };
+
+    struct LigneInstantane
+    {
+        RefChaine id;
+        RefChaine numero;
+        RefChaine description;
+        std::uint32_t categorie;
+    };
+
+    struct StationInstantane
+    {
+        RefChaine id;
+        RefChaine nom;
+        RefChaine description;
+        double latitude;
+        double longitude;
+    };
+
+    struct VoyageInstantane
+    {
+        RefChaine id;
+        RefChaine ligne;
+        RefChaine service;
+        RefChaine destination;
+    };
+
+    //! \brief un arrêt; la section suit l'ordre de la table des arrêts, voyage par voyage
+    struct ArretInstantane
+    {
+        std::uint32_t voyage; //indice dans la section VOYAGES
+        RefChaine station;
+        std::uint32_t arrivee;
+        std::uint32_t depart;
+        std::uint32_t sequence;
+    };
+
+    struct TransfertInstantane
+    {
+        RefChaine de;
+        RefChaine vers;
+        std::uint32_t temps;
+    };
+
+    //! \brief somme de contrôle FNV-1a 64 bits, calculée par mots de 8 octets
+    std::uint64_t sommeControle(const char *p_donnees, std::size_t p_taille)
+    {
+        std::uint64_t h = 14695981039346656037ULL;
+        std::size_t i = 0;
+        for (; i + 8 <= p_taille; i += 8)
+        {
+            std::uint64_t mot;
+            memcpy(&mot, p_donnees + i, 8);
+            h = (h ^ mot) * 1099511628211ULL;
+        }
+        for (; i < p_taille; ++i) h = (h ^ (unsigned char) p_donnees[i]) * 1099511628211ULL;
+        return h;
+    }
+
+    //! \brief lit la taille et la date de modification des fichiers sources du dossier
+    //! \brief Si le dossier est une archive zip, chaque source prend celles de l'archive
+    //! \return false si l'un des fichiers est introuvable
+    bool lireSources(const std::string &p_dossier, SourceInstantane p_sources[NB_SOURCES])
+    {
+        for (std::size_t i = 0; i < NB_SOURCES; ++i)
+        {
+            struct stat infos;
+            std::string chemin = p_dossier + "/" + FICHIERS_SOURCES[i];
+            std::string archive, membre;
+            if (stat(chemin.c_str(), &infos) != 0 &&
+                (!separerCheminArchive(chemin, archive, membre) || stat(archive.c_str(), &infos) != 0))
+                return false;
+            p_sources[i].taille = (std::uint64_t) infos.st_size;
+            p_sources[i].dateModification = (std::int64_t) infos.st_mtime;
+        }
+        return true;
+    }
+
+    /*!
+     * \class RedacteurInstantane
+     * \brief Accumule les sections d'un instantané; les chaînes identiques ne sont écrites qu'une fois
+     */
+    class RedacteurInstantane
+    {
+    public:
+        RefChaine chaine(const std::string &p_chaine)
+        {
+            auto itr = m_indexChaines.find(p_chaine);
+            if (itr != m_indexChaines.end()) return itr->second;
+            RefChaine ref = {(std::uint32_t) m_chaines.size(), (std::uint32_t) p_chaine.size()};
+            m_chaines.append(p_chaine);
+            m_indexChaines.insert(std::make_pair(p_chaine, ref));
+            return ref;
+        }
+
+        template<typename T>
+        void section(Section p_section, const std::vector<T> &p_elements)
+        {
+            ajouterSection(p_section, p_elements.data(), p_elements.size(), sizeof(T));
+        }
+
+        void terminer()
+        {
+            ajouterSection(CHAINES, m_chaines.data(), m_chaines.size(), 1);
+        }
+
+        const std::vector<char> &donnees() const { return m_donnees; }
+        const DescripteurSection &descripteur(Section p_section) const { return m_sections[p_section]; }
+
+    private:
+        void ajouterSection(Section p_section, const void *p_elements, std::size_t p_nombre, std::size_t p_taille)
+        {
+            m_donnees.resize((m_donnees.size() + 7) & ~(std::size_t) 7, '\0');
+            m_sections[p_section].decalage = m_donnees.size();
+            m_sections[p_section].nombre = p_nombre;
+            const char *octets = static_cast<const char *>(p_elements);
+            m_donnees.insert(m_donnees.end(), octets, octets + p_nombre * p_taille);
+        }
+
+        std::string m_chaines;
+        std::unordered_map<std::string, RefChaine> m_indexChaines;
+        std::vector<char> m_donnees;
+        DescripteurSection m_sections[NB_SECTIONS];
+    };
+
+    /*!
+     * \class LecteurInstantane
+     * \brief Donne accès, sans copie, aux sections d'un instantané projeté en mémoire
+     */
+    class LecteurInstantane
+    {
+    public:
+        LecteurInstantane(const EnteteInstantane &p_entete, const char *p_donnees)
+                : m_entete(p_entete), m_donnees(p_donnees)
+        {
+        }
+
+        template<typename T>
+        const T *section(Section p_section) const
+        {
+            return reinterpret_cast<const T *>(m_donnees + m_entete.sections[p_section].decalage);
+        }
+
+        std::size_t nombre(Section p_section) const
+        {
+            return (std::size_t) m_entete.sections[p_section].nombre;
+        }
+
+        bool sectionsValides() const
+        {
+            const std::size_t tailles[NB_SECTIONS] = {1, sizeof(LigneInstantane), sizeof(LigneInstantane),
+                                                      sizeof(StationInstantane), sizeof(RefChaine),
+                                                      sizeof(VoyageInstantane), sizeof(ArretInstantane),
+                                                      sizeof(TransfertInstantane)};
+            for (std::size_t s = 0; s < NB_SECTIONS; ++s)
+            {
+                const DescripteurSection &d = m_entete.sections[s];
+                if (d.decalage % 8 != 0 || d.decalage > m_entete.tailleDonnees
+                    || d.nombre > (m_entete.tailleDonnees - d.decalage) / tailles[s])
+                    return false;
+            }
+            return true;
+        }
+
+        //! \brief vrai si p_ref désigne une tranche de la section CHAINES
+        bool chaineValide(const RefChaine &p_ref) const
+        {
+            std::uint64_t taille = m_entete.sections[CHAINES].nombre;
+            return p_ref.decalage <= taille && p_ref.taille <= taille - p_ref.decalage;
+        }
+
+        /*!
+         * \brief vrai si chaque référence des sections est valide: chaînes dans la section CHAINES, catégories de
+         * lignes connues, coordonnées des stations valides, trip_id distincts, arrêts d'un voyage de la section
+         * VOYAGES, rangés voyage par voyage par numéro de séquence croissant sans que les heures reculent, aussi
+         * nombreux que l'annonce l'en-tête, comme les écrit sauvegarderInstantane()
+         * \pre sectionsValides()
+         */
+        bool contenuValide() const
+        {
+            for (Section s : {LIGNES, LIGNES_PAR_NUMERO})
+            {
+                const LigneInstantane *lignes = section<LigneInstantane>(s);
+                for (std::size_t i = 0; i < nombre(s); ++i)
+                {
+                    if (!chaineValide(lignes[i].id) || !chaineValide(lignes[i].numero)
+                        || !chaineValide(lignes[i].description)
+                        || lignes[i].categorie > (std::uint32_t) CategorieBus::BUS_A_VENIR)
+                        return false;
+                }
+            }
+            const StationInstantane *stations = section<StationInstantane>(STATIONS);
+            for (std::size_t i = 0; i < nombre(STATIONS); ++i)
+            {
+                if (!chaineValide(stations[i].id) || !chaineValide(stations[i].nom)
+                    || !chaineValide(stations[i].description)
+                    || !Coordonnees::is_valide_coord(stations[i].latitude, stations[i].longitude))
+                    return false;
+            }
+            const RefChaine *services = section<RefChaine>(SERVICES);
+            for (std::size_t i = 0; i < nombre(SERVICES); ++i)
+            {
+                if (!chaineValide(services[i])) return false;
+            }
+            //deux voyages du même trip_id seraient fusionnés à l'internement, et leurs arrêts entremêlés
+            const VoyageInstantane *voyages = section<VoyageInstantane>(VOYAGES);
+            std::unordered_set<std::string> ids;
+            for (std::size_t i = 0; i < nombre(VOYAGES); ++i)
+            {
+                if (!chaineValide(voyages[i].id) || !chaineValide(voyages[i].ligne)
+                    || !chaineValide(voyages[i].service) || !chaineValide(voyages[i].destination)
+                    || !ids.insert(chaine(voyages[i].id)).second)
+                    return false;
+            }
+            const ArretInstantane *arrets = section<ArretInstantane>(ARRETS);
+            if (m_entete.nbArrets != nombre(ARRETS)) return false;
+            for (std::size_t i = 0; i < nombre(ARRETS); ++i)
+            {
+                if (arrets[i].voyage >= nombre(VOYAGES) || !chaineValide(arrets[i].station)) return false;
+                if (i == 0) continue;
+                const ArretInstantane &precedent = arrets[i - 1];
+                if (arrets[i].voyage < precedent.voyage) return false;
+                if (arrets[i].voyage == precedent.voyage
+                    && (arrets[i].sequence <= precedent.sequence || arrets[i].arrivee < precedent.depart))
+                    return false;
+            }
+            const TransfertInstantane *transferts = section<TransfertInstantane>(TRANSFERTS);
+            for (std::size_t i = 0; i < nombre(TRANSFERTS); ++i)
+            {
+                if (!chaineValide(transferts[i].de) || !chaineValide(transferts[i].vers)) return false;
+            }
+            return true;
+        }
+
+        //! \pre chaineValide(p_ref)
+        std::string chaine(const RefChaine &p_ref) const
+        {
+            return std::string(section<char>(CHAINES) + p_ref.decalage, p_ref.taille);
+        }
+
+    private:
+        const EnteteInstantane &m_entete;
+        const char *m_donnees;
+    };
+}
+
+/*!
+ * \brief écrit un instantané binaire de l'objet (lignes, stations, services, voyages et leurs arrêts, transferts,
+ * y compris les trajets à pied qui y sont fusionnés)
+ * \brief L'instantané mémorise la date et l'intervalle [now1, now2) ainsi que la taille et la date de modification
+ * des fichiers du dossier GTFS, pour que chargerInstantane() puisse reconnaître un instantané périmé.
+ * \param[in] p_nomFichier: le nom du fichier de l'instantané (écrit dans un fichier temporaire, puis renommé)
+ * \param[in] p_dossier: le dossier GTFS d'où proviennent les données
+ * \throws logic_error si les fichiers du dossier sont introuvables ou si l'écriture échoue
+ */
+void DonneesGTFS::sauvegarderInstantane(const std::string &p_nomFichier, const std::string &p_dossier) const
+{
+    EnteteInstantane entete;
+    memset(&entete, 0, sizeof(entete));
+    memcpy(entete.magie, MAGIE_INSTANTANE, sizeof(entete.magie));
+    entete.version = VERSION_INSTANTANE;
+    entete.tousLesArretsPresents = m_tousLesArretsPresents ? 1 : 0;
+    if (!lireSources(p_dossier, entete.sources))
+        throw logic_error("DonneesGTFS::sauvegarderInstantane(): fichiers GTFS introuvables dans " + p_dossier);
+    entete.date = m_date.getCode();
+    entete.now1 = m_now1.getCode();
+    entete.now2 = m_now2.getCode();
+    entete.rayonMarche = m_rayonMarche;
+    entete.vitesseMarche = m_vitesseMarche;
+
+    RedacteurInstantane redacteur;
+
+    vector<LigneInstantane> lignes;
+    for (const auto &ligneM : m_lignes)
+    {
+        const Ligne &l = ligneM.second;
+        LigneInstantane li = {redacteur.chaine(l.getId()), redacteur.chaine(l.getNumero()),
+                              redacteur.chaine(l.getDescription()), (std::uint32_t) l.getCategorie()};
+        lignes.push_back(li);
+    }
+    redacteur.section(LIGNES, lignes);
+    lignes.clear();
+    for (const auto &ligneM : m_lignes_par_numero)
+    {
+        const Ligne &l = ligneM.second;
+        LigneInstantane li = {redacteur.chaine(l.getId()), redacteur.chaine(l.getNumero()),
+                              redacteur.chaine(l.getDescription()), (std::uint32_t) l.getCategorie()};
+        lignes.push_back(li);
+    }
+    redacteur.section(LIGNES_PAR_NUMERO, lignes);
+
+    vector<StationInstantane> stations;
+    for (const auto &stationM : m_stations)
+    {
+        const Station &s = stationM.second;
+        StationInstantane si = {redacteur.chaine(s.getId()), redacteur.chaine(s.getNom()),
+                                redacteur.chaine(s.getDescription()), s.getCoords().getLatitude(),
+                                s.getCoords().getLongitude()};
+        stations.push_back(si);
+    }
+    redacteur.section(STATIONS, stations);
+
+    vector<RefChaine> services;
+    for (auto service : m_idsServices.trier(m_services)) services.push_back(redacteur.chaine(m_idsServices.chaine(service)));
+    redacteur.section(SERVICES, services);
+
+    vector<VoyageInstantane> voyages;
+    for (const auto &voyageM : m_voyages)
+    {
+        const Voyage &v = voyageM.second;
+        VoyageInstantane vi = {redacteur.chaine(m_idsVoyages.chaine(v.getId())),
+                               redacteur.chaine(m_idsLignes.chaine(v.getLigne())),
+                               redacteur.chaine(m_idsServices.chaine(v.getServiceId())),
+                               redacteur.chaine(v.getDestination())};
+        voyages.push_back(vi);
+    }
+    redacteur.section(VOYAGES, voyages);
+
+    //les arrêts sont écrits voyage par voyage, dans l'ordre de la table; l'index des stations est reconstruit au
+    //chargement, dans le même ordre puisque les voyages y sont internés dans l'ordre de leurs identifiants
+    vector<ArretInstantane> arrets;
+    arrets.reserve(m_tableArrets.taille());
+    std::uint32_t indice = 0; //position du voyage dans la section VOYAGES, écrite dans le même ordre
+    for (const auto &voyageM : m_voyages)
+    {
+        const PlageArrets &plage = voyageM.second.getArrets();
+        for (std::size_t i = 0; i < plage.size(); ++i)
+        {
+            ArretInstantane ai = {indice, redacteur.chaine(m_idsStations.chaine(plage.stations[i])),
+                                  plage.arrivees[i], plage.departs[i], plage.sequences[i]};
+            arrets.push_back(ai);
+        }
+        ++indice;
+    }
+    redacteur.section(ARRETS, arrets);
+    entete.nbArrets = (std::uint32_t) arrets.size(); //les arrêts de l'objet rechargé
+
+    vector<TransfertInstantane> transferts;
+    for (const auto &t : m_transferts)
+    {
+        TransfertInstantane ti = {redacteur.chaine(m_idsStations.chaine(get<0>(t))),
+                                  redacteur.chaine(m_idsStations.chaine(get<1>(t))), get<2>(t)};
+        transferts.push_back(ti);
+    }
+    redacteur.section(TRANSFERTS, transferts);
+
+    redacteur.terminer();
+    for (std::size_t s = 0; s < NB_SECTIONS; ++s) entete.sections[s] = redacteur.descripteur((Section) s);
+    entete.tailleDonnees = redacteur.donnees().size();
+    entete.sommeControle = sommeControle(redacteur.donnees().data(), redacteur.donnees().size());
+
+    string temporaire = p_nomFichier + ".tmp";
+    {
+        ofstream fichier(temporaire, ios::binary | ios::trunc);
+        if (!fichier.is_open())
+            throw logic_error("DonneesGTFS::sauvegarderInstantane(): impossible d'écrire " + temporaire);
+        fichier.write(reinterpret_cast<const char *>(&entete), sizeof(entete));
+        fichier.write(redacteur.donnees().data(), (std::streamsize) redacteur.donnees().size());
+        if (!fichier)
+            throw logic_error("DonneesGTFS::sauvegarderInstantane(): erreur d'écriture dans " + temporaire);
+    }
+    if (std::rename(temporaire.c_str(), p_nomFichier.c_str()) != 0)
+        throw logic_error("DonneesGTFS::sauvegarderInstantane(): impossible de renommer " + temporaire);
+}
+
+/*!
+ * \brief remplace le contenu de l'objet par celui d'un instantané écrit par sauvegarderInstantane()
+ * \brief L'instantané est projeté en mémoire et ses sections sont lues en place.
+ * \param[in] p_nomFichier: le nom du fichier de l'instantané
+ * \param[in] p_dossier: le dossier GTFS dont l'instantané doit être à jour
+ * \return false (sans modifier l'objet) si l'instantané est absent, corrompu, d'une autre version, ou périmé:
+ * fichiers du dossier modifiés depuis, ou date, intervalle ou paramètres des trajets à pied différents de ceux de
+ * l'objet
+ */
+bool DonneesGTFS::chargerInstantane(const std::string &p_nomFichier, const std::string &p_dossier)
+{
+    FichierMappe fichier(p_nomFichier);
+    if (!fichier.estOuvert() || fichier.taille() < sizeof(EnteteInstantane)) return false;
+
+    EnteteInstantane entete;
+    memcpy(&entete, fichier.debut(), sizeof(entete));
+    if (memcmp(entete.magie, MAGIE_INSTANTANE, sizeof(entete.magie)) != 0 || entete.version != VERSION_INSTANTANE)
+        return false;
+    if (entete.date != m_date.getCode() || entete.now1 != m_now1.getCode() || entete.now2 != m_now2.getCode())
+        return false;
+    if (entete.rayonMarche != m_rayonMarche || (m_rayonMarche > 0 && entete.vitesseMarche != m_vitesseMarche))
+        return false;
+
+    SourceInstantane sources[NB_SOURCES];
+    if (!lireSources(p_dossier, sources)) return false;
+    for (std::size_t i = 0; i < NB_SOURCES; ++i)
+    {
+        if (sources[i].taille != entete.sources[i].taille
+            || sources[i].dateModification != entete.sources[i].dateModification)
+            return false;
+    }
+
+    const char *donnees = fichier.debut() + sizeof(EnteteInstantane);
+    if (entete.tailleDonnees != fichier.taille() - sizeof(EnteteInstantane)
+        || sommeControle(donnees, (std::size_t) entete.tailleDonnees) != entete.sommeControle)
+        return false;
+    LecteurInstantane lecteur(entete, donnees);
+    if (!lecteur.sectionsValides() || !lecteur.contenuValide()) return false;
+
+    //l'instantané est entièrement vérifié: l'objet n'est modifié qu'à partir d'ici, et sa reconstruction ne peut
+    //plus être refusée
+    m_etatRechargement = EtatRechargement(); //ses poignées désignent des arrêts de m_arrets
+    m_idsLignes.vider();
+    m_idsStations.vider();
+    m_idsServices.vider();
+    m_idsVoyages.vider();
+    m_lignes.clear();
+    m_lignes_par_numero.clear();
+    m_stations.clear();
+    m_services.clear();
+    m_voyages.clear();
+    m_transferts.clear();
+    m_stationsDeTransfert.clear();
+    m_grapheTransferts.vider();
+    m_arrets.vider();
+
+    const LigneInstantane *lignes = lecteur.section<LigneInstantane>(LIGNES);
+    for (std::size_t i = 0; i < lecteur.nombre(LIGNES); ++i)
+    {
+        Ligne l(lecteur.chaine(lignes[i].id), lecteur.chaine(lignes[i].numero), lecteur.chaine(lignes[i].description),
+                (CategorieBus) lignes[i].categorie);
+        m_lignes.inserer(m_idsLignes.interner(l.getId()), l);
+    }
+    lignes = lecteur.section<LigneInstantane>(LIGNES_PAR_NUMERO);
+    for (std::size_t i = 0; i < lecteur.nombre(LIGNES_PAR_NUMERO); ++i)
+    {
+        Ligne l(lecteur.chaine(lignes[i].id), lecteur.chaine(lignes[i].numero), lecteur.chaine(lignes[i].description),
+                (CategorieBus) lignes[i].categorie);
+        m_lignes_par_numero.insert(std::make_pair(l.getNumero(), l));
+    }
+
+    //les chaînes de l'instantané sont uniques: une station est internée une seule fois par référence de sa chaîne
+    const StationInstantane *stations = lecteur.section<StationInstantane>(STATIONS);
+    unordered_map<std::uint64_t, std::uint32_t> stationDeChaine;
+    auto stationDe = [&](const RefChaine &p_id) -> std::uint32_t
+    {
+        std::uint64_t cle = (std::uint64_t) p_id.decalage << 32 | p_id.taille;
+        auto itr = stationDeChaine.find(cle);
+        if (itr != stationDeChaine.end()) return itr->second;
+        std::uint32_t id = m_idsStations.interner(lecteur.chaine(p_id));
+        stationDeChaine[cle] = id;
+        return id;
+    };
+    for (std::size_t i = 0; i < lecteur.nombre(STATIONS); ++i)
+    {
+        m_stations.inserer(stationDe(stations[i].id),
+                           Station(lecteur.chaine(stations[i].id), lecteur.chaine(stations[i].nom),
+                                   lecteur.chaine(stations[i].description),
+                                   Coordonnees(stations[i].latitude, stations[i].longitude)));
+    }
+
+    const RefChaine *services = lecteur.section<RefChaine>(SERVICES);
+    for (std::size_t i = 0; i < lecteur.nombre(SERVICES); ++i)
+    {
+        m_services.ajouter(m_idsServices.interner(lecteur.chaine(services[i])));
+    }
+
+    const VoyageInstantane *voyages = lecteur.section<VoyageInstantane>(VOYAGES);
+    vector<std::uint32_t> voyageParIndice(lecteur.nombre(VOYAGES));
+    for (std::size_t i = 0; i < lecteur.nombre(VOYAGES); ++i)
+    {
+        std::uint32_t id = m_idsVoyages.interner(lecteur.chaine(voyages[i].id));
+        m_voyages.inserer(id, Voyage(id, m_idsLignes.interner(lecteur.chaine(voyages[i].ligne)),
+                                     m_idsServices.interner(lecteur.chaine(voyages[i].service)),
+                                     lecteur.chaine(voyages[i].destination)));
+        voyageParIndice[i] = id;
+    }
+
+    const ArretInstantane *arrets = lecteur.section<ArretInstantane>(ARRETS);
+    m_arrets.reserver(lecteur.nombre(ARRETS));
+    for (std::size_t i = 0; i < lecteur.nombre(ARRETS); ++i)
+    {
+        const ArretInstantane &ai = arrets[i];
+        std::uint32_t voyage = voyageParIndice[ai.voyage];
+        std::uint32_t station = stationDe(ai.station);
+        m_arrets.creer(station, Heure::depuisCode(ai.arrivee), Heure::depuisCode(ai.depart), ai.sequence, voyage);
+    }
+    indexerArrets();
+
+    const TransfertInstantane *transferts = lecteur.section<TransfertInstantane>(TRANSFERTS);
+    for (std::size_t i = 0; i < lecteur.nombre(TRANSFERTS); ++i)
+    {
+        std::uint32_t de = stationDe(transferts[i].de);
+        m_transferts.push_back(std::make_tuple(de, stationDe(transferts[i].vers), transferts[i].temps));
+        m_stationsDeTransfert.ajouter(de);
+    }
+    indexerTransferts();
+
+    m_nbArrets = entete.nbArrets;
+    m_tousLesArretsPresents = entete.tousLesArretsPresents != 0;
+    return true;
+}
+
+/*!
+ * \brief charge le dossier GTFS à partir de l'instantané p_nomInstantane s'il est à jour;
+ * sinon, lit les fichiers du dossier, génère les trajets à pied demandés et réécrit l'instantané
+ * \brief Les trajets à pied sont ainsi calculés une fois, puis lus de l'instantané tant que le dossier ne change pas
+ * \param[in] p_dossier: le dossier contenant les fichiers GTFS
+ * \param[in] p_nomInstantane: le nom du fichier de l'instantané
+ * \param[in] p_rayonMarche: le rayon des trajets à pied (voir ajouterTrajetsAPied()), en km; 0 pour n'en ajouter aucun
+ * \param[in] p_vitesseMarche: la vitesse de marche, en m/s
+ * \throws logic_error si un problème survient avec la lecture des fichiers
+ */
+void DonneesGTFS::chargerAvecInstantane(const std::string &p_dossier, const std::string &p_nomInstantane,
+                                        double p_rayonMarche, double p_vitesseMarche)
+{
+    m_rayonMarche = p_rayonMarche;
+    m_vitesseMarche = p_vitesseMarche;
+    if (chargerInstantane(p_nomInstantane, p_dossier)) return;
+
+    m_rayonMarche = 0;
+    charger(p_dossier);
+    if (p_rayonMarche > 0) ajouterTrajetsAPied(p_rayonMarche, p_vitesseMarche);
+    sauvegarderInstantane(p_nomInstantane, p_dossier);
+}
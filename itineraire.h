@@ -0,0 +1,54 @@
+//
+// Itinéraire d'une station à une autre: ses étapes en voyage et à pied.
+//
+
+#ifndef RTC_ITINERAIRE_H
+#define RTC_ITINERAIRE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "auxiliaires.h"
+#include "identifiants.h"
+
+/*!
+ * \struct Etape
+ * \brief Un tronçon d'itinéraire: à bord d'un voyage, ou à pied par un transfert
+ */
+struct Etape
+{
+    std::uint32_t voyage; //identifiant dense du trip_id; TableIdentifiants::ABSENT pour un transfert à pied
+    std::uint32_t de;     //identifiants denses des stations
+    std::uint32_t vers;
+    Heure depart;
+    Heure arrivee;
+
+    bool estAPied() const
+    {
+        return voyage == TableIdentifiants::ABSENT;
+    }
+};
+
+/*!
+ * \struct Itineraire
+ * \brief La réponse d'une requête: l'heure d'arrivée la plus tôt et les étapes qui l'atteignent, dans l'ordre
+ */
+struct Itineraire
+{
+    Itineraire() : existe(false), depart(Heure::depuisCode(0)), arrivee(Heure::depuisCode(0)) {}
+
+    bool existe;                //false si la destination n'est pas atteignable dans les bornes de la requête
+    Heure depart;               //l'heure de départ demandée
+    Heure arrivee;              //l'heure d'arrivée à destination, si existe
+    std::vector<Etape> etapes;  //vide si l'origine est la destination
+
+    //! \brief le nombre de changements de voyage
+    std::size_t nbTransferts() const
+    {
+        std::size_t nbVoyages = 0;
+        for (const Etape &etape : etapes) nbVoyages += !etape.estAPied();
+        return nbVoyages == 0 ? 0 : nbVoyages - 1;
+    }
+};
+
+#endif //RTC_ITINERAIRE_H
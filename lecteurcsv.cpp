@@ -0,0 +1,828 @@
+//
+// Lecture sans copie des fichiers CSV du GTFS.
+//
+
+#include "lecteurcsv.h"
+#include "archivezip.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <memory>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RTC_AVEC_MMAP 1
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    const std::size_t TAILLE_BLOC = 64;
+
+    inline unsigned int nbZerosFinaux(std::uint64_t x)
+    {
+#if defined(__GNUC__)
+        return (unsigned int) __builtin_ctzll(x);
+#else
+        unsigned int n = 0;
+        while (!(x & 1u))
+        {
+            x >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+}
+
+Champ::Champ() : m_debut(""), m_taille(0), m_guillemetsDoubles(false)
+{
+}
+
+Champ::Champ(const char *p_debut, std::size_t p_taille, bool p_guillemetsDoubles)
+        : m_debut(p_debut), m_taille(p_taille), m_guillemetsDoubles(p_guillemetsDoubles)
+{
+}
+
+//! \brief copie le champ dans un nouveau string (les guillemets échappés "" sont réduits à ")
+std::string Champ::str() const
+{
+    std::string s;
+    copierDans(s);
+    return s;
+}
+
+//! \brief copie le champ dans un string existant, en réutilisant sa capacité
+//! \param[out] p_destination: le string qui reçoit le contenu du champ
+void Champ::copierDans(std::string &p_destination) const
+{
+    if (!m_guillemetsDoubles)
+    {
+        p_destination.assign(m_debut, m_taille);
+        return;
+    }
+    p_destination.clear();
+    for (std::size_t i = 0; i < m_taille; ++i)
+    {
+        p_destination.push_back(m_debut[i]);
+        if (m_debut[i] == '"' && i + 1 < m_taille && m_debut[i + 1] == '"') ++i;
+    }
+}
+
+bool Champ::operator==(const Champ &p_other) const
+{
+    return m_taille == p_other.m_taille && memcmp(m_debut, p_other.m_debut, m_taille) == 0;
+}
+
+bool Champ::operator!=(const Champ &p_other) const
+{
+    return !(*this == p_other);
+}
+
+bool Champ::operator==(const char *p_texte) const
+{
+    return strlen(p_texte) == m_taille && memcmp(m_debut, p_texte, m_taille) == 0;
+}
+
+bool Champ::operator==(const std::string &p_texte) const
+{
+    return p_texte.size() == m_taille && memcmp(m_debut, p_texte.data(), m_taille) == 0;
+}
+
+std::ostream &operator<<(std::ostream &flux, const Champ &p_champ)
+{
+    flux.write(p_champ.m_debut, (std::streamsize) p_champ.m_taille);
+    return flux;
+}
+
+//! \brief l'état d'un membre ouvert en différé, partagé par les fils qui attendent ses octets
+struct FichierMappe::Decompression
+{
+    Decompression(const ArchiveZip &p_archive, const MembreZip &p_membre, char *p_destination)
+            : flux(p_archive, p_membre, p_destination), produit(0), terminee(false), enCours(false)
+    {
+    }
+
+    DecompressionZip flux; //n'est manipulé que par le fil qui a mis enCours à vrai
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::size_t produit; //les octets lisibles
+    bool terminee;       //le membre est lisible au complet, taille et CRC vérifiés
+    bool enCours;        //un fil décompresse la tranche suivante
+    std::exception_ptr erreur;
+};
+
+/*!
+ * \brief Projette le fichier en mémoire. Si la projection échoue, le fichier est lu au complet dans un tampon.
+ * \param[in] p_nomFichier: le nom du fichier à ouvrir
+ * \brief Utiliser estOuvert() pour savoir si l'ouverture a réussi
+ */
+FichierMappe::FichierMappe(const std::string &p_nomFichier)
+        : m_debut(nullptr), m_taille(0), m_ouvert(false), m_projete(false), m_emprunte(false), m_archive(nullptr),
+          m_decompression(nullptr)
+{
+    ouvrir(p_nomFichier);
+    if (!m_ouvert) ouvrirMembre(p_nomFichier);
+}
+
+/*!
+ * \brief Ouvre le membre p_nomMembre d'une archive déjà ouverte, sans relire son répertoire (voir ArchiveZip::trouver())
+ * \param[in] p_differe: vrai pour qu'un membre compressé ne soit décompressé qu'à la demande, par attendre()
+ * \pre la projection de l'archive doit exister tant que l'objet est utilisé
+ * \throws logic_error si le membre est corrompu
+ */
+FichierMappe::FichierMappe(const ArchiveZip &p_archive, const std::string &p_nomMembre, bool p_differe)
+        : m_debut(nullptr), m_taille(0), m_ouvert(false), m_projete(false), m_emprunte(false), m_archive(nullptr),
+          m_decompression(nullptr)
+{
+    ouvrirMembre(p_archive, p_nomMembre, p_differe);
+}
+
+//! \brief projette le fichier p_nomFichier, ou le lit dans un tampon si mmap n'est pas disponible
+void FichierMappe::ouvrir(const std::string &p_nomFichier)
+{
+#ifdef RTC_AVEC_MMAP
+    int fd = ::open(p_nomFichier.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat infos;
+        if (::fstat(fd, &infos) == 0 && S_ISREG(infos.st_mode))
+        {
+            m_taille = (std::size_t) infos.st_size;
+            m_ouvert = true;
+            if (m_taille > 0)
+            {
+                void *p = ::mmap(nullptr, m_taille, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED)
+                {
+                    ::madvise(p, m_taille, MADV_SEQUENTIAL);
+                    m_debut = static_cast<const char *>(p);
+                    m_projete = true;
+                }
+            }
+        }
+        ::close(fd);
+        if (!m_ouvert || m_projete || m_taille == 0) return;
+    }
+#endif
+    ifstream fichier(p_nomFichier, ios::binary);
+    if (!fichier.is_open())
+    {
+        m_ouvert = false;
+        return;
+    }
+    fichier.seekg(0, ios::end);
+    m_taille = (std::size_t) fichier.tellg();
+    fichier.seekg(0, ios::beg);
+    char *tampon = new char[m_taille + 1];
+    fichier.read(tampon, (std::streamsize) m_taille);
+    m_debut = tampon;
+    m_ouvert = true;
+}
+
+/*!
+ * \brief ouvre un membre d'archive zip désigné par un chemin comme "gtfs.zip/stop_times.txt"
+ * \brief Un membre stocké est lu directement dans la projection de l'archive, qui est conservée, après vérification
+ * de sa taille et de son CRC; un membre compressé est décompressé au complet dans un tampon alloué à sa taille
+ * finale, avant que la lecture de ses enregistrements commence. Seule une archive déjà ouverte permet de différer la
+ * décompression et de lire le membre à mesure qu'il est produit
+ * \post le fichier reste fermé si aucun préfixe du chemin n'est une archive qui contient le membre
+ * \throws logic_error si l'archive ou le membre est corrompu
+ */
+void FichierMappe::ouvrirMembre(const std::string &p_nomFichier)
+{
+    std::string nomArchive, nomMembre;
+    if (!separerCheminArchive(p_nomFichier, nomArchive, nomMembre)) return;
+
+    std::unique_ptr<FichierMappe> archive(new FichierMappe(nomArchive));
+    if (!archive->estOuvert()) return;
+    ouvrirMembre(ArchiveZip(archive->debut(), archive->fin()), nomMembre, false);
+    if (m_emprunte) m_archive = archive.release();
+}
+
+//! \brief ouvre le membre p_nomMembre de p_archive; le fichier reste fermé si l'archive ne le contient pas
+void FichierMappe::ouvrirMembre(const ArchiveZip &p_archive, const std::string &p_nomMembre, bool p_differe)
+{
+    const MembreZip *membre = p_archive.trouver(p_nomMembre);
+    if (membre == nullptr) return;
+    if (membre->tailleDecompressee > (std::uint64_t) std::numeric_limits<std::size_t>::max() - 1)
+        throw logic_error("FichierMappe: membre trop grand: " + membre->nom);
+    p_archive.verifierTailles(*membre); //le tampon ci-dessous est alloué d'après la taille annoncée
+
+    m_taille = (std::size_t) membre->tailleDecompressee;
+    if (membre->methode == 0)
+    {
+        m_debut = p_archive.verifierStocke(*membre);
+        m_emprunte = true;
+    }
+    else
+    {
+        std::unique_ptr<char[]> tampon(new char[m_taille + 1]);
+        if (p_differe)
+            m_decompression = new Decompression(p_archive, *membre, tampon.get());
+        else
+            p_archive.decompresser(*membre, tampon.get());
+        m_debut = tampon.release();
+    }
+    m_ouvert = true;
+}
+
+FichierMappe::~FichierMappe()
+{
+    delete m_decompression;
+    delete m_archive;
+    if (m_debut == nullptr || m_emprunte) return; //un membre stocké pointe dans la projection de l'archive
+#ifdef RTC_AVEC_MMAP
+    if (m_projete)
+    {
+        ::munmap(const_cast<char *>(m_debut), m_taille);
+        return;
+    }
+#endif
+    delete[] m_debut;
+}
+
+bool FichierMappe::estOuvert() const
+{
+    return m_ouvert;
+}
+
+const char *FichierMappe::debut() const
+{
+    return m_debut == nullptr ? "" : m_debut;
+}
+
+const char *FichierMappe::fin() const
+{
+    return debut() + m_taille;
+}
+
+std::size_t FichierMappe::taille() const
+{
+    return m_taille;
+}
+
+/*!
+ * \brief attend que les p_taille premiers octets du fichier (tous s'il en a moins) soient lisibles
+ * \brief Seul un membre ouvert en différé ne l'est pas dès son ouverture. Il est décompressé par tranches, chacune par
+ * le premier fil qui attend des octets alors qu'aucun autre ne décompresse; les autres fils attendent la tranche. La
+ * fin du fichier n'est rendue lisible qu'une fois sa taille et son CRC vérifiés
+ * \return le nombre d'octets lisibles, au moins min(p_taille, taille())
+ * \throws logic_error si le membre est corrompu
+ */
+std::size_t FichierMappe::attendre(std::size_t p_taille) const
+{
+    if (m_decompression == nullptr) return m_taille;
+    Decompression &decompression = *m_decompression;
+    std::size_t cible = std::min(p_taille, m_taille);
+
+    std::unique_lock<std::mutex> verrou(decompression.mutex);
+    for (;;)
+    {
+        if (decompression.erreur) std::rethrow_exception(decompression.erreur);
+        bool lisible = decompression.terminee || (decompression.produit >= cible && cible < m_taille);
+        if (lisible) return decompression.produit;
+        if (decompression.enCours)
+        {
+            decompression.condition.wait(verrou);
+            continue;
+        }
+
+        decompression.enCours = true;
+        verrou.unlock();
+        std::exception_ptr erreur;
+        try
+        {
+            decompression.flux.avancer();
+        }
+        catch (...)
+        {
+            erreur = std::current_exception();
+        }
+        verrou.lock();
+        decompression.enCours = false;
+        decompression.produit = decompression.flux.produit();
+        decompression.terminee = decompression.flux.estTerminee();
+        decompression.erreur = erreur;
+        decompression.condition.notify_all();
+    }
+}
+
+/*!
+ * \brief Distribue [p_debut, p_fichier.fin()) en morceaux d'environ p_tailleMorceau octets
+ * \param[in] p_tailleMorceau: la taille visée; un morceau s'étend jusqu'à la fin de sa dernière ligne
+ */
+DistributeurLignes::DistributeurLignes(const FichierMappe &p_fichier, const char *p_debut, std::size_t p_tailleMorceau)
+        : m_fichier(p_fichier), m_position(p_debut), m_tailleMorceau(p_tailleMorceau), m_nbDonnes(0)
+{
+}
+
+/*!
+ * \brief donne le prochain morceau du fichier, en attendant qu'il soit lisible
+ * \param[out] p_numero: le rang du morceau dans le fichier, à partir de 0
+ * \param[out] p_debut: le début du morceau, au début d'une ligne
+ * \param[out] p_fin: la position suivant sa dernière fin de ligne, ou la fin du fichier
+ * \return false si tout le fichier a déjà été donné
+ * \throws logic_error si le membre est corrompu
+ * \note les champs entre guillemets ne doivent pas contenir de fin de ligne
+ */
+bool DistributeurLignes::prendre(std::size_t &p_numero, const char *&p_debut, const char *&p_fin)
+{
+    std::lock_guard<std::mutex> verrou(m_mutex);
+    const char *finFichier = m_fichier.fin();
+    if (m_position >= finFichier) return false;
+
+    // Le morceau se termine à la dernière fin de ligne avant sa taille visée; une ligne plus longue le prolonge
+    const char *fin = finFichier;
+    for (std::size_t taille = m_tailleMorceau; taille < (std::size_t) (finFichier - m_position); taille *= 2)
+    {
+        const char *vise = m_position + taille;
+        m_fichier.attendre((std::size_t) (vise - m_fichier.debut()));
+        const char *p = vise;
+        while (p > m_position && p[-1] != '\n') --p;
+        if (p > m_position)
+        {
+            fin = p;
+            break;
+        }
+    }
+    if (fin == finFichier) m_fichier.attendre(m_fichier.taille());
+
+    p_numero = m_nbDonnes++;
+    p_debut = m_position;
+    p_fin = fin;
+    m_position = fin;
+    return true;
+}
+
+/*!
+ * \brief Construit un lecteur sur le tampon [p_debut, p_fin)
+ * \param[in] p_debut: le premier caractère du tampon
+ * \param[in] p_fin: la position suivant le dernier caractère du tampon
+ */
+LecteurCSV::LecteurCSV(const char *p_debut, const char *p_fin)
+        : m_debut(p_debut), m_fin(p_fin), m_position(p_debut), m_finDeLigne(true), m_bloc(nullptr), m_masque(0)
+{
+}
+
+//! \brief calcule le masque des caractères spéciaux (',', '"', '\n') du bloc de 64 octets débutant à p_bloc
+void LecteurCSV::chargerBloc(const char *p_bloc)
+{
+    m_bloc = p_bloc;
+    m_masque = 0;
+    std::size_t n = (std::size_t) (m_fin - p_bloc);
+#if defined(__SSE2__)
+    if (n >= TAILLE_BLOC)
+    {
+        const __m128i virgule = _mm_set1_epi8(',');
+        const __m128i guillemet = _mm_set1_epi8('"');
+        const __m128i retour = _mm_set1_epi8('\n');
+        for (unsigned int i = 0; i < TAILLE_BLOC / 16; ++i)
+        {
+            __m128i octets = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_bloc + 16 * i));
+            __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(octets, virgule),
+                                                        _mm_cmpeq_epi8(octets, guillemet)),
+                                           _mm_cmpeq_epi8(octets, retour));
+            m_masque |= (std::uint64_t) (unsigned int) _mm_movemask_epi8(special) << (16 * i);
+        }
+        return;
+    }
+#endif
+    if (n > TAILLE_BLOC) n = TAILLE_BLOC;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        char c = p_bloc[i];
+        if (c == ',' || c == '"' || c == '\n') m_masque |= (std::uint64_t) 1 << i;
+    }
+}
+
+//! \brief retourne la position du prochain caractère spécial à partir de p_position, ou m_fin s'il n'y en a plus
+const char *LecteurCSV::prochainSpecial(const char *p_position)
+{
+    while (p_position < m_fin)
+    {
+        const char *bloc = m_debut + ((std::size_t) (p_position - m_debut) & ~(TAILLE_BLOC - 1));
+        if (bloc != m_bloc) chargerBloc(bloc);
+        std::uint64_t masque = m_masque & (~(std::uint64_t) 0 << (p_position - bloc));
+        if (masque != 0) return bloc + nbZerosFinaux(masque);
+        p_position = bloc + TAILLE_BLOC;
+    }
+    return m_fin;
+}
+
+/*!
+ * \brief avance jusqu'au début de la prochaine ligne non vide
+ * \return false s'il n'y a plus de ligne dans le tampon
+ */
+bool LecteurCSV::debutLigne()
+{
+    if (!m_finDeLigne) finLigne();
+    while (m_position < m_fin && (estBlanc(*m_position) || *m_position == '\n')) ++m_position;
+    if (m_position >= m_fin) return false;
+    m_finDeLigne = false;
+    return true;
+}
+
+/*!
+ * \brief lit le prochain champ de la ligne courante
+ * \param[out] p_champ: la vue sur le champ lu, sans guillemets englobants ni caractères blancs aux extrémités
+ * \return false si tous les champs de la ligne courante ont déjà été lus
+ */
+bool LecteurCSV::champSuivant(Champ &p_champ)
+{
+    if (m_finDeLigne) return false;
+
+    const char *p = m_position;
+    while (p < m_fin && estBlanc(*p)) ++p;
+
+    const char *delim;
+    if (p < m_fin && *p == '"')
+    {
+        //champ entre guillemets: seules les paires "" ne le terminent pas
+        const char *debut = p + 1;
+        const char *q = debut;
+        bool doubles = false;
+        while ((q = prochainSpecial(q)) < m_fin)
+        {
+            if (*q != '"')
+            {
+                ++q;
+                continue;
+            }
+            if (q + 1 < m_fin && q[1] == '"')
+            {
+                doubles = true;
+                q += 2;
+                continue;
+            }
+            break;
+        }
+        p_champ = Champ(debut, (std::size_t) (q - debut), doubles);
+        delim = q < m_fin ? q + 1 : m_fin;
+        while ((delim = prochainSpecial(delim)) < m_fin && *delim == '"') ++delim;
+    }
+    else
+    {
+        delim = p;
+        while ((delim = prochainSpecial(delim)) < m_fin && *delim == '"') ++delim;
+        const char *fin = delim;
+        while (fin > p && estBlanc(fin[-1])) --fin;
+        p_champ = Champ(p, (std::size_t) (fin - p));
+    }
+
+    if (delim >= m_fin)
+    {
+        m_position = m_fin;
+        m_finDeLigne = true;
+    }
+    else
+    {
+        m_position = delim + 1;
+        m_finDeLigne = (*delim == '\n');
+    }
+    return true;
+}
+
+//! \brief saute les champs restants de la ligne courante
+//! \brief Les champs ne sont pas découpés: on passe directement d'un caractère spécial au suivant, sauf si un guillemet
+//! oblige à revenir à la lecture champ par champ
+void LecteurCSV::finLigne()
+{
+    if (m_finDeLigne) return;
+    const char *p = m_position;
+    for (;;)
+    {
+        p = prochainSpecial(p);
+        if (p >= m_fin)
+        {
+            m_position = m_fin;
+            m_finDeLigne = true;
+            return;
+        }
+        if (*p == '\n')
+        {
+            m_position = p + 1;
+            m_finDeLigne = true;
+            return;
+        }
+        if (*p == '"') break;
+        m_position = ++p; //début du champ suivant
+    }
+
+    Champ ignore;
+    while (champSuivant(ignore))
+    {
+    }
+}
+
+//! \brief retourne la position courante dans le tampon (le début de la prochaine ligne après debutLigne() ou finLigne())
+const char *LecteurCSV::position() const
+{
+    return m_position;
+}
+
+/*!
+ * \brief lit la prochaine ligne non vide au complet
+ * \param[out] p_champs: les champs de la ligne; le vecteur est vidé puis rempli (sa capacité est réutilisée)
+ * \return false s'il n'y a plus de ligne dans le tampon
+ */
+bool LecteurCSV::lireLigne(std::vector<Champ> &p_champs)
+{
+    p_champs.clear();
+    if (!debutLigne()) return false;
+    Champ champ;
+    while (champSuivant(champ)) p_champs.push_back(champ);
+    return true;
+}
+
+/*!
+ * \brief lit la ligne d'en-tête, comme lireLigne(), sans la marque d'ordre des octets UTF-8 qui peut la précéder
+ * \param[out] p_champs: les noms des colonnes
+ * \return false s'il n'y a aucune ligne dans le tampon
+ */
+bool LecteurCSV::lireEntete(std::vector<Champ> &p_champs)
+{
+    if (!lireLigne(p_champs)) return false;
+    if (!p_champs.empty() && p_champs[0].size() >= 3 && p_champs[0][0] == '\xEF' && p_champs[0][1] == '\xBB'
+        && p_champs[0][2] == '\xBF')
+    {
+        p_champs[0] = Champ(p_champs[0].data() + 3, p_champs[0].size() - 3);
+    }
+    return true;
+}
+
+/*!
+ * \brief découpe le tampon [p_debut, p_fin) en morceaux de tailles semblables qui commencent tous en début de ligne
+ * \param[in] p_nbMorceaux: le nombre de morceaux souhaité (il peut y en avoir moins si les lignes sont longues)
+ * \return les bornes des morceaux: le morceau k est [bornes[k], bornes[k + 1])
+ * \note les champs entre guillemets ne doivent pas contenir de fin de ligne
+ */
+std::vector<const char *> decouperSurLignes(const char *p_debut, const char *p_fin, std::size_t p_nbMorceaux)
+{
+    std::vector<const char *> bornes(1, p_debut);
+    std::size_t taille = (std::size_t) (p_fin - p_debut);
+    for (std::size_t k = 1; k < p_nbMorceaux; ++k)
+    {
+        const char *p = p_debut + taille / p_nbMorceaux * k;
+        if (p <= bornes.back()) continue;
+        p = static_cast<const char *>(memchr(p - 1, '\n', (std::size_t) (p_fin - p + 1)));
+        if (p == nullptr) break;
+        if (p + 1 > bornes.back() && p + 1 < p_fin) bornes.push_back(p + 1);
+    }
+    bornes.push_back(p_fin);
+    return bornes;
+}
+
+/*!
+ * \brief convertit un champ composé uniquement de chiffres en entier non signé
+ * \throws logic_error si le champ est vide ou contient autre chose que des chiffres
+ */
+unsigned int champVersEntier(const Champ &p_champ)
+{
+    if (p_champ.empty()) throw logic_error("champVersEntier(): champ vide");
+    unsigned int n = 0;
+    for (char c : p_champ)
+    {
+        if (c < '0' || c > '9') throw logic_error("champVersEntier(): entier invalide");
+        n = n * 10 + (unsigned int) (c - '0');
+    }
+    return n;
+}
+
+/*!
+ * \brief convertit un champ en nombre réel
+ * \throws logic_error si le champ ne représente pas un nombre réel
+ */
+double champVersReel(const Champ &p_champ)
+{
+    char tampon[64];
+    if (p_champ.empty() || p_champ.size() >= sizeof(tampon)) throw logic_error("champVersReel(): réel invalide");
+    memcpy(tampon, p_champ.data(), p_champ.size());
+    tampon[p_champ.size()] = '\0';
+    char *fin;
+    double x = strtod(tampon, &fin);
+    if (fin != tampon + p_champ.size()) throw logic_error("champVersReel(): réel invalide");
+    return x;
+}
+
+namespace
+{
+    //! \brief charge 8 octets dans l'ordre du texte: l'octet 0 du mot est le premier caractère
+    inline std::uint64_t chargerMot(const char *p_texte)
+    {
+        std::uint64_t mot;
+        memcpy(&mot, p_texte, sizeof(mot));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        mot = __builtin_bswap64(mot);
+#endif
+        return mot;
+    }
+
+    //! \brief vrai ssi chaque octet de p_mot marqué par p_positions (bit 7 de l'octet) est un chiffre ASCII
+    //! \pre les octets non marqués de p_mot sont nuls
+    inline bool chiffresValides(std::uint64_t p_mot, std::uint64_t p_positions)
+    {
+        std::uint64_t unites = p_positions >> 7;
+        std::uint64_t auDessus = p_mot + 0x46 * unites;   //bit 7 à 1 ssi l'octet dépasse '9'
+        std::uint64_t auDessous = p_mot + 0x50 * unites;  //bit 7 à 0 ssi l'octet est sous '0'
+        return ((p_mot | auDessus | ~auDessous) & p_positions) == 0;
+    }
+
+    //! \brief réunit les chiffres voisins: l'octet i reçoit 10 * octet i + octet i + 1
+    inline std::uint64_t reunirPaires(std::uint64_t p_chiffres)
+    {
+        return p_chiffres * 10 + (p_chiffres >> 8);
+    }
+
+    const std::uint64_t SEPARATEURS_HEURE = 0x00003a00003a0000ULL;   //':' aux positions 2 et 5 de "HH:MM:SS"
+    const std::uint64_t MASQUE_SEPARATEURS_HEURE = 0x0000ff0000ff0000ULL;
+    const std::uint64_t CHIFFRES_HEURE = 0x8080008080008080ULL;
+    const std::uint64_t ZEROS_HEURE = 0x3030003030003030ULL;
+    const std::uint64_t CHIFFRES_DATE = 0x8080808080808080ULL;
+    const std::uint64_t ZEROS_DATE = 0x3030303030303030ULL;
+
+    /*!
+     * \brief décode "HH:MM:SS" ou "H:MM:SS" en un seul mot de 64 bits, sans branchement sur les caractères
+     * \return false si le texte n'a pas exactement cette forme (le cas général est alors traité par
+     * decomposerHeureScalaire)
+     */
+    inline bool decomposerHeureMot(const char *p_texte, std::size_t p_taille, unsigned int &p_heure,
+                                   unsigned int &p_min, unsigned int &p_sec)
+    {
+        std::uint64_t mot;
+        if (p_taille == 8)
+        {
+            mot = chargerMot(p_texte);
+        }
+        else if (p_taille == 7)
+        {
+            char tampon[8] = {'0'};
+            memcpy(tampon + 1, p_texte, 7);
+            mot = chargerMot(tampon);
+        }
+        else
+            return false;
+
+        std::uint64_t chiffres = mot & ~MASQUE_SEPARATEURS_HEURE;
+        if ((mot & MASQUE_SEPARATEURS_HEURE) != SEPARATEURS_HEURE || !chiffresValides(chiffres, CHIFFRES_HEURE))
+            return false;
+
+        std::uint64_t paires = reunirPaires(chiffres - ZEROS_HEURE);
+        p_heure = (unsigned int) (paires & 0xff);
+        p_min = (unsigned int) ((paires >> 24) & 0xff);
+        p_sec = (unsigned int) ((paires >> 48) & 0xff);
+        return true;
+    }
+
+    //! \brief décode H:MM:SS avec 1 à 3 chiffres par composante sauf les secondes, qui en ont 2
+    bool decomposerHeureScalaire(const char *p_texte, std::size_t p_taille, unsigned int &p_heure,
+                                 unsigned int &p_min, unsigned int &p_sec)
+    {
+        unsigned int composantes[3] = {0, 0, 0};
+        unsigned int k = 0;
+        unsigned int nbChiffres = 0;
+        for (const char *c = p_texte; c < p_texte + p_taille; ++c)
+        {
+            if (*c == ':' && k < 2 && nbChiffres > 0)
+            {
+                ++k;
+                nbChiffres = 0;
+            }
+            else if (*c >= '0' && *c <= '9' && nbChiffres < 3)
+            {
+                composantes[k] = composantes[k] * 10 + (unsigned int) (*c - '0');
+                ++nbChiffres;
+            }
+            else
+                return false;
+        }
+        if (k != 2 || nbChiffres != 2) return false;
+        p_heure = composantes[0];
+        p_min = composantes[1];
+        p_sec = composantes[2];
+        return true;
+    }
+
+    inline bool decomposerHeure(const char *p_texte, std::size_t p_taille, unsigned int &p_heure,
+                                unsigned int &p_min, unsigned int &p_sec)
+    {
+        return decomposerHeureMot(p_texte, p_taille, p_heure, p_min, p_sec) ||
+               decomposerHeureScalaire(p_texte, p_taille, p_heure, p_min, p_sec);
+    }
+
+    //! \brief décode "AAAAMMJJ" en un seul mot de 64 bits
+    inline bool decomposerDate(const char *p_texte, std::size_t p_taille, unsigned int &p_an, unsigned int &p_mois,
+                               unsigned int &p_jour)
+    {
+        if (p_taille != 8) return false;
+        std::uint64_t mot = chargerMot(p_texte);
+        if (!chiffresValides(mot, CHIFFRES_DATE)) return false;
+
+        std::uint64_t paires = reunirPaires(mot - ZEROS_DATE);
+        p_an = (unsigned int) (paires & 0xff) * 100 + (unsigned int) ((paires >> 16) & 0xff);
+        p_mois = (unsigned int) ((paires >> 32) & 0xff);
+        p_jour = (unsigned int) ((paires >> 48) & 0xff);
+        return true;
+    }
+}
+
+/*!
+ * \brief convertit un champ au format H:MM:SS ou HH:MM:SS en Heure (le nombre d'heures peut dépasser 24)
+ * \throws logic_error si le champ n'est pas au bon format
+ */
+Heure champVersHeure(const Champ &p_champ)
+{
+    unsigned int heure, min, sec;
+    if (!decomposerHeure(p_champ.data(), p_champ.size(), heure, min, sec))
+        throw logic_error("champVersHeure(): heure invalide");
+    return Heure(heure, min, sec);
+}
+
+/*!
+ * \brief convertit un champ au format AAAAMMJJ en Date
+ * \throws logic_error si le champ n'est pas au bon format
+ */
+Date champVersDate(const Champ &p_champ)
+{
+    unsigned int an, mois, jour;
+    if (!decomposerDate(p_champ.data(), p_champ.size(), an, mois, jour))
+        throw logic_error("champVersDate(): date invalide");
+    return Date(an, mois, jour);
+}
+
+/*!
+ * \brief convertit un texte H:MM:SS ou HH:MM:SS en code d'Heure (secondes depuis 00:00:00), sans construire d'Heure
+ * \param[in] p_texte: le premier caractère du texte
+ * \param[in] p_taille: la longueur du texte
+ * \param[out] p_code: le code, égal à Heure(h, m, s).getCode()
+ * \return false si le texte n'est pas au bon format
+ */
+bool analyserHeure(const char *p_texte, std::size_t p_taille, unsigned int &p_code)
+{
+    unsigned int heure, min, sec;
+    if (!decomposerHeure(p_texte, p_taille, heure, min, sec)) return false;
+    p_code = (heure * 60 + min) * 60 + sec;
+    return true;
+}
+
+/*!
+ * \brief convertit un texte AAAAMMJJ en code de Date, sans construire de Date
+ * \param[out] p_code: le code, égal à Date(a, m, j).getCode()
+ * \return false si le texte n'est pas au bon format
+ */
+bool analyserDate(const char *p_texte, std::size_t p_taille, int &p_code)
+{
+    unsigned int an, mois, jour;
+    if (!decomposerDate(p_texte, p_taille, an, mois, jour)) return false;
+    p_code = Date::calculerCode(an, mois, jour);
+    return true;
+}
+
+/*!
+ * \brief convertit une colonne de champs H:MM:SS en codes d'Heure
+ * \param[in] p_champs: les p_nb champs à convertir
+ * \param[out] p_codes: un tableau d'au moins p_nb codes
+ * \throws logic_error si un champ n'est pas au bon format (p_codes est alors partiellement rempli)
+ */
+void champsVersCodesHeure(const Champ *p_champs, std::size_t p_nb, unsigned int *p_codes)
+{
+    bool valides = true;
+    for (std::size_t i = 0; i < p_nb; ++i)
+    {
+        unsigned int heure = 0, min = 0, sec = 0;
+        valides &= decomposerHeure(p_champs[i].data(), p_champs[i].size(), heure, min, sec);
+        p_codes[i] = (heure * 60 + min) * 60 + sec;
+    }
+    if (!valides) throw logic_error("champsVersCodesHeure(): heure invalide");
+}
+
+/*!
+ * \brief convertit une colonne de champs AAAAMMJJ en codes de Date
+ * \param[in] p_champs: les p_nb champs à convertir
+ * \param[out] p_codes: un tableau d'au moins p_nb codes
+ * \throws logic_error si un champ n'est pas au bon format (p_codes est alors partiellement rempli)
+ */
+void champsVersCodesDate(const Champ *p_champs, std::size_t p_nb, int *p_codes)
+{
+    bool valides = true;
+    for (std::size_t i = 0; i < p_nb; ++i)
+    {
+        unsigned int an = 0, mois = 1, jour = 1;
+        valides &= decomposerDate(p_champs[i].data(), p_champs[i].size(), an, mois, jour);
+        p_codes[i] = Date::calculerCode(an, mois, jour);
+    }
+    if (!valides) throw logic_error("champsVersCodesDate(): date invalide");
+}
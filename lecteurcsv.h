@@ -0,0 +1,171 @@
+//
+// Lecture sans copie des fichiers CSV du GTFS.
+//
+
+#ifndef RTC_LECTEURCSV_H
+#define RTC_LECTEURCSV_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+#include "auxiliaires.h"
+
+class ArchiveZip;
+
+/*!
+ * \class Champ
+ * \brief Vue non propriétaire sur un champ d'un fichier CSV
+ *
+ *  Un champ n'est qu'un pointeur et une longueur dans le tampon du fichier: aucune copie n'est faite.
+ *  Les guillemets englobants et les caractères blancs du début et de la fin sont déjà retirés.
+ *  La vue n'est valide que tant que le tampon d'où elle provient (FichierMappe) existe.
+ */
+class Champ
+{
+public:
+    Champ();
+    Champ(const char *p_debut, std::size_t p_taille, bool p_guillemetsDoubles = false);
+
+    const char *data() const { return m_debut; }
+    std::size_t size() const { return m_taille; }
+    bool empty() const { return m_taille == 0; }
+    const char *begin() const { return m_debut; }
+    const char *end() const { return m_debut + m_taille; }
+    char operator[](std::size_t i) const { return m_debut[i]; }
+    bool estContigu() const { return !m_guillemetsDoubles; } //le texte du champ est exactement [begin(), end())
+
+    std::string str() const;
+    void copierDans(std::string &p_destination) const;
+
+    bool operator==(const Champ &p_other) const;
+    bool operator!=(const Champ &p_other) const;
+    bool operator==(const char *p_texte) const;
+    bool operator==(const std::string &p_texte) const;
+    friend std::ostream &operator<<(std::ostream &flux, const Champ &p_champ);
+
+private:
+    const char *m_debut;
+    std::size_t m_taille;
+    bool m_guillemetsDoubles; //le champ contient des guillemets échappés ("") à réduire lors de la copie
+};
+
+/*!
+ * \class FichierMappe
+ * \brief Projette un fichier complet en mémoire (mmap) en lecture seule
+ *
+ *  Le nom peut aussi désigner un membre d'une archive zip, comme "gtfs.zip/stop_times.txt" (voir ArchiveZip), ou
+ *  le membre être pris dans une archive déjà ouverte. Un membre compressé ouvert en différé n'est lisible qu'à mesure
+ *  qu'il est décompressé: seuls les octets que attendre() a rendus lisibles peuvent être lus.
+ *  L'objet n'est pas copiable; la projection est libérée à sa destruction.
+ */
+class FichierMappe
+{
+public:
+    explicit FichierMappe(const std::string &p_nomFichier);
+    FichierMappe(const ArchiveZip &p_archive, const std::string &p_nomMembre, bool p_differe = false);
+    ~FichierMappe();
+
+    bool estOuvert() const;
+    const char *debut() const;
+    const char *fin() const;
+    std::size_t taille() const;
+    std::size_t attendre(std::size_t p_taille) const;
+
+private:
+    struct Decompression;
+
+    FichierMappe(const FichierMappe &);
+    FichierMappe &operator=(const FichierMappe &);
+
+    void ouvrir(const std::string &p_nomFichier);
+    void ouvrirMembre(const std::string &p_nomFichier);
+    void ouvrirMembre(const ArchiveZip &p_archive, const std::string &p_nomMembre, bool p_differe);
+
+    const char *m_debut;
+    std::size_t m_taille;
+    bool m_ouvert;
+    bool m_projete; //faux si le fichier a été lu dans un tampon alloué (repli lorsque mmap échoue)
+    bool m_emprunte; //m_debut est un membre stocké, lu sans copie dans la projection de son archive
+    FichierMappe *m_archive; //l'archive ouverte par ouvrirMembre(p_nomFichier) pour un membre stocké, sinon nullptr
+    Decompression *m_decompression; //la décompression d'un membre ouvert en différé, sinon nullptr
+};
+
+/*!
+ * \class DistributeurLignes
+ * \brief Distribue un fichier à des fils de lecture, en morceaux alignés sur les lignes et numérotés dans l'ordre
+ *
+ *  Un morceau n'est donné qu'une fois lisible (FichierMappe::attendre()): un membre ouvert en différé est lu à mesure
+ *  qu'il est décompressé. prendre() peut être appelée par plusieurs fils à la fois.
+ */
+class DistributeurLignes
+{
+public:
+    DistributeurLignes(const FichierMappe &p_fichier, const char *p_debut, std::size_t p_tailleMorceau);
+
+    bool prendre(std::size_t &p_numero, const char *&p_debut, const char *&p_fin);
+
+private:
+    const FichierMappe &m_fichier;
+    const char *m_position;
+    std::size_t m_tailleMorceau;
+    std::size_t m_nbDonnes;
+    std::mutex m_mutex;
+};
+
+/*!
+ * \class LecteurCSV
+ * \brief Découpe un tampon CSV en lignes et en champs, sans allocation
+ *
+ *  Les délimiteurs, guillemets et fins de ligne sont repérés par blocs de 64 octets à l'aide de masques SIMD (SSE2),
+ *  avec un repli scalaire sur les autres architectures. Les virgules à l'intérieur de guillemets ne séparent pas les champs.
+ *  Les lignes vides sont ignorées.
+ */
+class LecteurCSV
+{
+public:
+    LecteurCSV(const char *p_debut, const char *p_fin);
+
+    bool lireLigne(std::vector<Champ> &p_champs);
+    bool lireEntete(std::vector<Champ> &p_champs);
+    bool debutLigne();
+    bool champSuivant(Champ &p_champ);
+    void finLigne();
+    const char *position() const;
+
+private:
+    const char *prochainSpecial(const char *p_position);
+    void chargerBloc(const char *p_bloc);
+
+    const char *m_debut;
+    const char *m_fin;
+    const char *m_position;
+    bool m_finDeLigne; //vrai lorsque tous les champs de la ligne courante ont été lus
+
+    const char *m_bloc;   //début du bloc de 64 octets dont le masque est en cache
+    std::uint64_t m_masque; //bit i à 1 ssi m_bloc[i] est une virgule, un guillemet ou une fin de ligne
+};
+
+//! \brief vrai pour les caractères blancs retirés autour des champs; la fin de ligne '\n' n'en fait pas partie
+inline bool estBlanc(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+std::vector<const char *> decouperSurLignes(const char *p_debut, const char *p_fin, std::size_t p_nbMorceaux);
+
+unsigned int champVersEntier(const Champ &p_champ);
+double champVersReel(const Champ &p_champ);
+Heure champVersHeure(const Champ &p_champ);
+Date champVersDate(const Champ &p_champ);
+
+bool analyserHeure(const char *p_texte, std::size_t p_taille, unsigned int &p_code);
+bool analyserDate(const char *p_texte, std::size_t p_taille, int &p_code);
+void champsVersCodesHeure(const Champ *p_champs, std::size_t p_nb, unsigned int *p_codes);
+void champsVersCodesDate(const Champ *p_champs, std::size_t p_nb, int *p_codes);
+
+#endif //RTC_LECTEURCSV_H
@@ -0,0 +1,288 @@
+//
+// Matrice des temps de parcours de chaque station vers chaque autre, à plusieurs heures de départ.
+//
+
+#include "matricetemps.h"
+#include "csa.h"
+#include "parallele.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+
+namespace
+{
+    const std::uint32_t INFINI = 0xffffffff; //heure d'arrivée d'une station non atteinte
+
+    const char MAGIE_MATRICE[8] = {'R', 'T', 'C', 'M', 'A', 'T', 'R', '\0'};
+    const std::uint32_t VERSION_MATRICE = 1;
+
+    //! \brief en-tête d'un fichier de matrice; il est suivi des codes des départs, puis des temps de m_temps
+    struct EnteteMatrice
+    {
+        char magie[8];
+        std::uint32_t version;
+        std::uint32_t nbStations;
+        std::uint32_t nbDeparts;
+        std::uint32_t dureeMax;
+    };
+}
+
+MatriceTemps::MatriceTemps() : m_nbStations(0), m_dureeMax(0)
+{
+}
+
+/*!
+ * \brief calcule les temps de parcours de chaque station de p_csa vers chaque autre, pour chaque heure de p_departs
+ * \param[in] p_csa: le planificateur dont les connexions et les transferts sont balayés; il n'est pas modifié
+ * \param[in] p_departs: les heures de départ, une tranche de la matrice par heure
+ * \param[in] p_dureeMax: en secondes; les destinations atteintes en p_dureeMax ou plus sont TEMPS_NON_ATTEINT
+ */
+void MatriceTemps::calculer(const PlanificateurCSA &p_csa, const std::vector<Heure> &p_departs,
+                            std::uint32_t p_dureeMax)
+{
+    m_nbStations = p_csa.nbStations();
+    m_dureeMax = p_dureeMax;
+    m_departs.clear();
+    for (const Heure &heure : p_departs) m_departs.push_back(heure.getCode());
+    std::size_t nbRangees = m_departs.size() * m_nbStations;
+    m_temps.assign(nbRangees * m_nbStations, TEMPS_NON_ATTEINT);
+
+    // Première connexion de chaque départ, commune à toutes les origines
+    const std::vector<Connexion> &connexions = p_csa.getConnexions();
+    std::vector<std::size_t> premieres;
+    for (std::uint32_t depart : m_departs)
+    {
+        auto premiere = std::lower_bound(connexions.begin(), connexions.end(), depart,
+                                         [](const Connexion &p_connexion, std::uint32_t p_code) {
+                                             return p_connexion.depart < p_code;
+                                         });
+        premieres.push_back(static_cast<std::size_t>(premiere - connexions.begin()));
+    }
+
+    // Un fil par Travail; chaque fil prend la prochaine rangée libre jusqu'à épuisement
+    std::size_t nbFils = std::min<std::size_t>(nbFilsDisponibles(), std::max<std::size_t>(nbRangees, 1));
+    if (m_travaux.size() < nbFils) m_travaux.resize(nbFils);
+    std::atomic<std::size_t> prochaine(0);
+    executerEnParallele(nbFils, [&](std::size_t p_fil) {
+        Travail &travail = m_travaux[p_fil];
+        travail.arrivees.resize(m_nbStations);
+        travail.aBord.resize(p_csa.getVoyages().size());
+        for (std::size_t r = prochaine++; r < nbRangees; r = prochaine++)
+        {
+            std::size_t depart = r / m_nbStations;
+            std::uint32_t de = static_cast<std::uint32_t>(r % m_nbStations);
+            balayer(p_csa, travail, de, m_departs[depart], premieres[depart], &m_temps[r * m_nbStations]);
+        }
+    });
+}
+
+void MatriceTemps::vider()
+{
+    m_nbStations = 0;
+    m_dureeMax = 0;
+    m_departs.clear();
+    m_temps.clear();
+    m_travaux.clear();
+}
+
+/*!
+ * \brief écrit la matrice dans un fichier binaire: un en-tête, les codes des départs, puis les temps sur 16 bits
+ * \param[in] p_nomFichier: le nom du fichier (écrit dans un fichier temporaire, puis renommé)
+ * \throws logic_error si l'écriture échoue
+ */
+void MatriceTemps::sauvegarder(const std::string &p_nomFichier) const
+{
+    EnteteMatrice entete;
+    memset(&entete, 0, sizeof(entete));
+    memcpy(entete.magie, MAGIE_MATRICE, sizeof(entete.magie));
+    entete.version = VERSION_MATRICE;
+    entete.nbStations = m_nbStations;
+    entete.nbDeparts = static_cast<std::uint32_t>(m_departs.size());
+    entete.dureeMax = m_dureeMax;
+
+    std::string temporaire = p_nomFichier + ".tmp";
+    {
+        std::ofstream fichier(temporaire, std::ios::binary | std::ios::trunc);
+        if (!fichier.is_open())
+            throw std::logic_error("MatriceTemps::sauvegarder(): impossible d'écrire " + temporaire);
+        fichier.write(reinterpret_cast<const char *>(&entete), sizeof(entete));
+        fichier.write(reinterpret_cast<const char *>(m_departs.data()),
+                      static_cast<std::streamsize>(m_departs.size() * sizeof(std::uint32_t)));
+        fichier.write(reinterpret_cast<const char *>(m_temps.data()),
+                      static_cast<std::streamsize>(m_temps.size() * sizeof(std::uint16_t)));
+        if (!fichier) throw std::logic_error("MatriceTemps::sauvegarder(): erreur d'écriture dans " + temporaire);
+    }
+    if (std::rename(temporaire.c_str(), p_nomFichier.c_str()) != 0)
+        throw std::logic_error("MatriceTemps::sauvegarder(): impossible de renommer " + temporaire);
+}
+
+/*!
+ * \brief remplace la matrice par celle d'un fichier écrit par sauvegarder()
+ * \return false (sans modifier l'objet) si le fichier est absent, d'une autre version, ou si sa taille n'est pas
+ * celle que donne son en-tête
+ */
+bool MatriceTemps::charger(const std::string &p_nomFichier)
+{
+    std::ifstream fichier(p_nomFichier, std::ios::binary);
+    EnteteMatrice entete;
+    if (!fichier.read(reinterpret_cast<char *>(&entete), sizeof(entete))) return false;
+    if (memcmp(entete.magie, MAGIE_MATRICE, sizeof(entete.magie)) != 0 || entete.version != VERSION_MATRICE)
+        return false;
+
+    // Avant toute allocation, l'en-tête doit donner exactement la taille du fichier; chaque produit est d'abord
+    // borné par cette taille, de sorte qu'aucun ne déborde
+    std::streamoff debut = fichier.tellg();
+    if (!fichier.seekg(0, std::ios::end)) return false;
+    std::streamoff fin = fichier.tellg();
+    if (debut < 0 || fin < debut || !fichier.seekg(debut)) return false;
+    std::uint64_t reste = static_cast<std::uint64_t>(fin - debut);
+    std::uint64_t tailleDeparts = static_cast<std::uint64_t>(entete.nbDeparts) * sizeof(std::uint32_t);
+    if (reste < tailleDeparts) return false;
+    reste -= tailleDeparts;
+    std::uint64_t nbRangees = static_cast<std::uint64_t>(entete.nbDeparts) * entete.nbStations;
+    if (entete.nbStations != 0 && nbRangees > reste / sizeof(std::uint16_t) / entete.nbStations) return false;
+    if (nbRangees * entete.nbStations * sizeof(std::uint16_t) != reste) return false;
+
+    std::vector<std::uint32_t> departs(entete.nbDeparts);
+    std::vector<std::uint16_t> temps(static_cast<std::size_t>(nbRangees * entete.nbStations));
+    fichier.read(reinterpret_cast<char *>(departs.data()),
+                 static_cast<std::streamsize>(departs.size() * sizeof(std::uint32_t)));
+    fichier.read(reinterpret_cast<char *>(temps.data()),
+                 static_cast<std::streamsize>(temps.size() * sizeof(std::uint16_t)));
+    if (!fichier || fichier.peek() != std::ifstream::traits_type::eof()) return false;
+
+    m_nbStations = entete.nbStations;
+    m_dureeMax = entete.dureeMax;
+    m_departs.swap(departs);
+    m_temps.swap(temps);
+    return true;
+}
+
+/*!
+ * \brief le temps de parcours de p_de à p_vers en partant à la p_depart-ième heure de départ
+ * \return des minutes, ou TEMPS_NON_ATTEINT
+ * \throws logic_error si un indice est hors borne
+ */
+std::uint16_t MatriceTemps::minutes(std::size_t p_depart, std::uint32_t p_de, std::uint32_t p_vers) const
+{
+    if (p_vers >= m_nbStations) throw std::logic_error("MatriceTemps::minutes(): station hors borne");
+    return rangee(p_depart, p_de)[p_vers];
+}
+
+/*!
+ * \brief les nbStations() temps de parcours de p_de vers chaque station, en partant à la p_depart-ième heure
+ * \throws logic_error si un indice est hors borne
+ */
+const std::uint16_t *MatriceTemps::rangee(std::size_t p_depart, std::uint32_t p_de) const
+{
+    if (p_depart >= m_departs.size() || p_de >= m_nbStations)
+    {
+        throw std::logic_error("MatriceTemps::rangee(): indice hors borne");
+    }
+    return &m_temps[(p_depart * m_nbStations + p_de) * m_nbStations];
+}
+
+std::size_t MatriceTemps::nbDeparts() const
+{
+    return m_departs.size();
+}
+
+std::uint32_t MatriceTemps::nbStations() const
+{
+    return m_nbStations;
+}
+
+//! \brief la durée, en secondes, à partir de laquelle une destination est TEMPS_NON_ATTEINT
+std::uint32_t MatriceTemps::dureeMax() const
+{
+    return m_dureeMax;
+}
+
+//! \brief les codes des heures de départ, dans l'ordre des tranches de la matrice
+const std::vector<std::uint32_t> &MatriceTemps::getDeparts() const
+{
+    return m_departs;
+}
+
+/*!
+ * \brief arrivées les plus tôt de p_de vers toutes les stations, en partant à p_depart, converties en minutes
+ * dans p_rangee
+ * \param[in] p_premiere: la position de la première connexion qui part à p_depart ou après
+ */
+void MatriceTemps::balayer(const PlanificateurCSA &p_csa, Travail &p_travail, std::uint32_t p_de,
+                           std::uint32_t p_depart, std::size_t p_premiere, std::uint16_t *p_rangee) const
+{
+    const std::vector<Connexion> &connexions = p_csa.getConnexions();
+    const GrapheTransferts &transferts = p_csa.getTransferts();
+    std::vector<std::uint32_t> &arrivees = p_travail.arrivees;
+    std::fill(arrivees.begin(), arrivees.end(), INFINI);
+    std::fill(p_travail.aBord.begin(), p_travail.aBord.end(), 0);
+
+    //les transferts de la fermeture à partir de p_station, par durée croissante, sauf ceux de moins de p_minimum
+    //secondes; une arrivée à limite ou après ne compte plus. Une station améliorée par un transfert assez long pour
+    //qu'un enchaînement plus long que la borne de la fermeture la prolonge (GrapheTransferts::prolongement()) est mise
+    //en attente, avec ses seuls transferts que la fermeture ne couvre pas déjà (GrapheTransferts::borne())
+    std::uint32_t limite = p_depart + std::min(m_dureeMax, INFINI - p_depart);
+    std::vector<Prolongement> &tas = p_travail.tas;
+    tas.clear();
+    auto marcher = [&](std::uint32_t p_station, std::uint32_t p_minimum) {
+        std::uint32_t depart = arrivees[p_station];
+        PlageTransferts plage = transferts.plage(p_station);
+        const Transfert *premier = std::partition_point(plage.begin(), plage.end(), [&](const Transfert &p_t) {
+            return p_t.temps < p_minimum;
+        });
+        for (const Transfert *transfert = premier; transfert != plage.end(); ++transfert)
+        {
+            std::uint32_t arrivee = depart + transfert->temps;
+            if (arrivee >= limite) break;
+            if (arrivee >= arrivees[transfert->vers]) continue;
+            arrivees[transfert->vers] = arrivee;
+            if (transfert->temps < transferts.prolongement(transfert->vers)) continue;
+            std::uint32_t borne = transferts.borne();
+            std::uint32_t minimum = transfert->temps > borne ? 0 : borne - transfert->temps + 1;
+            tas.push_back(Prolongement(arrivee, transfert->vers, minimum));
+            std::push_heap(tas.begin(), tas.end(), std::greater<Prolongement>());
+        }
+    };
+    //les stations en attente où l'on arrive au plus tard à p_heure partent à leur tour, par arrivée croissante: une
+    //station que les connexions ont améliorée entre-temps est déjà partie, et ne repart pas
+    auto prolonger = [&](std::uint32_t p_heure) {
+        while (!tas.empty() && std::get<0>(tas.front()) <= p_heure)
+        {
+            std::pop_heap(tas.begin(), tas.end(), std::greater<Prolongement>());
+            std::uint32_t arrivee, station, minimum;
+            std::tie(arrivee, station, minimum) = tas.back();
+            tas.pop_back();
+            if (arrivee == arrivees[station]) marcher(station, minimum);
+        }
+    };
+
+    arrivees[p_de] = p_depart;
+    marcher(p_de, 0);
+    for (std::size_t i = p_premiere; i < connexions.size(); ++i)
+    {
+        const Connexion &connexion = connexions[i];
+        if (connexion.depart >= limite) break;
+        prolonger(connexion.depart);
+        if (!p_travail.aBord[connexion.voyage])
+        {
+            if (arrivees[connexion.de] > connexion.depart) continue;
+            p_travail.aBord[connexion.voyage] = 1;
+        }
+        if (connexion.arrivee >= arrivees[connexion.vers]) continue;
+        arrivees[connexion.vers] = connexion.arrivee;
+        marcher(connexion.vers, 0);
+    }
+    prolonger(INFINI);
+
+    for (std::uint32_t s = 0; s < m_nbStations; ++s)
+    {
+        std::uint32_t duree = arrivees[s] - p_depart;
+        if (arrivees[s] == INFINI || duree >= m_dureeMax) continue;
+        p_rangee[s] = static_cast<std::uint16_t>(std::min<std::uint32_t>((duree + 59) / 60, TEMPS_NON_ATTEINT - 1));
+    }
+}
@@ -0,0 +1,78 @@
+//
+// Matrice des temps de parcours de chaque station vers chaque autre, à plusieurs heures de départ.
+//
+
+#ifndef RTC_MATRICETEMPS_H
+#define RTC_MATRICETEMPS_H
+
+#include <vector>
+#include <tuple>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "auxiliaires.h"
+
+class PlanificateurCSA;
+
+const std::uint16_t TEMPS_NON_ATTEINT = 0xffff; //case d'une destination non atteinte dans la durée maximale
+
+/*!
+ * \class MatriceTemps
+ * \brief Les temps de parcours, en minutes, de chaque station vers chaque autre pour quelques heures de départ
+ *
+ *  Chaque rangée (heure de départ, origine) est calculée par un seul balayage CSA vers toutes les stations: le
+ *  balayage suit les connexions de PlanificateurCSA à partir de l'heure de départ, sans destination pour l'arrêter,
+ *  jusqu'à ce que les départs dépassent la durée maximale. Les rangées sont réparties entre nbFilsDisponibles() fils;
+ *  chaque fil garde ses propres tableaux de travail d'une origine à l'autre et le planificateur n'est que lu, de
+ *  sorte que les fils ne partagent rien en écriture sauf leurs rangées, disjointes, de la matrice.
+ *
+ *  Un temps compte l'attente à l'origine: c'est l'arrivée la plus tôt moins l'heure de départ, arrondie à la minute
+ *  supérieure et rangée sur 16 bits; une durée de p_dureeMax ou plus est TEMPS_NON_ATTEINT. Comme dans
+ *  PlanificateurCSA::trouver(), les transferts partent de l'origine et des stations améliorées par une connexion,
+ *  et sont tirés de la fermeture calculée par PlanificateurCSA::construire(). Contrairement à trouver(), une marche
+ *  plus longue que la borne de cette fermeture n'est pas perdue: les stations où elle doit se prolonger
+ *  (GrapheTransferts::prolongement()) partent à leur tour lorsque le balayage atteint leur arrivée, à moins qu'une
+ *  connexion ne les ait améliorées entre-temps, de sorte que les temps sont ceux de transferts enchaînés sans borne.
+ *
+ *  Les mesures n'ont été faites que sur un seul cœur: le passage à l'échelle, jusqu'à 64 cœurs, n'a pas été mesuré.
+ */
+class MatriceTemps
+{
+public:
+    MatriceTemps();
+
+    void calculer(const PlanificateurCSA &p_csa, const std::vector<Heure> &p_departs,
+                  std::uint32_t p_dureeMax = 24 * 3600);
+    void vider();
+    void sauvegarder(const std::string &p_nomFichier) const;
+    bool charger(const std::string &p_nomFichier);
+
+    std::uint16_t minutes(std::size_t p_depart, std::uint32_t p_de, std::uint32_t p_vers) const;
+    const std::uint16_t *rangee(std::size_t p_depart, std::uint32_t p_de) const;
+    std::size_t nbDeparts() const;
+    std::uint32_t nbStations() const;
+    std::uint32_t dureeMax() const;
+    const std::vector<std::uint32_t> &getDeparts() const;
+
+private:
+    //(arrivée, station, durée minimale de ses transferts à suivre) d'une station où une marche se prolonge
+    typedef std::tuple<std::uint32_t, std::uint32_t, std::uint32_t> Prolongement;
+
+    struct Travail
+    {
+        std::vector<std::uint32_t> arrivees; //par station
+        std::vector<std::uint8_t> aBord;     //par rang de voyage
+        std::vector<Prolongement> tas;       //stations dont les transferts restent à suivre
+    };
+
+    void balayer(const PlanificateurCSA &p_csa, Travail &p_travail, std::uint32_t p_de, std::uint32_t p_depart,
+                 std::size_t p_premiere, std::uint16_t *p_rangee) const;
+
+    std::uint32_t m_nbStations;
+    std::uint32_t m_dureeMax;             //en secondes
+    std::vector<std::uint32_t> m_departs; //codes des heures de départ
+    std::vector<std::uint16_t> m_temps;   //départ par départ, puis origine par origine: nbStations() par rangée
+    std::vector<Travail> m_travaux;       //un par fil, gardés d'un calcul à l'autre
+};
+
+#endif //RTC_MATRICETEMPS_H
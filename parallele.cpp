@@ -0,0 +1,255 @@
+//
+// Outils d'exécution parallèle.
+//
+
+#include "parallele.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/*!
+ * \brief retourne le nombre de fils d'exécution que la machine peut exécuter simultanément (au moins 1)
+ */
+unsigned int nbFilsDisponibles()
+{
+    unsigned int n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/*!
+ * \brief exécute p_tache(0), ..., p_tache(p_nbTaches - 1) sur au plus nbFilsDisponibles() fils d'exécution
+ * \brief Le fil appelant participe au travail; la fonction retourne lorsque toutes les tâches sont terminées
+ * \param[in] p_nbTaches: le nombre de tâches
+ * \param[in] p_tache: la tâche à exécuter, qui reçoit son numéro
+ * \throws la première exception lancée par une tâche, une fois toutes les tâches terminées
+ */
+void executerEnParallele(std::size_t p_nbTaches, const std::function<void(std::size_t)> &p_tache)
+{
+    std::atomic<std::size_t> prochaine(0);
+    std::exception_ptr erreur;
+    std::mutex mutexErreur;
+
+    auto travailler = [&]()
+    {
+        for (std::size_t i = prochaine++; i < p_nbTaches; i = prochaine++)
+        {
+            try
+            {
+                p_tache(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> verrou(mutexErreur);
+                if (!erreur) erreur = std::current_exception();
+            }
+        }
+    };
+
+    std::size_t nbFils = std::min<std::size_t>(p_nbTaches, nbFilsDisponibles());
+    std::vector<std::thread> fils;
+    for (std::size_t k = 1; k < nbFils; ++k) fils.emplace_back(travailler);
+    travailler();
+    for (auto &f : fils) f.join();
+
+    if (erreur) std::rethrow_exception(erreur);
+}
+
+namespace
+{
+    const unsigned int BITS_PAR_PASSE = 11;
+    const std::size_t NB_CASES = std::size_t(1) << BITS_PAR_PASSE;
+    const std::size_t TAILLE_MIN_MORCEAU_TRI = 1 << 16;
+}
+
+/*!
+ * \brief trie les paires (p_cles[i], p_valeurs[i]) par clé croissante; le tri est stable
+ * \brief Tri par base (LSD), 11 bits par passe, seulement pour les bits utilisés par la plus grande clé. Chaque passe
+ * compte puis distribue les paires par morceaux contigus, un fil par morceau: les comptes de chaque morceau donnent
+ * directement sa position de départ dans chaque case, ce qui garde le tri stable
+ * \param[in,out] p_cles: les clés
+ * \param[in,out] p_valeurs: les valeurs qui les accompagnent
+ * \throws logic_error si les deux vecteurs n'ont pas la même taille
+ */
+void trierParCles(std::vector<std::uint32_t> &p_cles, std::vector<std::uint32_t> &p_valeurs)
+{
+    if (p_cles.size() != p_valeurs.size()) throw std::logic_error("trierParCles(): tailles différentes");
+    std::size_t n = p_cles.size();
+    if (n < 2) return;
+
+    std::uint32_t cleMax = *std::max_element(p_cles.begin(), p_cles.end());
+    std::size_t nbMorceaux = std::min<std::size_t>(nbFilsDisponibles(), 1 + n / TAILLE_MIN_MORCEAU_TRI);
+    std::vector<std::size_t> bornes(nbMorceaux + 1);
+    for (std::size_t k = 0; k <= nbMorceaux; ++k) bornes[k] = n * k / nbMorceaux;
+
+    std::vector<std::uint32_t> cles(n);
+    std::vector<std::uint32_t> valeurs(n);
+    std::vector<std::size_t> positions(nbMorceaux * NB_CASES);
+    for (unsigned int decalage = 0; decalage < 32 && (cleMax >> decalage) != 0; decalage += BITS_PAR_PASSE)
+    {
+        executerEnParallele(nbMorceaux, [&](std::size_t k) {
+            std::size_t *compte = &positions[k * NB_CASES];
+            std::fill(compte, compte + NB_CASES, 0);
+            for (std::size_t i = bornes[k]; i < bornes[k + 1]; ++i) ++compte[(p_cles[i] >> decalage) & (NB_CASES - 1)];
+        });
+
+        // Position de départ du morceau k dans la case c: tout ce qui précède c, puis les morceaux < k dans c
+        std::size_t total = 0;
+        for (std::size_t c = 0; c < NB_CASES; ++c)
+        {
+            for (std::size_t k = 0; k < nbMorceaux; ++k)
+            {
+                std::size_t compte = positions[k * NB_CASES + c];
+                positions[k * NB_CASES + c] = total;
+                total += compte;
+            }
+        }
+
+        executerEnParallele(nbMorceaux, [&](std::size_t k) {
+            std::size_t *prochaine = &positions[k * NB_CASES];
+            for (std::size_t i = bornes[k]; i < bornes[k + 1]; ++i)
+            {
+                std::size_t j = prochaine[(p_cles[i] >> decalage) & (NB_CASES - 1)]++;
+                cles[j] = p_cles[i];
+                valeurs[j] = p_valeurs[i];
+            }
+        });
+        p_cles.swap(cles);
+        p_valeurs.swap(valeurs);
+    }
+}
+
+/*!
+ * \brief ajoute une tâche au graphe
+ * \param[in] p_nom: le nom de la tâche, pour l'affichage des durées
+ * \param[in] p_tache: la fonction à exécuter
+ * \param[in] p_dependances: les numéros des tâches qui doivent être terminées avant que celle-ci démarre
+ * \return le numéro de la tâche
+ * \throws logic_error si une dépendance n'a pas encore été ajoutée
+ */
+std::size_t GrapheDeTaches::ajouter(const std::string &p_nom, const std::function<void()> &p_tache,
+                                    const std::vector<std::size_t> &p_dependances)
+{
+    std::size_t numero = m_taches.size();
+    for (std::size_t d : p_dependances)
+    {
+        if (d >= numero) throw std::logic_error("GrapheDeTaches::ajouter(): dépendance inconnue");
+    }
+
+    Tache tache;
+    tache.nom = p_nom;
+    tache.fonction = p_tache;
+    tache.nbDependances = p_dependances.size();
+    tache.debut = 0;
+    tache.duree = 0;
+    m_taches.push_back(tache);
+    for (std::size_t d : p_dependances) m_taches[d].suivantes.push_back(numero);
+    return numero;
+}
+
+/*!
+ * \brief exécute toutes les tâches en respectant leurs dépendances, sur au plus nbFilsDisponibles() fils
+ * \brief Le fil appelant participe au travail; la fonction retourne lorsque toutes les tâches sont terminées
+ * \throws la première exception lancée par une tâche; les tâches qui n'ont pas encore démarré ne sont pas exécutées
+ */
+void GrapheDeTaches::executer()
+{
+    std::vector<std::size_t> restantes(m_taches.size());
+    std::deque<std::size_t> pretes;
+    for (std::size_t i = 0; i < m_taches.size(); ++i)
+    {
+        restantes[i] = m_taches[i].nbDependances;
+        if (restantes[i] == 0) pretes.push_back(i);
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::size_t enCours = 0;
+    std::exception_ptr erreur;
+    const auto origine = std::chrono::steady_clock::now();
+
+    auto travailler = [&]()
+    {
+        std::unique_lock<std::mutex> verrou(mutex);
+        for (;;)
+        {
+            // Rien de prêt et rien en cours: toutes les tâches sont terminées (ou abandonnées après une erreur)
+            condition.wait(verrou, [&]() { return !pretes.empty() || enCours == 0; });
+            if (pretes.empty())
+            {
+                condition.notify_all();
+                return;
+            }
+            std::size_t i = pretes.front();
+            pretes.pop_front();
+            ++enCours;
+            verrou.unlock();
+
+            Tache &tache = m_taches[i];
+            std::exception_ptr erreurTache;
+            auto debut = std::chrono::steady_clock::now();
+            try
+            {
+                tache.fonction();
+            }
+            catch (...)
+            {
+                erreurTache = std::current_exception();
+            }
+            auto fin = std::chrono::steady_clock::now();
+            tache.debut = std::chrono::duration<double>(debut - origine).count();
+            tache.duree = std::chrono::duration<double>(fin - debut).count();
+
+            verrou.lock();
+            --enCours;
+            if (erreurTache && !erreur) erreur = erreurTache;
+            if (erreur)
+            {
+                pretes.clear();
+            }
+            else
+            {
+                for (std::size_t s : tache.suivantes)
+                {
+                    if (--restantes[s] == 0) pretes.push_back(s);
+                }
+            }
+            condition.notify_all();
+        }
+    };
+
+    std::size_t nbFils = std::min<std::size_t>(m_taches.size(), nbFilsDisponibles());
+    std::vector<std::thread> fils;
+    for (std::size_t k = 1; k < nbFils; ++k) fils.emplace_back(travailler);
+    travailler();
+    for (auto &f : fils) f.join();
+
+    if (erreur) std::rethrow_exception(erreur);
+}
+
+std::size_t GrapheDeTaches::taille() const
+{
+    return m_taches.size();
+}
+
+const std::string &GrapheDeTaches::nom(std::size_t p_tache) const
+{
+    return m_taches.at(p_tache).nom;
+}
+
+double GrapheDeTaches::debut(std::size_t p_tache) const
+{
+    return m_taches.at(p_tache).debut;
+}
+
+double GrapheDeTaches::duree(std::size_t p_tache) const
+{
+    return m_taches.at(p_tache).duree;
+}
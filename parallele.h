@@ -0,0 +1,52 @@
+//
+// Outils d'exécution parallèle.
+//
+
+#ifndef RTC_PARALLELE_H
+#define RTC_PARALLELE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+unsigned int nbFilsDisponibles();
+void executerEnParallele(std::size_t p_nbTaches, const std::function<void(std::size_t)> &p_tache);
+void trierParCles(std::vector<std::uint32_t> &p_cles, std::vector<std::uint32_t> &p_valeurs);
+
+/*!
+ * \class GrapheDeTaches
+ * \brief Tâches nommées reliées par leurs dépendances, exécutées sur un groupe de fils
+ *
+ *  Une tâche démarre dès que toutes ses dépendances sont terminées; les tâches indépendantes s'exécutent en même
+ *  temps. Une dépendance doit avoir été ajoutée avant la tâche qui en dépend, ce qui exclut les cycles.
+ *  Le début et la durée de chaque tâche sont mesurés à partir du début de executer().
+ */
+class GrapheDeTaches
+{
+public:
+    std::size_t ajouter(const std::string &p_nom, const std::function<void()> &p_tache,
+                        const std::vector<std::size_t> &p_dependances = std::vector<std::size_t>());
+    void executer();
+
+    std::size_t taille() const;
+    const std::string &nom(std::size_t p_tache) const;
+    double debut(std::size_t p_tache) const;
+    double duree(std::size_t p_tache) const;
+
+private:
+    struct Tache
+    {
+        std::string nom;
+        std::function<void()> fonction;
+        std::vector<std::size_t> suivantes; //tâches qui dépendent de celle-ci
+        std::size_t nbDependances;
+        double debut;  //en secondes depuis le début de executer()
+        double duree;  //en secondes
+    };
+
+    std::vector<Tache> m_taches;
+};
+
+#endif //RTC_PARALLELE_H
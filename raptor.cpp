@@ -0,0 +1,650 @@
+//
+// Planificateur d'itinéraires RAPTOR: arrivée la plus tôt, par rondes de voyages.
+//
+
+#include "raptor.h"
+#include "DonneesGTFS.h"
+#include "parallele.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace
+{
+    const std::uint32_t INFINI = 0xffffffff; //heure d'arrivée d'une station non atteinte
+    const std::uint32_t AUCUN = TableIdentifiants::ABSENT;
+    //au-delà de ce nombre de départs possibles, un profil par sauts (profilParSauts()) coûte moins que rRAPTOR
+    const std::size_t MAX_DEPARTS_RRAPTOR = 100;
+
+    //! \brief vrai si le voyage p_apres ne dépasse jamais p_avant: il n'arrive ni ne part avant lui à aucune station
+    bool suit(const PlageArrets &p_avant, const PlageArrets &p_apres)
+    {
+        for (std::size_t i = 0; i < p_avant.nombre; ++i)
+        {
+            if (p_apres.arrivees[i] < p_avant.arrivees[i] || p_apres.departs[i] < p_avant.departs[i]) return false;
+        }
+        return true;
+    }
+}
+
+PlanificateurRaptor::PlanificateurRaptor() : m_nbStations(0), m_dernierDepart(0)
+{
+}
+
+/*!
+ * \brief reconstruit les parcours, les passages par station et les transferts à partir des voyages de p_donnees
+ *
+ *  Les voyages sont triés par suite de stations, puis par heure de départ; ceux d'une même suite sont répartis
+ *  entre le moins de parcours possible, chaque voyage allant au premier parcours dont le dernier voyage le précède
+ *  partout. Les voyages de moins de deux arrêts ne mènent nulle part et sont ignorés.
+ */
+void PlanificateurRaptor::construire(const DonneesGTFS &p_donnees)
+{
+    vider();
+    m_nbStations = static_cast<std::uint32_t>(p_donnees.getIdsStations().taille());
+    const Registre<Voyage> &voyages = p_donnees.getVoyages();
+
+    std::vector<std::uint32_t> ordre;
+    ordre.reserve(voyages.size());
+    for (auto voyageM : voyages)
+    {
+        if (voyageM.second.getNbArrets() >= 2) ordre.push_back(voyageM.first);
+    }
+    std::sort(ordre.begin(), ordre.end(), [&voyages](std::uint32_t a, std::uint32_t b) {
+        const PlageArrets &arretsA = voyages[a].getArrets();
+        const PlageArrets &arretsB = voyages[b].getArrets();
+        if (arretsA.nombre != arretsB.nombre) return arretsA.nombre < arretsB.nombre;
+        int comparaison = std::memcmp(arretsA.stations, arretsB.stations, arretsA.nombre * sizeof(std::uint32_t));
+        if (comparaison != 0) return comparaison < 0;
+        if (arretsA.departs[0] != arretsB.departs[0]) return arretsA.departs[0] < arretsB.departs[0];
+        return a < b;
+    });
+
+    std::vector<std::vector<std::uint32_t> > groupes; //les parcours d'une même suite de stations
+    for (std::size_t debut = 0, fin; debut < ordre.size(); debut = fin)
+    {
+        const PlageArrets &premier = voyages[ordre[debut]].getArrets();
+        for (fin = debut + 1; fin < ordre.size(); ++fin)
+        {
+            const PlageArrets &arrets = voyages[ordre[fin]].getArrets();
+            if (arrets.nombre != premier.nombre ||
+                std::memcmp(arrets.stations, premier.stations, arrets.nombre * sizeof(std::uint32_t)) != 0) break;
+        }
+
+        groupes.clear();
+        for (std::size_t i = debut; i < fin; ++i)
+        {
+            const PlageArrets &arrets = voyages[ordre[i]].getArrets();
+            std::size_t g = 0;
+            while (g < groupes.size() && !suit(voyages[groupes[g].back()].getArrets(), arrets)) ++g;
+            if (g == groupes.size()) groupes.push_back(std::vector<std::uint32_t>());
+            groupes[g].push_back(ordre[i]);
+        }
+
+        std::uint32_t nbStations = static_cast<std::uint32_t>(premier.nombre);
+        for (const std::vector<std::uint32_t> &groupe : groupes)
+        {
+            Parcours parcours;
+            parcours.debutStations = static_cast<std::uint32_t>(m_stationsParcours.size());
+            parcours.nbStations = nbStations;
+            parcours.debutVoyages = static_cast<std::uint32_t>(m_voyagesParcours.size());
+            parcours.nbVoyages = static_cast<std::uint32_t>(groupe.size());
+            parcours.debutHoraires = static_cast<std::uint32_t>(m_arriveesParcours.size());
+            m_parcours.push_back(parcours);
+            m_stationsParcours.insert(m_stationsParcours.end(), premier.stations, premier.stations + nbStations);
+            for (std::uint32_t voyage : groupe)
+            {
+                const PlageArrets &arrets = voyages[voyage].getArrets();
+                m_voyagesParcours.push_back(voyage);
+                m_arriveesParcours.insert(m_arriveesParcours.end(), arrets.arrivees, arrets.arrivees + nbStations);
+                m_departsParcours.insert(m_departsParcours.end(), arrets.departs, arrets.departs + nbStations);
+            }
+        }
+    }
+
+    // Passages par station, par dénombrement
+    m_debutsPassages.assign(static_cast<std::size_t>(m_nbStations) + 1, 0);
+    for (std::uint32_t station : m_stationsParcours) ++m_debutsPassages[station + 1];
+    for (std::uint32_t s = 0; s < m_nbStations; ++s) m_debutsPassages[s + 1] += m_debutsPassages[s];
+    std::vector<std::uint32_t> positions(m_debutsPassages.begin(), m_debutsPassages.end() - 1);
+    m_passages.resize(m_stationsParcours.size());
+    for (std::uint32_t r = 0; r < m_parcours.size(); ++r)
+    {
+        for (std::uint32_t p = 0; p < m_parcours[r].nbStations; ++p)
+        {
+            Passage &passage = m_passages[positions[m_stationsParcours[m_parcours[r].debutStations + p]]++];
+            passage.parcours = r;
+            passage.position = p;
+        }
+    }
+
+    if (!m_departsParcours.empty())
+    {
+        m_dernierDepart = *std::max_element(m_departsParcours.begin(), m_departsParcours.end());
+    }
+    m_transferts = p_donnees.getGrapheTransferts();
+}
+
+void PlanificateurRaptor::vider()
+{
+    m_nbStations = 0;
+    m_dernierDepart = 0;
+    m_parcours.clear();
+    m_stationsParcours.clear();
+    m_voyagesParcours.clear();
+    m_arriveesParcours.clear();
+    m_departsParcours.clear();
+    m_debutsPassages.clear();
+    m_passages.clear();
+    m_transferts.vider();
+    m_travail = Travail();
+}
+
+/*!
+ * \brief l'itinéraire qui arrive le plus tôt à p_vers en partant de p_de à p_depart, avec le moins de changements
+ * de voyage parmi ceux qui arrivent à cette heure
+ * \param[in] p_maxTransferts: le nombre maximal de changements de voyage; les transferts à pied avant le premier
+ * voyage et après le dernier ne comptent pas
+ * \return un itinéraire dont existe est false si p_vers n'est pas atteignable dans ces bornes
+ * \throws logic_error si p_de ou p_vers n'est pas une station du réseau
+ */
+Itineraire PlanificateurRaptor::trouver(std::uint32_t p_de, std::uint32_t p_vers, const Heure &p_depart,
+                                        unsigned int p_maxTransferts)
+{
+    verifier(p_de, p_vers, "PlanificateurRaptor::trouver()");
+    // La ronde 0 ne contient que l'origine et les transferts qui en partent; la ronde k, k voyages
+    unsigned int nbRondes = p_maxTransferts + 2;
+    preparer(m_travail, nbRondes);
+    executer(m_travail, p_de, p_vers, p_depart.getCode(), nbRondes);
+    return reconstituer(m_travail, p_vers, p_depart);
+}
+
+/*!
+ * \brief le profil de p_de à p_vers: pour chaque départ de [p_debut, p_fin) qui n'est dominé par aucun autre (un
+ * départ plus tard arrive aussi tôt), l'itinéraire qui arrive le plus tôt
+ *
+ *  Les départs possibles sont ceux des voyages à p_de, et ceux des stations atteintes à pied moins la durée de la
+ *  marche, sans ceux qu'un départ plus tard domine d'avance (voir departsPossibles()). Jusqu'à MAX_DEPARTS_RRAPTOR
+ *  départs possibles, ils sont exécutés du plus tard au plus tôt (profilTranche()); au-delà, ce qui arrive dès que
+ *  la marche depuis p_de atteint beaucoup de stations, le profil est obtenu par sauts (profilParSauts()).
+ *  Avec p_nbTranches > 1, ils sont partagés en tranches contiguës traitées en parallèle, chacune avec ses tableaux
+ *  de travail; une tranche ne profite pas des arrivées des départs plus tardifs des autres tranches, et les
+ *  itinéraires dominés par une tranche plus tardive sont retirés à la fin.
+ * \param[in] p_maxTransferts: comme pour trouver()
+ * \param[in] p_nbTranches: le nombre de tranches de départs; 1 pour tout traiter dans ce fil
+ * \return les itinéraires par départ croissant (et donc par arrivée strictement croissante); depart est l'heure de
+ * départ de p_de, ou du transfert à pied qui commence l'itinéraire
+ * \throws logic_error si p_de ou p_vers n'est pas une station du réseau
+ */
+std::vector<Itineraire> PlanificateurRaptor::profil(std::uint32_t p_de, std::uint32_t p_vers, const Heure &p_debut,
+                                                    const Heure &p_fin, unsigned int p_maxTransferts,
+                                                    std::size_t p_nbTranches)
+{
+    verifier(p_de, p_vers, "PlanificateurRaptor::profil()");
+    unsigned int nbRondes = p_maxTransferts + 2;
+    std::uint32_t marcheDirecte;
+    std::vector<DepartPossible> departs = departsPossibles(p_de, p_vers, p_debut.getCode(), p_fin.getCode(),
+                                                           marcheDirecte);
+    bool parSauts = departs.size() > MAX_DEPARTS_RRAPTOR;
+    auto traiter = [&](Travail &p_travail, const DepartPossible *p_departs, std::size_t p_nbDeparts,
+                       std::vector<Itineraire> &p_profil) {
+        if (parSauts)
+        {
+            profilParSauts(p_travail, p_de, p_vers, p_fin.getCode(), p_departs, p_nbDeparts, nbRondes, p_profil);
+        }
+        else
+        {
+            profilTranche(p_travail, p_de, p_vers, p_departs, p_nbDeparts, nbRondes, p_profil);
+        }
+    };
+    std::vector<Itineraire> profil;
+    std::size_t nbTranches = std::max<std::size_t>(1, std::min(p_nbTranches, departs.size()));
+    if (nbTranches == 1)
+    {
+        traiter(m_travail, departs.data(), departs.size(), profil);
+    }
+    else
+    {
+        std::vector<Travail> travaux(nbTranches);
+        std::vector<std::vector<Itineraire> > partiels(nbTranches);
+        executerEnParallele(nbTranches, [&](std::size_t k) {
+            std::size_t debut = departs.size() * k / nbTranches;
+            std::size_t fin = departs.size() * (k + 1) / nbTranches;
+            traiter(travaux[k], departs.data() + debut, fin - debut, partiels[k]);
+        });
+        // Les tranches vont des départs les plus tardifs aux plus tôt: un itinéraire est gardé s'il arrive plus
+        // tôt que tous ceux qui partent plus tard
+        std::uint32_t meilleure = INFINI;
+        for (std::vector<Itineraire> &partiel : partiels)
+        {
+            for (Itineraire &itineraire : partiel)
+            {
+                if (itineraire.arrivee.getCode() >= meilleure) continue;
+                meilleure = itineraire.arrivee.getCode();
+                profil.push_back(std::move(itineraire));
+            }
+        }
+    }
+    // Un itinéraire qui ne bat pas la marche directe, à partir de son départ, n'est pas gardé
+    profil.erase(std::remove_if(profil.begin(), profil.end(), [&](const Itineraire &p_itineraire) {
+        return marcheDirecte != INFINI &&
+               p_itineraire.arrivee.getCode() - p_itineraire.depart.getCode() >= marcheDirecte;
+    }), profil.end());
+    std::reverse(profil.begin(), profil.end());
+    return profil;
+}
+
+//! \brief le nombre de parcours: les voyages regroupés par suite de stations
+std::size_t PlanificateurRaptor::nbParcours() const
+{
+    return m_parcours.size();
+}
+
+//! \brief le nombre de voyages rangés dans les parcours
+std::size_t PlanificateurRaptor::nbVoyages() const
+{
+    return m_voyagesParcours.size();
+}
+
+//! \brief borne des identifiants de stations acceptés par trouver() et profil()
+std::uint32_t PlanificateurRaptor::nbStations() const
+{
+    return m_nbStations;
+}
+
+//! \throws logic_error si p_de ou p_vers n'est pas une station du réseau
+void PlanificateurRaptor::verifier(std::uint32_t p_de, std::uint32_t p_vers, const char *p_methode) const
+{
+    if (p_de >= m_nbStations || p_vers >= m_nbStations)
+    {
+        throw std::logic_error(std::string(p_methode) + ": station hors borne");
+    }
+}
+
+//! \brief dimensionne p_travail pour p_nbRondes rondes et oublie toutes ses arrivées; seule la rangée de la ronde 0
+//! est remise à neuf, les suivantes le sont à leur première ronde
+void PlanificateurRaptor::preparer(Travail &p_travail, unsigned int p_nbRondes) const
+{
+    std::size_t taille = static_cast<std::size_t>(p_nbRondes) * m_nbStations;
+    if (p_travail.arrivees.size() < taille)
+    {
+        p_travail.arrivees.resize(taille);
+        p_travail.parents.resize(taille);
+    }
+    std::fill(p_travail.arrivees.begin(), p_travail.arrivees.begin() + m_nbStations, INFINI);
+    p_travail.nbRangees = 1;
+    if (p_travail.marquees.size() != m_nbStations) p_travail.marquees.assign(m_nbStations, 0);
+    if (p_travail.ameliorees.size() != m_nbStations) p_travail.ameliorees.assign(m_nbStations, 0);
+    if (p_travail.premieres.size() != m_parcours.size()) p_travail.premieres.assign(m_parcours.size(), AUCUN);
+}
+
+/*!
+ * \brief une exécution de RAPTOR depuis p_de à p_depart, sans oublier les arrivées déjà dans p_travail
+ *
+ *  Les arrivées déjà présentes, celles de départs plus tardifs, restent atteignables: seules les stations que ce
+ *  départ améliore sont marquées. Chaque rangée valide est au plus la précédente, station par station: au début de
+ *  la ronde k, seules les stations que ce départ a améliorées aux rondes précédentes sont reportées de la rangée
+ *  k - 1 (propager()), et les rangées des rondes que ce départ n'atteint pas les reçoivent à la fin.
+ * \pre p_depart précède tous les départs des exécutions précédentes depuis la dernière préparation
+ */
+void PlanificateurRaptor::executer(Travail &p_travail, std::uint32_t p_de, std::uint32_t p_vers,
+                                   std::uint32_t p_depart, unsigned int p_nbRondes) const
+{
+    if (p_depart >= p_travail.arrivees[p_de]) return;
+    etiqueter(p_travail, 0, p_de, p_depart, Parent{p_de, AUCUN, p_depart});
+    marcher(p_travail, 0, p_vers);
+
+    unsigned int ronde = 1;
+    for (; ronde < p_nbRondes && !p_travail.listeMarquees.empty(); ++ronde)
+    {
+        if (ronde == p_travail.nbRangees)
+        {
+            std::uint32_t *courantes = &p_travail.arrivees[static_cast<std::size_t>(ronde) * m_nbStations];
+            std::copy(courantes - m_nbStations, courantes, courantes);
+            ++p_travail.nbRangees;
+        }
+        else
+        {
+            propager(p_travail, ronde);
+        }
+
+        // Chaque parcours qui passe par une station marquée est parcouru à partir de la première d'entre elles
+        for (std::uint32_t station : p_travail.listeMarquees)
+        {
+            p_travail.marquees[station] = 0;
+            for (std::uint32_t i = m_debutsPassages[station]; i < m_debutsPassages[station + 1]; ++i)
+            {
+                const Passage &passage = m_passages[i];
+                std::uint32_t &premiere = p_travail.premieres[passage.parcours];
+                if (premiere == AUCUN) p_travail.aParcourir.push_back(passage.parcours);
+                if (passage.position < premiere) premiere = passage.position;
+            }
+        }
+        p_travail.listeMarquees.clear();
+        for (std::uint32_t parcours : p_travail.aParcourir) parcourir(p_travail, ronde, parcours, p_vers);
+        p_travail.aParcourir.clear();
+        marcher(p_travail, ronde, p_vers);
+    }
+    for (std::uint32_t station : p_travail.listeMarquees) p_travail.marquees[station] = 0;
+    p_travail.listeMarquees.clear();
+    for (; ronde < p_travail.nbRangees; ++ronde) propager(p_travail, ronde);
+    for (std::uint32_t station : p_travail.listeAmeliorees) p_travail.ameliorees[station] = 0;
+    p_travail.listeAmeliorees.clear();
+}
+
+//! \brief reporte dans la rangée de la ronde p_ronde les arrivées de la ronde précédente qui la battent, pour les
+//! seules stations améliorées par l'exécution en cours: les autres y sont déjà au plus leur arrivée précédente
+void PlanificateurRaptor::propager(Travail &p_travail, unsigned int p_ronde) const
+{
+    std::uint32_t *courantes = &p_travail.arrivees[static_cast<std::size_t>(p_ronde) * m_nbStations];
+    const std::uint32_t *precedentes = courantes - m_nbStations;
+    for (std::uint32_t station : p_travail.listeAmeliorees)
+    {
+        if (precedentes[station] < courantes[station]) courantes[station] = precedentes[station];
+    }
+}
+
+void PlanificateurRaptor::marquer(Travail &p_travail, std::uint32_t p_station) const
+{
+    if (p_travail.marquees[p_station]) return;
+    p_travail.marquees[p_station] = 1;
+    p_travail.listeMarquees.push_back(p_station);
+}
+
+//! \brief p_station est atteinte à p_arrivee à la ronde p_ronde, par l'étape p_parent
+//! \pre p_arrivee améliore l'arrivée de p_station à la ronde p_ronde
+void PlanificateurRaptor::etiqueter(Travail &p_travail, std::uint32_t p_ronde, std::uint32_t p_station,
+                                    std::uint32_t p_arrivee, const Parent &p_parent) const
+{
+    std::size_t position = static_cast<std::size_t>(p_ronde) * m_nbStations + p_station;
+    p_travail.arrivees[position] = p_arrivee;
+    p_travail.parents[position] = p_parent;
+    marquer(p_travail, p_station);
+    if (p_travail.ameliorees[p_station]) return;
+    p_travail.ameliorees[p_station] = 1;
+    p_travail.listeAmeliorees.push_back(p_station);
+}
+
+/*!
+ * \brief parcourt un parcours à partir de sa première station marquée, à bord du premier voyage qu'on peut prendre
+ *
+ *  Une station n'est améliorée que si l'arrivée bat la sienne et celle de la destination p_vers dans la rangée de la
+ *  ronde, qui a reçu les meilleures arrivées des rondes précédentes. À chaque station atteinte à la ronde
+ *  précédente, on cherche par dichotomie un voyage plus tôt que celui à bord.
+ */
+void PlanificateurRaptor::parcourir(Travail &p_travail, std::uint32_t p_ronde, std::uint32_t p_parcours,
+                                    std::uint32_t p_vers) const
+{
+    const Parcours &parcours = m_parcours[p_parcours];
+    const std::uint32_t n = parcours.nbStations;
+    const std::uint32_t *stations = &m_stationsParcours[parcours.debutStations];
+    const std::uint32_t *arrivees = &m_arriveesParcours[parcours.debutHoraires];
+    const std::uint32_t *departs = &m_departsParcours[parcours.debutHoraires];
+    const std::uint32_t *precedentes = &p_travail.arrivees[static_cast<std::size_t>(p_ronde - 1) * m_nbStations];
+    const std::uint32_t *courantes = precedentes + m_nbStations;
+
+    std::uint32_t voyage = AUCUN; //rang du voyage dans le parcours
+    std::uint32_t embarquement = 0;
+    for (std::uint32_t p = p_travail.premieres[p_parcours]; p < n; ++p)
+    {
+        std::uint32_t station = stations[p];
+        if (voyage != AUCUN)
+        {
+            std::uint32_t arrivee = arrivees[static_cast<std::size_t>(voyage) * n + p];
+            if (arrivee < courantes[station] && arrivee < courantes[p_vers])
+            {
+                Parent parent = {stations[embarquement], m_voyagesParcours[parcours.debutVoyages + voyage],
+                                 departs[static_cast<std::size_t>(voyage) * n + embarquement]};
+                etiqueter(p_travail, p_ronde, station, arrivee, parent);
+            }
+        }
+
+        std::uint32_t precedente = precedentes[station];
+        if (precedente == INFINI) continue;
+        if (voyage != AUCUN && precedente > departs[static_cast<std::size_t>(voyage) * n + p]) continue;
+        std::uint32_t bas = 0;
+        std::uint32_t haut = voyage == AUCUN ? parcours.nbVoyages : voyage;
+        const std::uint32_t borne = haut;
+        while (bas < haut)
+        {
+            std::uint32_t milieu = bas + (haut - bas) / 2;
+            if (departs[static_cast<std::size_t>(milieu) * n + p] < precedente) bas = milieu + 1;
+            else haut = milieu;
+        }
+        if (bas < borne)
+        {
+            voyage = bas;
+            embarquement = p;
+        }
+    }
+    p_travail.premieres[p_parcours] = AUCUN;
+}
+
+//! \brief les transferts de la ronde, à partir des stations marquées, enchaînés par GrapheTransferts::enchainer()
+void PlanificateurRaptor::marcher(Travail &p_travail, std::uint32_t p_ronde, std::uint32_t p_vers) const
+{
+    std::uint32_t *arrivees = &p_travail.arrivees[static_cast<std::size_t>(p_ronde) * m_nbStations];
+    std::vector<EntreeTas> &tas = p_travail.tas;
+    tas.clear();
+    for (std::uint32_t station : p_travail.listeMarquees) tas.push_back(EntreeTas(arrivees[station], station));
+    m_transferts.enchainer(arrivees, tas, arrivees[p_vers],
+                           [&](std::uint32_t p_atteinte, std::uint32_t p_de, std::uint32_t p_depart) {
+                               etiqueter(p_travail, p_ronde, p_atteinte, arrivees[p_atteinte],
+                                         Parent{p_de, AUCUN, p_depart});
+                           });
+}
+
+//! \brief la meilleure arrivée de p_station, toutes rondes confondues
+std::uint32_t PlanificateurRaptor::meilleureArrivee(const Travail &p_travail, std::uint32_t p_station) const
+{
+    std::uint32_t meilleure = INFINI;
+    for (unsigned int ronde = 0; ronde < p_travail.nbRangees; ++ronde)
+    {
+        meilleure = std::min(meilleure, p_travail.arrivees[static_cast<std::size_t>(ronde) * m_nbStations + p_station]);
+    }
+    return meilleure;
+}
+
+/*!
+ * \brief remonte les étapes de p_vers jusqu'à l'origine, à partir de la première ronde qui l'atteint à sa meilleure
+ * arrivée
+ *
+ *  Une station atteinte aussi tôt à la ronde précédente y est reprise, avec un voyage de moins; sinon son arrivée
+ *  vient d'une étape de cette ronde. Un voyage mène à la ronde précédente, un transfert à la même ronde. Les
+ *  arrivées ne font que baisser, de sorte qu'une étape part toujours après l'arrivée à sa station de départ, même
+ *  si celle-ci a été améliorée depuis (profil).
+ */
+Itineraire PlanificateurRaptor::reconstituer(const Travail &p_travail, std::uint32_t p_vers,
+                                             const Heure &p_depart) const
+{
+    const std::vector<std::uint32_t> &arrivees = p_travail.arrivees;
+    Itineraire itineraire;
+    itineraire.depart = p_depart;
+    std::uint32_t meilleure = meilleureArrivee(p_travail, p_vers);
+    if (meilleure == INFINI) return itineraire;
+    itineraire.existe = true;
+    itineraire.arrivee = Heure::depuisCode(meilleure);
+
+    unsigned int ronde = 0;
+    while (arrivees[static_cast<std::size_t>(ronde) * m_nbStations + p_vers] != meilleure)
+    {
+        ++ronde;
+    }
+    std::uint32_t station = p_vers;
+    for (;;)
+    {
+        std::size_t position = static_cast<std::size_t>(ronde) * m_nbStations + station;
+        while (ronde > 0 && arrivees[position - m_nbStations] <= arrivees[position])
+        {
+            --ronde;
+            position -= m_nbStations;
+        }
+        const Parent &parent = p_travail.parents[position];
+        if (parent.de == station) break; //l'origine
+        Etape etape = {parent.voyage, parent.de, station, Heure::depuisCode(parent.depart),
+                       Heure::depuisCode(arrivees[position])};
+        itineraire.etapes.push_back(etape);
+        if (!etape.estAPied()) --ronde;
+        station = parent.de;
+    }
+    std::reverse(itineraire.etapes.begin(), itineraire.etapes.end());
+    return itineraire;
+}
+
+/*!
+ * \brief les heures de départ de [p_debut, p_fin) qui peuvent commencer un itinéraire non dominé de p_de à p_vers:
+ * celles des voyages (sauf à leur dernier arrêt) à chaque station atteinte à pied depuis p_de, moins la durée de la
+ * marche, chacune avec un minorant de l'arrivée à p_vers
+ *
+ *  Les durées de marche viennent de GrapheTransferts::enchainer(), comme dans marcher(). La marche s'arrête à la
+ *  marche directe vers p_vers, qu'aucun voyage pris plus loin ne peut battre, et à m_dernierDepart - p_debut, au-delà
+ *  de quoi plus aucun voyage ne part dans l'intervalle. Le minorant d'une montée est l'arrivée du voyage à l'arrêt
+ *  suivant. Dans chaque voyage, une montée n'est gardée que si elle part de p_de plus tard que toutes les montées en
+ *  amont (partir plus tard et monter plus tôt dans le même voyage atteint les mêmes arrêts aux mêmes heures) et si
+ *  son minorant bat la marche directe.
+ * \param[out] p_marcheDirecte: la durée de la marche de p_de à p_vers, INFINI si p_vers n'est pas atteinte à pied
+ * \return les départs, sans doublon d'heure, du plus tard au plus tôt
+ */
+std::vector<PlanificateurRaptor::DepartPossible> PlanificateurRaptor::departsPossibles(
+        std::uint32_t p_de, std::uint32_t p_vers, std::uint32_t p_debut, std::uint32_t p_fin,
+        std::uint32_t &p_marcheDirecte) const
+{
+    std::vector<DepartPossible> departs;
+    p_marcheDirecte = INFINI;
+    if (m_dernierDepart < p_debut) return departs;
+
+    std::vector<std::uint32_t> durees(m_nbStations, INFINI);
+    std::vector<std::uint32_t> atteintes(1, p_de);
+    std::vector<EntreeTas> tas(1, EntreeTas(0, p_de));
+    std::uint32_t borne = m_dernierDepart - p_debut + 1;
+    durees[p_de] = 0;
+    m_transferts.enchainer(durees.data(), tas, borne, [&](std::uint32_t p_atteinte, std::uint32_t, std::uint32_t) {
+        atteintes.push_back(p_atteinte);
+        if (p_atteinte == p_vers) borne = durees[p_vers];
+    });
+    std::uint32_t marcheDirecte = durees[p_vers];
+    p_marcheDirecte = marcheDirecte;
+
+    // Les parcours qui passent par une station atteinte assez vite
+    std::vector<std::uint32_t> parcoursAtteints;
+    for (std::uint32_t station : atteintes)
+    {
+        if (durees[station] >= borne) continue;
+        for (std::uint32_t i = m_debutsPassages[station]; i < m_debutsPassages[station + 1]; ++i)
+        {
+            parcoursAtteints.push_back(m_passages[i].parcours);
+        }
+    }
+    std::sort(parcoursAtteints.begin(), parcoursAtteints.end());
+    parcoursAtteints.erase(std::unique(parcoursAtteints.begin(), parcoursAtteints.end()), parcoursAtteints.end());
+
+    for (std::uint32_t r : parcoursAtteints)
+    {
+        const Parcours &parcours = m_parcours[r];
+        const std::uint32_t *stations = &m_stationsParcours[parcours.debutStations];
+        for (std::uint32_t v = 0; v < parcours.nbVoyages; ++v)
+        {
+            std::size_t horaire = parcours.debutHoraires + static_cast<std::size_t>(v) * parcours.nbStations;
+            const std::uint32_t *departsVoyage = &m_departsParcours[horaire];
+            const std::uint32_t *arriveesVoyage = &m_arriveesParcours[horaire];
+            bool amont = false;
+            std::uint32_t plusTard = 0; //le départ de p_de le plus tard des montées en amont
+            for (std::uint32_t p = 0; p + 1 < parcours.nbStations; ++p)
+            {
+                std::uint32_t duree = durees[stations[p]];
+                if (duree >= borne || departsVoyage[p] < duree) continue;
+                std::uint32_t depart = departsVoyage[p] - duree;
+                if (depart < p_debut || depart >= p_fin || (amont && depart <= plusTard)) continue;
+                amont = true;
+                plusTard = depart;
+                if (marcheDirecte != INFINI && arriveesVoyage[p + 1] - depart >= marcheDirecte) continue;
+                DepartPossible possible = {depart, arriveesVoyage[p + 1]};
+                departs.push_back(possible);
+            }
+        }
+    }
+
+    // Du plus tard au plus tôt; une heure de départ garde le plus petit de ses minorants
+    std::sort(departs.begin(), departs.end(), [](const DepartPossible &a, const DepartPossible &b) {
+        return a.depart != b.depart ? a.depart > b.depart : a.arriveeMin < b.arriveeMin;
+    });
+    departs.erase(std::unique(departs.begin(), departs.end(), [](const DepartPossible &a, const DepartPossible &b) {
+        return a.depart == b.depart;
+    }), departs.end());
+    return departs;
+}
+
+/*!
+ * \brief le profil des p_nbDeparts départs de p_departs (du plus tard au plus tôt), avec un seul p_travail: chaque
+ * départ qui améliore l'arrivée à p_vers ajoute son itinéraire à p_profil
+ *
+ *  Un départ dont le minorant n'est pas meilleur que l'arrivée d'un départ plus tard n'est pas exécuté: les arrivées
+ *  de p_travail restent celles d'itinéraires qui partent plus tard, et les départs suivants marquent encore toutes
+ *  les stations qu'ils améliorent.
+ */
+void PlanificateurRaptor::profilTranche(Travail &p_travail, std::uint32_t p_de, std::uint32_t p_vers,
+                                        const DepartPossible *p_departs, std::size_t p_nbDeparts,
+                                        unsigned int p_nbRondes, std::vector<Itineraire> &p_profil) const
+{
+    preparer(p_travail, p_nbRondes);
+    std::uint32_t meilleure = INFINI;
+    for (std::size_t i = 0; i < p_nbDeparts; ++i)
+    {
+        if (p_departs[i].arriveeMin >= meilleure) continue;
+        executer(p_travail, p_de, p_vers, p_departs[i].depart, p_nbRondes);
+        std::uint32_t arrivee = meilleureArrivee(p_travail, p_vers);
+        if (arrivee >= meilleure) continue;
+        meilleure = arrivee;
+        p_profil.push_back(reconstituer(p_travail, p_vers, Heure::depuisCode(p_departs[i].depart)));
+    }
+}
+
+/*!
+ * \brief le profil des p_nbDeparts départs de p_departs (du plus tard au plus tôt) par sauts, du plus tôt au plus
+ * tard: chaque exécution, préparée à neuf, part du plus tôt des départs qui restent; son itinéraire part en fait
+ * de p_de au plus tard à l'heure de son premier voyage moins la marche qui le précède, et tous les départs jusqu'à
+ * cette heure arrivent aussi tard, de sorte que l'exécution suivante part du premier départ après elle
+ *
+ *  Un itinéraire qui arrive aussi tard que le précédent le remplace: il part plus tard. Le nombre d'exécutions ne
+ *  dépend que du nombre d'itinéraires du profil (environ deux par itinéraire), et non du nombre de départs.
+ * \param[in] p_fin: aucun itinéraire qui part de p_de à p_fin ou plus tard n'est ajouté
+ */
+void PlanificateurRaptor::profilParSauts(Travail &p_travail, std::uint32_t p_de, std::uint32_t p_vers,
+                                         std::uint32_t p_fin, const DepartPossible *p_departs,
+                                         std::size_t p_nbDeparts, unsigned int p_nbRondes,
+                                         std::vector<Itineraire> &p_profil) const
+{
+    std::vector<Itineraire> profil; //du plus tôt au plus tard
+    std::uint32_t precedente = INFINI;
+    for (std::size_t i = p_nbDeparts; i > 0;)
+    {
+        std::uint32_t depart = p_departs[i - 1].depart;
+        preparer(p_travail, p_nbRondes);
+        executer(p_travail, p_de, p_vers, depart, p_nbRondes);
+        std::uint32_t arrivee = meilleureArrivee(p_travail, p_vers);
+        if (arrivee == INFINI) break; //les départs plus tardifs n'arrivent pas non plus
+
+        Itineraire itineraire = reconstituer(p_travail, p_vers, Heure::depuisCode(depart));
+        std::uint32_t marche = 0;
+        for (const Etape &etape : itineraire.etapes)
+        {
+            if (!etape.estAPied())
+            {
+                depart = etape.depart.getCode() - marche;
+                break;
+            }
+            marche += etape.arrivee.getCode() - etape.depart.getCode();
+        }
+        if (depart >= p_fin) break;
+        itineraire.depart = Heure::depuisCode(depart);
+        if (arrivee == precedente) profil.back() = std::move(itineraire);
+        else profil.push_back(std::move(itineraire));
+        precedente = arrivee;
+        while (i > 0 && p_departs[i - 1].depart <= depart) --i;
+    }
+    p_profil.insert(p_profil.end(), std::make_move_iterator(profil.rbegin()), std::make_move_iterator(profil.rend()));
+}
@@ -0,0 +1,139 @@
+//
+// Planificateur d'itinéraires RAPTOR: arrivée la plus tôt, par rondes de voyages.
+//
+
+#ifndef RTC_RAPTOR_H
+#define RTC_RAPTOR_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "auxiliaires.h"
+#include "graphetransferts.h"
+#include "itineraire.h"
+
+class DonneesGTFS;
+
+const unsigned int MAX_TRANSFERTS = 8; //borne par défaut du nombre de changements de voyage d'une requête
+
+/*!
+ * \class PlanificateurRaptor
+ * \brief Répond aux requêtes «partir de la station A à l'heure t pour aller à la station B» par l'algorithme RAPTOR
+ *
+ *  Les voyages sont regroupés en parcours: même suite de stations, et aucun voyage n'en dépasse un autre, de sorte
+ *  que les départs à chaque position d'un parcours croissent d'un voyage au suivant. La ronde k trouve les stations
+ *  atteintes avec k voyages: seuls les parcours qui passent par une station améliorée à la ronde précédente sont
+ *  parcourus, chacun à partir de la première de ces stations; les transferts de la ronde partent ensuite des
+ *  stations améliorées et s'enchaînent (Dijkstra sur le graphe des transferts). Les heures d'arrivée de chaque
+ *  ronde sont rangées dans un seul tableau plat, une rangée de nbStations() par ronde; la rangée d'une ronde reçoit
+ *  au départ les meilleures arrivées de la précédente.
+ *
+ *  Une requête de profil (rRAPTOR) donne tous les itinéraires Pareto-optimaux (départ plus tard, arrivée plus tôt)
+ *  d'un intervalle de départs: les départs possibles sont traités du plus tard au plus tôt, et les arrivées de
+ *  chaque ronde sont gardées d'un départ au suivant; seules les stations qu'un départ plus tôt améliore sont
+ *  marquées et reportées d'une ronde à la suivante, de sorte que chaque départ ne coûte que ce qu'il change. Quand
+ *  la marche depuis l'origine mène à beaucoup de départs possibles, le profil est plutôt obtenu par sauts: une
+ *  requête par itinéraire du profil, à peu près, au lieu d'une exécution par départ.
+ *
+ *  Le planificateur est une photographie des voyages et des transferts de DonneesGTFS: il doit être reconstruit si
+ *  elles changent. Il garde ses tableaux de travail d'une requête à l'autre: un planificateur par fil.
+ *  Un changement de voyage dans une même station ne demande aucun délai.
+ */
+class PlanificateurRaptor
+{
+public:
+    PlanificateurRaptor();
+
+    void construire(const DonneesGTFS &p_donnees);
+    void vider();
+    Itineraire trouver(std::uint32_t p_de, std::uint32_t p_vers, const Heure &p_depart,
+                       unsigned int p_maxTransferts = MAX_TRANSFERTS);
+    std::vector<Itineraire> profil(std::uint32_t p_de, std::uint32_t p_vers, const Heure &p_debut, const Heure &p_fin,
+                                   unsigned int p_maxTransferts = MAX_TRANSFERTS, std::size_t p_nbTranches = 1);
+
+    std::size_t nbParcours() const;
+    std::size_t nbVoyages() const;
+    std::uint32_t nbStations() const;
+
+private:
+    struct Parcours
+    {
+        std::uint32_t debutStations; //position dans m_stationsParcours
+        std::uint32_t nbStations;
+        std::uint32_t debutVoyages;  //position dans m_voyagesParcours
+        std::uint32_t nbVoyages;
+        std::uint32_t debutHoraires; //position dans m_arriveesParcours et m_departsParcours
+    };
+
+    struct Passage
+    {
+        std::uint32_t parcours;
+        std::uint32_t position; //rang de la station dans le parcours
+    };
+
+    struct Parent
+    {
+        std::uint32_t de;     //station où commence la dernière étape
+        std::uint32_t voyage; //TableIdentifiants::ABSENT pour un transfert à pied
+        std::uint32_t depart; //code de l'heure de départ de l'étape
+    };
+
+    struct Travail
+    {
+        Travail() : nbRangees(0) {}
+
+        std::vector<std::uint32_t> arrivees;     //ronde par ronde, nbStations() par ronde
+        unsigned int nbRangees;                  //rangées de arrivees valides depuis la dernière préparation
+        std::vector<Parent> parents;             //même disposition que arrivees
+        std::vector<std::uint8_t> marquees;
+        std::vector<std::uint32_t> listeMarquees;
+        std::vector<std::uint8_t> ameliorees;    //par l'exécution en cours, toutes rondes confondues
+        std::vector<std::uint32_t> listeAmeliorees;
+        std::vector<EntreeTas> tas;              //les transferts d'une ronde
+        std::vector<std::uint32_t> premieres;    //par parcours: première position marquée, ou TableIdentifiants::ABSENT
+        std::vector<std::uint32_t> aParcourir;
+    };
+
+    struct DepartPossible
+    {
+        std::uint32_t depart;     //code de l'heure de départ de l'origine
+        std::uint32_t arriveeMin; //aucun itinéraire qui part à cette heure n'arrive avant
+    };
+
+    void verifier(std::uint32_t p_de, std::uint32_t p_vers, const char *p_methode) const;
+    void preparer(Travail &p_travail, unsigned int p_nbRondes) const;
+    void executer(Travail &p_travail, std::uint32_t p_de, std::uint32_t p_vers, std::uint32_t p_depart,
+                  unsigned int p_nbRondes) const;
+    void propager(Travail &p_travail, unsigned int p_ronde) const;
+    void marquer(Travail &p_travail, std::uint32_t p_station) const;
+    void etiqueter(Travail &p_travail, std::uint32_t p_ronde, std::uint32_t p_station, std::uint32_t p_arrivee,
+                   const Parent &p_parent) const;
+    void parcourir(Travail &p_travail, std::uint32_t p_ronde, std::uint32_t p_parcours, std::uint32_t p_vers) const;
+    void marcher(Travail &p_travail, std::uint32_t p_ronde, std::uint32_t p_vers) const;
+    std::uint32_t meilleureArrivee(const Travail &p_travail, std::uint32_t p_station) const;
+    Itineraire reconstituer(const Travail &p_travail, std::uint32_t p_vers, const Heure &p_depart) const;
+    std::vector<DepartPossible> departsPossibles(std::uint32_t p_de, std::uint32_t p_vers, std::uint32_t p_debut,
+                                                 std::uint32_t p_fin, std::uint32_t &p_marcheDirecte) const;
+    void profilTranche(Travail &p_travail, std::uint32_t p_de, std::uint32_t p_vers,
+                       const DepartPossible *p_departs, std::size_t p_nbDeparts, unsigned int p_nbRondes,
+                       std::vector<Itineraire> &p_profil) const;
+    void profilParSauts(Travail &p_travail, std::uint32_t p_de, std::uint32_t p_vers, std::uint32_t p_fin,
+                        const DepartPossible *p_departs, std::size_t p_nbDeparts, unsigned int p_nbRondes,
+                        std::vector<Itineraire> &p_profil) const;
+
+    //Le réseau, construit par construire()
+    std::uint32_t m_nbStations;
+    std::vector<Parcours> m_parcours;
+    std::vector<std::uint32_t> m_stationsParcours;
+    std::vector<std::uint32_t> m_voyagesParcours;  //par départ croissant dans chaque parcours
+    std::vector<std::uint32_t> m_arriveesParcours; //voyage par voyage: le voyage v d'un parcours occupe les
+    std::vector<std::uint32_t> m_departsParcours;  //positions [debutHoraires + v * nbStations, ... + nbStations)
+    std::vector<std::uint32_t> m_debutsPassages;   //nbStations() + 1 positions dans m_passages
+    std::vector<Passage> m_passages;               //les parcours qui passent par chaque station
+    std::uint32_t m_dernierDepart;                 //le plus tard des départs des parcours
+    GrapheTransferts m_transferts;
+
+    Travail m_travail; //celui de trouver() et des profils d'une seule tranche
+};
+
+#endif //RTC_RAPTOR_H
@@ -0,0 +1,809 @@
+//
+// Rechargement incrémental d'un dossier GTFS: seuls les enregistrements modifiés depuis le chargement précédent
+// sont appliqués à l'objet DonneesGTFS.
+//
+
+#include "rechargement.h"
+#include "DonneesGTFS.h"
+#include "enregistrementsgtfs.h"
+#include "parallele.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <set>
+
+using namespace std;
+
+namespace
+{
+    enum Fichier
+    {
+        ROUTES, STOPS, CALENDAR_DATES, TRIPS, STOP_TIMES, TRANSFERS, NB_FICHIERS
+    };
+
+    const char *const NOMS_FICHIERS[NB_FICHIERS] = {"routes.txt", "stops.txt", "calendar_dates.txt", "trips.txt",
+                                                    "stop_times.txt", "transfers.txt"};
+
+    const std::uint64_t GRAINE_EMPREINTE = 0xcbf29ce484222325ULL;
+    const std::uint64_t BASE_EMPREINTE = 0x100000001b3ULL;
+
+    //! \brief mélange les bits d'un mot de 64 bits (finaliseur de splitmix64)
+    std::uint64_t melanger(std::uint64_t p_mot)
+    {
+        p_mot ^= p_mot >> 30;
+        p_mot *= 0xbf58476d1ce4e5b9ULL;
+        p_mot ^= p_mot >> 27;
+        p_mot *= 0x94d049bb133111ebULL;
+        return p_mot ^ (p_mot >> 31);
+    }
+
+    //! \brief empreinte de 64 bits des octets [p_debut, p_fin), lus par mots de 8 octets
+    std::uint64_t empreinte(const char *p_debut, const char *p_fin, std::uint64_t p_graine = GRAINE_EMPREINTE)
+    {
+        std::uint64_t h = p_graine ^ static_cast<std::uint64_t>(p_fin - p_debut);
+        for (; p_fin - p_debut >= 8; p_debut += 8)
+        {
+            std::uint64_t mot;
+            std::memcpy(&mot, p_debut, 8);
+            h = (h ^ mot) * 0x9e3779b97f4a7c15ULL;
+            h ^= h >> 32;
+        }
+        std::uint64_t reste = 0;
+        std::memcpy(&reste, p_debut, static_cast<std::size_t>(p_fin - p_debut));
+        return melanger(h ^ reste);
+    }
+
+    //! taille minimale (en octets) d'un morceau de stop_times.txt parcouru par un fil
+    const std::size_t TAILLE_MIN_MORCEAU = 1 << 20;
+
+    //! un enregistrement repéré par sa clé, sans la fin de ligne
+    struct EnregistrementBrut
+    {
+        Champ cle;
+        const char *debut;
+        const char *fin;
+        std::uint64_t empreinte;
+    };
+
+    /*!
+     * \brief lit l'en-tête d'un fichier et y cherche la colonne clé
+     * \param[in] p_fichier: le fichier projeté
+     * \param[in] p_colonneCle: le nom de la colonne identifiant un enregistrement
+     * \param[out] p_donnees: le début du premier enregistrement
+     * \return la position de la colonne clé
+     * \throws logic_error si la colonne clé est absente de l'en-tête
+     */
+    std::size_t colonneCle(const FichierMappe &p_fichier, const char *p_colonneCle, const char *&p_donnees)
+    {
+        LecteurCSV lecteur(p_fichier.debut(), p_fichier.fin());
+        std::vector<Champ> entete;
+        lecteur.lireEntete(entete);
+        std::size_t indice = 0;
+        while (indice < entete.size() && !(entete[indice] == p_colonneCle)) ++indice;
+        if (indice == entete.size())
+        {
+            throw std::logic_error(std::string("Colonne ") + p_colonneCle + " absente de l'en-tête");
+        }
+        p_donnees = lecteur.position();
+        return indice;
+    }
+
+    /*!
+     * \brief parcourt les enregistrements de [p_debut, p_fin) en ne découpant chacun que jusqu'à sa colonne clé. Un
+     * enregistrement sans guillemets est découpé directement par recherche des virgules et de la fin de ligne; les
+     * autres passent par LecteurCSV, qui gère les virgules et les fins de ligne entre guillemets
+     * \param[in] p_indiceCle: la position de la colonne clé
+     * \param[in] p_rappel: appelé avec chaque EnregistrementBrut, dans l'ordre du tampon
+     */
+    template<typename Rappel>
+    void parcourirEnregistrements(const char *p_debut, const char *p_fin, std::size_t p_indiceCle, Rappel p_rappel)
+    {
+        EnregistrementBrut enregistrement;
+        const char *p = p_debut;
+        while (p < p_fin)
+        {
+            if (estBlanc(*p) || *p == '\n')
+            {
+                ++p; //lignes vides
+                continue;
+            }
+            enregistrement.debut = p;
+            enregistrement.cle = Champ();
+            const char *finLigne = static_cast<const char *>(memchr(p, '\n', static_cast<std::size_t>(p_fin - p)));
+            if (finLigne == nullptr) finLigne = p_fin;
+
+            if (memchr(p, '"', static_cast<std::size_t>(finLigne - p)) == nullptr)
+            {
+                const char *champ = p;
+                for (std::size_t i = 0; i < p_indiceCle && champ != nullptr; ++i)
+                {
+                    champ = static_cast<const char *>(memchr(champ, ',', static_cast<std::size_t>(finLigne - champ)));
+                    if (champ != nullptr) ++champ;
+                }
+                if (champ != nullptr)
+                {
+                    const char *finChamp = static_cast<const char *>(
+                            memchr(champ, ',', static_cast<std::size_t>(finLigne - champ)));
+                    if (finChamp == nullptr) finChamp = finLigne;
+                    while (champ < finChamp && estBlanc(*champ)) ++champ;
+                    while (finChamp > champ && estBlanc(finChamp[-1])) --finChamp;
+                    enregistrement.cle = Champ(champ, static_cast<std::size_t>(finChamp - champ));
+                }
+                enregistrement.fin = finLigne;
+                p = finLigne + 1;
+            }
+            else
+            {
+                LecteurCSV lecteur(p, p_fin);
+                lecteur.debutLigne();
+                Champ champ;
+                for (std::size_t i = 0; i <= p_indiceCle && lecteur.champSuivant(champ); ++i)
+                {
+                    if (i == p_indiceCle) enregistrement.cle = champ;
+                }
+                lecteur.finLigne();
+                enregistrement.fin = lecteur.position();
+                p = enregistrement.fin;
+            }
+            while (enregistrement.fin > enregistrement.debut
+                   && (enregistrement.fin[-1] == '\n' || enregistrement.fin[-1] == '\r'))
+            {
+                --enregistrement.fin;
+            }
+            enregistrement.empreinte = empreinte(enregistrement.debut, enregistrement.fin);
+            p_rappel(enregistrement);
+        }
+    }
+
+    //! enregistrements consécutifs d'un même voyage dans stop_times.txt
+    struct GroupeEnregistrements
+    {
+        Champ cle;
+        const char *debut;
+        const char *fin;
+        std::uint64_t empreinte; //polynomiale en BASE_EMPREINTE sur les empreintes des enregistrements
+        std::size_t nombre;
+    };
+
+    //! \brief p_base exposant p_exposant, modulo 2^64
+    std::uint64_t puissance(std::uint64_t p_base, std::size_t p_exposant)
+    {
+        std::uint64_t resultat = 1;
+        for (; p_exposant != 0; p_exposant >>= 1, p_base *= p_base)
+        {
+            if (p_exposant & 1) resultat *= p_base;
+        }
+        return resultat;
+    }
+
+    //! \brief parcourt tous les enregistrements d'un fichier, voir parcourirEnregistrements()
+    template<typename Rappel>
+    void parcourirFichier(const FichierMappe &p_fichier, const char *p_colonneCle, Rappel p_rappel)
+    {
+        const char *donnees;
+        std::size_t indice = colonneCle(p_fichier, p_colonneCle, donnees);
+        parcourirEnregistrements(donnees, p_fichier.fin(), indice, p_rappel);
+    }
+}
+
+/*!
+ * \class RechargeurGTFS
+ * \brief Compare un dossier GTFS aux empreintes du chargement précédent et applique les différences à DonneesGTFS
+ *
+ *  Les voyages touchés (enregistrement de trips.txt ou de stop_times.txt modifié, service ajouté ou retiré à la date)
+ *  sont d'abord tous retirés de l'objet, puis reconstruits à partir de leurs seuls enregistrements de stop_times.txt.
+ *  La table des arrêts et l'index des stations sont ensuite reconstruits: une station est présente si elle est dans
+ *  stops.txt et a au moins un arrêt, comme lors d'un chargement complet.
+ */
+class RechargeurGTFS
+{
+public:
+    RechargeurGTFS(DonneesGTFS &p_donnees, const std::string &p_dossier, RapportRechargement &p_rapport);
+    void recharger();
+
+private:
+    std::string chemin(Fichier p_fichier) const;
+    void rechargerLignes();
+    void rechargerStations();
+    void rechargerVoyages();
+    void rechargerServices();
+    void rechargerArrets();
+    void appliquerVoyages();
+    void rechargerTransferts();
+    void compacterArrets();
+    void indexerArrets();
+    bool corrigerArrets();
+    void synchroniserStations();
+
+    void retirerArrets(const std::string &p_voyageId);
+    void ajouterArrets(const std::string &p_voyageId, const Voyage &p_voyage,
+                       const EtatRechargement::ArretsDuVoyage &p_plages);
+    void toucherStation(std::uint32_t p_station);
+    void toucherVoyage(std::uint32_t p_voyage);
+
+    DonneesGTFS &m_donnees;
+    EtatRechargement &m_etat;
+    RapportRechargement &m_rapport;
+    std::string m_dossier;
+
+    std::unique_ptr<FichierMappe> m_fichiers[NB_FICHIERS];
+    bool m_modifies[NB_FICHIERS];
+    std::unique_ptr<LecteurEnregistrements<EnregistrementArret> > m_enteteArrets; //projection de stop_times.txt
+
+    std::set<std::string> m_voyagesTouches; //trip_id à reconstruire
+    std::unordered_map<std::uint32_t, bool> m_stationsTouchees; //station -> présente dans l'objet avant le rechargement
+    std::unordered_map<std::uint32_t, bool> m_voyagesPresents;  //voyage -> présent dans l'objet avant le rechargement
+};
+
+RechargeurGTFS::RechargeurGTFS(DonneesGTFS &p_donnees, const std::string &p_dossier, RapportRechargement &p_rapport)
+        : m_donnees(p_donnees), m_etat(p_donnees.m_etatRechargement), m_rapport(p_rapport), m_dossier(p_dossier)
+{
+}
+
+std::string RechargeurGTFS::chemin(Fichier p_fichier) const
+{
+    return m_dossier + "/" + NOMS_FICHIERS[p_fichier];
+}
+
+//! \brief projette les six fichiers, compare leurs empreintes globales puis applique les différences dans l'ordre
+//! des dépendances: les voyages et les services avant les arrêts, les arrêts avant les transferts
+void RechargeurGTFS::recharger()
+{
+    if (!m_etat.valide)
+    {
+        // Aucun chargement précédent connu: l'objet est vidé et tout est comparé à un état vide
+        m_etat = EtatRechargement();
+        m_donnees.m_lignes.clear();
+        m_donnees.m_lignes_par_numero.clear();
+        m_donnees.m_stations.clear();
+        m_donnees.m_services.clear();
+        m_donnees.m_voyages.clear();
+        m_donnees.m_transferts.clear();
+        m_donnees.m_stationsDeTransfert.clear();
+        m_donnees.m_grapheTransferts.vider();
+        m_donnees.m_arrets.vider();
+        m_donnees.m_tableArrets.vider();
+        m_donnees.m_indexStations.vider();
+        m_donnees.m_nbArrets = 0;
+        m_rapport.complet = true;
+    }
+    m_etat.valide = false; //jusqu'à ce que le rechargement soit complété
+
+    for (int f = 0; f < NB_FICHIERS; ++f)
+    {
+        m_fichiers[f].reset(new FichierMappe(chemin(static_cast<Fichier>(f))));
+        if (!m_fichiers[f]->estOuvert())
+        {
+            throw std::logic_error(std::string("Erreur lors de l'ouverture du fichier ") + NOMS_FICHIERS[f]);
+        }
+        std::uint64_t e = empreinte(m_fichiers[f]->debut(), m_fichiers[f]->fin());
+        m_modifies[f] = m_rapport.complet || e != m_etat.empreintesFichiers[f];
+        m_etat.empreintesFichiers[f] = e;
+        if (m_modifies[f]) ++m_rapport.nbFichiersModifies;
+    }
+
+    rechargerLignes();
+    rechargerStations();
+    rechargerVoyages();
+    rechargerServices();
+    rechargerArrets();
+    appliquerVoyages();
+    compacterArrets();
+    indexerArrets();
+    synchroniserStations();
+    rechargerTransferts();
+
+    m_donnees.m_tousLesArretsPresents = true;
+    m_etat.valide = true;
+}
+
+//! \brief routes.txt est petit: s'il a changé, les différences sont comptées puis les lignes sont relues au complet,
+//! ce qui garde l'ordre de m_lignes_par_numero identique à celui d'un chargement complet
+void RechargeurGTFS::rechargerLignes()
+{
+    if (!m_modifies[ROUTES]) return;
+
+    std::unordered_map<std::string, std::uint64_t> lignes;
+    parcourirFichier(*m_fichiers[ROUTES], "route_id", [&](const EnregistrementBrut &p_enregistrement) {
+        lignes[p_enregistrement.cle.str()] = p_enregistrement.empreinte;
+    });
+    for (const auto &ligne : lignes)
+    {
+        auto itr = m_etat.lignes.find(ligne.first);
+        if (itr == m_etat.lignes.end()) ++m_rapport.nbLignesAjoutees;
+        else if (itr->second != ligne.second) ++m_rapport.nbLignesModifiees;
+    }
+    for (const auto &ligne : m_etat.lignes)
+    {
+        if (lignes.find(ligne.first) == lignes.end()) ++m_rapport.nbLignesRetirees;
+    }
+    m_etat.lignes.swap(lignes);
+
+    m_donnees.m_lignes.clear();
+    m_donnees.m_lignes_par_numero.clear();
+    m_donnees.ajouterLignes(*m_fichiers[ROUTES]);
+}
+
+//! \brief applique les stations modifiées et retirées de stops.txt; une station modifiée garde ses arrêts. Les stations
+//! ajoutées sont insérées par synchroniserStations(), si elles ont des arrêts
+void RechargeurGTFS::rechargerStations()
+{
+    if (!m_modifies[STOPS]) return;
+
+    const FichierMappe &fichier = *m_fichiers[STOPS];
+    LecteurEnregistrements<EnregistrementStation> entete(fichier.debut(), fichier.fin());
+    EnregistrementStation enregistrement;
+    std::unordered_set<std::string> vues;
+
+    parcourirFichier(fichier, "stop_id", [&](const EnregistrementBrut &p_enregistrement) {
+        std::string id = p_enregistrement.cle.str();
+        std::uint64_t e = p_enregistrement.empreinte;
+        vues.insert(id);
+        auto itr = m_etat.stations.find(id);
+        if (itr != m_etat.stations.end() && itr->second.first == e) return;
+
+        LecteurEnregistrements<EnregistrementStation> lecteur(entete, p_enregistrement.debut, p_enregistrement.fin);
+        if (!lecteur.lire(enregistrement)) return;
+        Station station(id, enregistrement.nom.str(), enregistrement.description.str(),
+                        Coordonnees(enregistrement.latitude, enregistrement.longitude));
+        m_etat.stations[id] = std::make_pair(e, station);
+
+        std::uint32_t s = m_donnees.m_idsStations.interner(id);
+        toucherStation(s);
+        if (m_donnees.m_stations.contient(s))
+        {
+            station.setArrets(m_donnees.m_stations[s].getArrets());
+            m_donnees.m_stations[s] = station;
+        }
+    });
+
+    for (auto itr = m_etat.stations.begin(); itr != m_etat.stations.end();)
+    {
+        if (vues.count(itr->first))
+        {
+            ++itr;
+            continue;
+        }
+        std::uint32_t s = m_donnees.m_idsStations.trouver(itr->first);
+        if (m_donnees.m_stations.contient(s))
+        {
+            toucherStation(s);
+            m_donnees.m_stations.retirer(s);
+        }
+        itr = m_etat.stations.erase(itr);
+    }
+}
+
+//! \brief compare trips.txt aux empreintes précédentes; les voyages ajoutés, modifiés ou retirés sont à reconstruire
+void RechargeurGTFS::rechargerVoyages()
+{
+    if (!m_modifies[TRIPS]) return;
+
+    const FichierMappe &fichier = *m_fichiers[TRIPS];
+    LecteurEnregistrements<EnregistrementVoyage> entete(fichier.debut(), fichier.fin());
+    EnregistrementVoyage enregistrement;
+    std::unordered_set<std::string> vus;
+
+    parcourirFichier(fichier, "trip_id", [&](const EnregistrementBrut &p_enregistrement) {
+        std::string id = p_enregistrement.cle.str();
+        std::uint64_t e = p_enregistrement.empreinte;
+        vus.insert(id);
+        auto itr = m_etat.voyages.find(id);
+        if (itr != m_etat.voyages.end() && itr->second.first == e) return;
+
+        LecteurEnregistrements<EnregistrementVoyage> lecteur(entete, p_enregistrement.debut, p_enregistrement.fin);
+        if (!lecteur.lire(enregistrement)) return;
+        std::string serviceId = enregistrement.serviceId.str();
+        if (itr != m_etat.voyages.end())
+        {
+            m_etat.voyagesDesServices[m_donnees.m_idsServices.chaine(itr->second.second.getServiceId())].erase(id);
+        }
+        m_etat.voyages[id] = std::make_pair(e, Voyage(m_donnees.m_idsVoyages.interner(id),
+                                                      m_donnees.m_idsLignes.interner(enregistrement.ligneId),
+                                                      m_donnees.m_idsServices.interner(serviceId),
+                                                      enregistrement.destination.str()));
+        m_etat.voyagesDesServices[serviceId].insert(id);
+        m_voyagesTouches.insert(id);
+    });
+
+    for (auto itr = m_etat.voyages.begin(); itr != m_etat.voyages.end();)
+    {
+        if (vus.count(itr->first))
+        {
+            ++itr;
+            continue;
+        }
+        m_etat.voyagesDesServices[m_donnees.m_idsServices.chaine(itr->second.second.getServiceId())].erase(itr->first);
+        m_voyagesTouches.insert(itr->first);
+        itr = m_etat.voyages.erase(itr);
+    }
+}
+
+//! \brief recalcule les services de la date; les voyages d'un service ajouté ou retiré sont à reconstruire
+void RechargeurGTFS::rechargerServices()
+{
+    if (!m_modifies[CALENDAR_DATES]) return;
+
+    const FichierMappe &fichier = *m_fichiers[CALENDAR_DATES];
+    LecteurEnregistrements<EnregistrementService> lecteur(fichier.debut(), fichier.fin());
+    EnregistrementService enregistrement;
+    std::unordered_set<std::string> services;
+    while (lecteur.lire(enregistrement))
+    {
+        if (enregistrement.typeException == 1 && enregistrement.date == m_donnees.m_date)
+        {
+            services.insert(enregistrement.serviceId.str());
+        }
+    }
+
+    auto toucherService = [&](const std::string &p_serviceId) {
+        auto itr = m_etat.voyagesDesServices.find(p_serviceId);
+        if (itr != m_etat.voyagesDesServices.end())
+        {
+            m_voyagesTouches.insert(itr->second.begin(), itr->second.end());
+        }
+    };
+    EnsembleIdentifiants actifs;
+    for (const auto &service : services)
+    {
+        std::uint32_t s = m_donnees.m_idsServices.interner(service);
+        actifs.ajouter(s);
+        if (!m_donnees.m_services.contient(s))
+        {
+            ++m_rapport.nbServicesAjoutes;
+            toucherService(service);
+        }
+    }
+    for (std::uint32_t s = 0; s < m_donnees.m_services.borne(); ++s)
+    {
+        if (m_donnees.m_services.contient(s) && !actifs.contient(s))
+        {
+            ++m_rapport.nbServicesRetires;
+            toucherService(m_donnees.m_idsServices.chaine(s));
+        }
+    }
+    m_donnees.m_services = actifs;
+}
+
+//! \brief regroupe stop_times.txt par voyage; les voyages dont les enregistrements ont changé sont à reconstruire
+void RechargeurGTFS::rechargerArrets()
+{
+    if (!m_modifies[STOP_TIMES]) return;
+
+    // Chaque fil regroupe les enregistrements consécutifs d'un même voyage de son morceau; les groupes sont ensuite
+    // réunis par voyage dans l'ordre du fichier. L'empreinte polynomiale d'un voyage ne dépend pas du découpage.
+    const FichierMappe &fichier = *m_fichiers[STOP_TIMES];
+    const char *donnees;
+    std::size_t indice = colonneCle(fichier, "trip_id", donnees);
+    std::size_t nbMorceaux = std::min<std::size_t>(nbFilsDisponibles(), 1 + fichier.taille() / TAILLE_MIN_MORCEAU);
+    std::vector<const char *> bornes = decouperSurLignes(donnees, fichier.fin(), nbMorceaux);
+    std::vector<std::vector<GroupeEnregistrements> > morceaux(bornes.size() - 1);
+    executerEnParallele(morceaux.size(), [&](std::size_t k) {
+        std::vector<GroupeEnregistrements> &groupes = morceaux[k];
+        parcourirEnregistrements(bornes[k], bornes[k + 1], indice, [&](const EnregistrementBrut &p_enregistrement) {
+            if (!groupes.empty() && groupes.back().cle == p_enregistrement.cle)
+            {
+                GroupeEnregistrements &groupe = groupes.back();
+                groupe.fin = p_enregistrement.fin;
+                groupe.empreinte = groupe.empreinte * BASE_EMPREINTE + p_enregistrement.empreinte;
+                ++groupe.nombre;
+                return;
+            }
+            GroupeEnregistrements groupe;
+            groupe.cle = p_enregistrement.cle;
+            groupe.debut = p_enregistrement.debut;
+            groupe.fin = p_enregistrement.fin;
+            groupe.empreinte = p_enregistrement.empreinte;
+            groupe.nombre = 1;
+            groupes.push_back(groupe);
+        });
+    });
+
+    std::unordered_map<std::string, EtatRechargement::ArretsDuVoyage> arrets;
+    arrets.reserve(m_etat.arretsDesVoyages.size());
+    std::string id;
+    EtatRechargement::ArretsDuVoyage *courant = nullptr;
+    for (const auto &morceau : morceaux)
+    {
+        for (const auto &groupe : morceau)
+        {
+            // Un groupe qui suit un groupe du même voyage (à la frontière de deux morceaux) prolonge sa plage
+            bool suite = courant != nullptr && groupe.cle == id;
+            if (!suite)
+            {
+                groupe.cle.copierDans(id);
+                auto insertion = arrets.insert(std::make_pair(id, EtatRechargement::ArretsDuVoyage()));
+                courant = &insertion.first->second;
+                if (insertion.second) courant->empreinte = 0;
+            }
+            courant->empreinte = courant->empreinte * puissance(BASE_EMPREINTE, groupe.nombre) + groupe.empreinte;
+
+            std::size_t decalage = static_cast<std::size_t>(groupe.debut - fichier.debut());
+            std::size_t fin = static_cast<std::size_t>(groupe.fin - fichier.debut());
+            if (suite)
+            {
+                courant->plages.back().second = fin - courant->plages.back().first;
+            }
+            else
+            {
+                courant->plages.push_back(std::make_pair(decalage, fin - decalage));
+            }
+        }
+    }
+
+    for (const auto &voyage : arrets)
+    {
+        auto itr = m_etat.arretsDesVoyages.find(voyage.first);
+        if (itr == m_etat.arretsDesVoyages.end() || itr->second.empreinte != voyage.second.empreinte)
+        {
+            m_voyagesTouches.insert(voyage.first);
+        }
+    }
+    for (const auto &voyage : m_etat.arretsDesVoyages)
+    {
+        if (arrets.find(voyage.first) == arrets.end()) m_voyagesTouches.insert(voyage.first);
+    }
+    m_etat.arretsDesVoyages.swap(arrets);
+}
+
+//! \brief retire de l'objet tous les voyages touchés, puis reconstruit ceux dont le service est offert à la date
+void RechargeurGTFS::appliquerVoyages()
+{
+    for (const auto &voyageId : m_voyagesTouches)
+    {
+        std::uint32_t voyage = m_donnees.m_idsVoyages.trouver(voyageId);
+        if (voyage != TableIdentifiants::ABSENT) toucherVoyage(voyage);
+        retirerArrets(voyageId);
+        m_donnees.m_voyages.retirer(voyage);
+    }
+
+    for (const auto &voyageId : m_voyagesTouches)
+    {
+        auto v_itr = m_etat.voyages.find(voyageId);
+        auto a_itr = m_etat.arretsDesVoyages.find(voyageId);
+        if (v_itr == m_etat.voyages.end() || a_itr == m_etat.arretsDesVoyages.end()) continue;
+        if (!m_donnees.m_services.contient(v_itr->second.second.getServiceId())) continue;
+        ajouterArrets(voyageId, v_itr->second.second, a_itr->second);
+    }
+
+    for (const auto &voyage : m_voyagesPresents)
+    {
+        bool present = m_donnees.m_voyages.contient(voyage.first);
+        if (voyage.second && present) ++m_rapport.nbVoyagesModifies;
+        else if (voyage.second) ++m_rapport.nbVoyagesRetires;
+        else if (present) ++m_rapport.nbVoyagesAjoutes;
+    }
+}
+
+//! \brief oublie les arrêts d'un voyage; leurs stations sont revues par synchroniserStations()
+void RechargeurGTFS::retirerArrets(const std::string &p_voyageId)
+{
+    auto itr = m_etat.arretsRetenus.find(p_voyageId);
+    if (itr == m_etat.arretsRetenus.end()) return;
+
+    for (const auto &arret : itr->second) toucherStation(arret->getStation());
+    m_donnees.m_nbArrets -= static_cast<unsigned int>(itr->second.size());
+    m_rapport.nbArretsRetires += itr->second.size();
+    m_etat.arretsRetenus.erase(itr);
+}
+
+/*!
+ * \brief relit les enregistrements de stop_times.txt d'un voyage et y ajoute ceux de l'intervalle [now1, now2)
+ * \param[in] p_voyageId: le trip_id du voyage
+ * \param[in] p_voyage: le voyage, sans arrêts
+ * \param[in] p_plages: les enregistrements du voyage dans stop_times.txt
+ */
+void RechargeurGTFS::ajouterArrets(const std::string &p_voyageId, const Voyage &p_voyage,
+                                   const EtatRechargement::ArretsDuVoyage &p_plages)
+{
+    const FichierMappe &fichier = *m_fichiers[STOP_TIMES];
+    if (!m_enteteArrets)
+    {
+        m_enteteArrets.reset(new LecteurEnregistrements<EnregistrementArret>(fichier.debut(), fichier.fin()));
+    }
+    EnregistrementArret enregistrement;
+    auto filtre = [&](const EnregistrementArret &p_arret) -> bool {
+        return p_arret.heureDepart >= m_donnees.m_now1 && p_arret.heureArrivee < m_donnees.m_now2;
+    };
+
+    std::vector<Arret::Ptr> retenus;
+    std::uint32_t v = p_voyage.getId();
+    for (const auto &plage : p_plages.plages)
+    {
+        const char *debut = fichier.debut() + plage.first;
+        LecteurEnregistrements<EnregistrementArret> lecteur(*m_enteteArrets, debut, debut + plage.second);
+        while (lecteur.lire(enregistrement, filtre))
+        {
+            retenus.push_back(m_donnees.m_arrets.creer(m_donnees.m_idsStations.interner(enregistrement.stationId),
+                                                       enregistrement.heureArrivee, enregistrement.heureDepart,
+                                                       enregistrement.numeroSequence, v));
+        }
+    }
+    if (retenus.empty()) return;
+
+    for (const auto &arret : retenus) toucherStation(arret->getStation());
+
+    m_donnees.m_voyages.inserer(v, p_voyage); //ses arrêts lui sont donnés par indexerArrets()
+    m_donnees.m_nbArrets += static_cast<unsigned int>(retenus.size());
+    m_rapport.nbArretsAjoutes += retenus.size();
+    m_etat.arretsRetenus[p_voyageId].swap(retenus);
+}
+
+void RechargeurGTFS::toucherStation(std::uint32_t p_station)
+{
+    if (m_stationsTouchees.find(p_station) == m_stationsTouchees.end())
+    {
+        m_stationsTouchees[p_station] = m_donnees.m_stations.contient(p_station);
+    }
+}
+
+void RechargeurGTFS::toucherVoyage(std::uint32_t p_voyage)
+{
+    if (m_voyagesPresents.find(p_voyage) == m_voyagesPresents.end())
+    {
+        m_voyagesPresents[p_voyage] = m_donnees.m_voyages.contient(p_voyage);
+    }
+}
+
+//! \brief recalcule les transferts si transfers.txt a changé ou si des stations sont apparues ou disparues (ou ont
+//! changé, lorsque des trajets à pied y sont fusionnés: voir DonneesGTFS::ajouterTrajetsAPied())
+void RechargeurGTFS::rechargerTransferts()
+{
+    bool stationsChangees = m_rapport.nbStationsAjoutees != 0 || m_rapport.nbStationsRetirees != 0
+                            || (m_donnees.m_rayonMarche > 0 && m_rapport.nbStationsModifiees != 0);
+    if (!m_modifies[TRANSFERS] && !stationsChangees) return;
+
+    if (m_modifies[TRANSFERS])
+    {
+        const FichierMappe &fichier = *m_fichiers[TRANSFERS];
+        LecteurEnregistrements<EnregistrementTransfert> lecteur(fichier.debut(), fichier.fin());
+        EnregistrementTransfert enregistrement;
+        m_etat.transferts.clear();
+        while (lecteur.lire(enregistrement))
+        {
+            if (enregistrement.tempsMinimal.empty()) continue;
+            m_etat.transferts.push_back(std::make_tuple(enregistrement.deStationId.str(),
+                                                        enregistrement.versStationId.str(),
+                                                        champVersEntier(enregistrement.tempsMinimal)));
+        }
+    }
+
+    m_donnees.m_transferts.clear();
+    m_donnees.m_stationsDeTransfert.clear();
+    for (const auto &transfert : m_etat.transferts)
+    {
+        std::uint32_t de = m_donnees.m_idsStations.trouver(std::get<0>(transfert));
+        std::uint32_t vers = m_donnees.m_idsStations.trouver(std::get<1>(transfert));
+        if (m_donnees.m_stations.contient(de) && m_donnees.m_stations.contient(vers))
+        {
+            m_donnees.m_transferts.push_back(std::make_tuple(de, vers, std::get<2>(transfert)));
+            m_donnees.m_stationsDeTransfert.ajouter(de);
+        }
+    }
+    m_donnees.indexerTransferts();
+    m_donnees.appliquerTrajetsAPied();
+    m_rapport.transfertsRecalcules = true;
+}
+
+//! \brief recopie les arrêts présents dans une nouvelle arène lorsque les arrêts retirés par les rechargements
+//! successifs occupent plus de la moitié de l'arène; seules les poignées de m_etat.arretsRetenus y font référence
+void RechargeurGTFS::compacterArrets()
+{
+    Arene<Arret> &arene = m_donnees.m_arrets;
+    if (arene.taille() <= 2 * static_cast<std::size_t>(m_donnees.m_nbArrets) + (1 << 14)) return;
+
+    Arene<Arret> nouvelle(1 << 14);
+    nouvelle.reserver(m_donnees.m_nbArrets);
+    for (auto &voyage : m_etat.arretsRetenus)
+    {
+        for (auto &arret : voyage.second) arret = nouvelle.creer(*arret);
+    }
+    arene.echanger(nouvelle);
+}
+
+/*!
+ * \brief met à jour la table des arrêts en colonnes et l'index des stations lorsque des voyages ont été reconstruits
+ * \brief Lorsque chaque voyage touché garde son nombre d'arrêts (une heure modifiée, par exemple), seules ses rangées
+ * sont réécrites sur place, puis seules les plages des stations concernées sont triées de nouveau, si elles gardent
+ * leur taille. Sinon, les plages de tous les voyages se décalent: la table, ou l'index, est reconstruit au complet
+ */
+void RechargeurGTFS::indexerArrets()
+{
+    if (m_voyagesTouches.empty()) return;
+    if (corrigerArrets()) return;
+
+    std::vector<Arret::Ptr> arrets;
+    arrets.reserve(m_donnees.m_nbArrets);
+    for (const auto &voyage : m_etat.arretsRetenus)
+    {
+        arrets.insert(arrets.end(), voyage.second.begin(), voyage.second.end());
+    }
+    m_donnees.indexerArrets(arrets);
+}
+
+//! \brief réécrit sur place les rangées des voyages touchés (voir indexerArrets())
+//! \return false si un voyage touché change de nombre d'arrêts ou si des identifiants ont été ajoutés; la table peut
+//! alors être en partie réécrite, et doit être reconstruite
+bool RechargeurGTFS::corrigerArrets()
+{
+    TableArrets &table = m_donnees.m_tableArrets;
+    IndexStations &index = m_donnees.m_indexStations;
+    if (table.nbVoyages() != m_donnees.m_idsVoyages.taille()) return false;
+    if (index.nbStations() != m_donnees.m_idsStations.taille()) return false;
+
+    static const std::vector<Arret::Ptr> aucun;
+    std::vector<std::uint32_t> voyages;
+    std::vector<std::uint32_t> rangees;
+    std::vector<std::uint32_t> anciennesStations;
+    for (const auto &voyageId : m_voyagesTouches)
+    {
+        std::uint32_t v = m_donnees.m_idsVoyages.trouver(voyageId);
+        if (v == TableIdentifiants::ABSENT) continue;
+        PlageArrets plage = table.plage(v);
+        std::uint32_t debut = table.getDebuts()[v];
+        for (std::size_t i = 0; i < plage.size(); ++i)
+        {
+            rangees.push_back(debut + static_cast<std::uint32_t>(i));
+            anciennesStations.push_back(plage.stations[i]);
+        }
+        auto itr = m_etat.arretsRetenus.find(voyageId);
+        if (!table.remplacer(v, itr == m_etat.arretsRetenus.end() ? aucun : itr->second)) return false;
+        voyages.push_back(v);
+    }
+
+    if (!index.corriger(table, rangees, anciennesStations)) m_donnees.indexerStations();
+    for (std::uint32_t v : voyages)
+    {
+        if (m_donnees.m_voyages.contient(v)) m_donnees.m_voyages[v].setArrets(table.plage(v));
+    }
+    return true;
+}
+
+//! \brief ajoute ou retire les stations touchées selon qu'elles sont dans stops.txt et ont au moins un arrêt dans
+//! l'index, puis compte les stations ajoutées, retirées et modifiées
+void RechargeurGTFS::synchroniserStations()
+{
+    for (const auto &station : m_stationsTouchees)
+    {
+        std::uint32_t s = station.first;
+        PlageStation plage = m_donnees.m_indexStations.plage(s);
+        auto e_itr = m_etat.stations.find(m_donnees.m_idsStations.chaine(s));
+        if (plage.empty() || e_itr == m_etat.stations.end())
+        {
+            m_donnees.m_stations.retirer(s);
+            continue;
+        }
+        if (!m_donnees.m_stations.contient(s)) m_donnees.m_stations.inserer(s, e_itr->second.second);
+        m_donnees.m_stations[s].setArrets(plage);
+    }
+
+    for (const auto &station : m_stationsTouchees)
+    {
+        bool presente = m_donnees.m_stations.contient(station.first);
+        if (station.second && presente) ++m_rapport.nbStationsModifiees;
+        else if (station.second) ++m_rapport.nbStationsRetirees;
+        else if (presente) ++m_rapport.nbStationsAjoutees;
+    }
+}
+
+/*!
+ * \brief recharge le dossier GTFS en n'appliquant que les différences avec le chargement précédent
+ * \brief Seuls les fichiers dont l'empreinte a changé sont découpés, et seuls les voyages touchés sont reconstruits;
+ * le résultat est celui qu'un chargement complet donnerait pour la même date et le même intervalle
+ * \brief Au premier appel, l'objet est vidé puis chargé au complet. Les autres chargements (charger(),
+ * chargerInstantane(), chargerDepuisHoraire(), les méthodes ajouter*) oublient le chargement précédent: l'appel
+ * suivant recharge alors aussi au complet
+ * \param[in] p_dossier: le dossier contenant les six fichiers GTFS
+ * \return ce qui a été ajouté, retiré ou modifié dans l'objet
+ * \throws logic_error si un problème survient avec la lecture d'un fichier; l'appel suivant recharge alors au complet
+ */
+RapportRechargement DonneesGTFS::recharger(const std::string &p_dossier)
+{
+    RapportRechargement rapport;
+    auto debut = std::chrono::steady_clock::now();
+    RechargeurGTFS rechargeur(*this, p_dossier, rapport);
+    rechargeur.recharger();
+    rapport.duree = std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+    return rapport;
+}
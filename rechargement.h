@@ -0,0 +1,87 @@
+//
+// Rechargement incrémental d'un dossier GTFS: seuls les enregistrements modifiés depuis le chargement précédent
+// sont appliqués à l'objet DonneesGTFS.
+//
+
+#ifndef RTC_RECHARGEMENT_H
+#define RTC_RECHARGEMENT_H
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <cstddef>
+
+#include "station.h"
+#include "voyage.h"
+#include "arret.h"
+
+/*!
+ * \struct RapportRechargement
+ * \brief Ce que DonneesGTFS::recharger() a modifié dans l'objet
+ * \note Les lignes sont comptées d'après routes.txt; les stations, voyages et arrêts d'après le contenu de l'objet
+ * (seuls ceux de la date et de l'intervalle [now1, now2) y sont présents)
+ */
+struct RapportRechargement
+{
+    RapportRechargement()
+            : complet(false), nbFichiersModifies(0), nbLignesAjoutees(0), nbLignesRetirees(0), nbLignesModifiees(0),
+              nbStationsAjoutees(0), nbStationsRetirees(0), nbStationsModifiees(0), nbServicesAjoutes(0),
+              nbServicesRetires(0), nbVoyagesAjoutes(0), nbVoyagesRetires(0), nbVoyagesModifies(0),
+              nbArretsAjoutes(0), nbArretsRetires(0), transfertsRecalcules(false), duree(0) {}
+
+    bool complet; //vrai si aucun chargement précédent n'était connu: tout a été lu
+    unsigned int nbFichiersModifies;
+    std::size_t nbLignesAjoutees;
+    std::size_t nbLignesRetirees;
+    std::size_t nbLignesModifiees;
+    std::size_t nbStationsAjoutees;
+    std::size_t nbStationsRetirees;
+    std::size_t nbStationsModifiees;
+    std::size_t nbServicesAjoutes;
+    std::size_t nbServicesRetires;
+    std::size_t nbVoyagesAjoutes;
+    std::size_t nbVoyagesRetires;
+    std::size_t nbVoyagesModifies;
+    std::size_t nbArretsAjoutes;
+    std::size_t nbArretsRetires;
+    bool transfertsRecalcules;
+    double duree; //en secondes
+};
+
+/*!
+ * \struct EtatRechargement
+ * \brief Empreintes du dernier chargement fait par DonneesGTFS::recharger(), comparées au chargement suivant
+ *
+ *  Chaque fichier a une empreinte globale: un fichier inchangé n'est pas découpé. Sinon, chaque enregistrement a son
+ *  empreinte, regroupée par identifiant (route_id, stop_id, trip_id); pour stop_times.txt, l'empreinte d'un voyage
+ *  couvre tous ses enregistrements, dans l'ordre du fichier.
+ */
+struct EtatRechargement
+{
+    //! les enregistrements de stop_times.txt d'un voyage
+    struct ArretsDuVoyage
+    {
+        std::uint64_t empreinte;
+        std::vector<std::pair<std::size_t, std::size_t> > plages; //<décalage, longueur> d'enregistrements contigus
+    };
+
+    EtatRechargement() : valide(false), empreintesFichiers() {}
+
+    bool valide;
+    std::uint64_t empreintesFichiers[6]; //routes, stops, calendar_dates, trips, stop_times, transfers
+
+    std::unordered_map<std::string, std::uint64_t> lignes; //route_id -> empreinte
+    std::unordered_map<std::string, std::pair<std::uint64_t, Station> > stations; //stop_id -> empreinte, station sans arrêts
+    std::unordered_map<std::string, std::pair<std::uint64_t, Voyage> > voyages; //trip_id -> empreinte, voyage sans arrêts
+    std::unordered_map<std::string, std::unordered_set<std::string> > voyagesDesServices; //service_id -> trip_id
+    std::unordered_map<std::string, ArretsDuVoyage> arretsDesVoyages; //trip_id -> enregistrements de stop_times.txt
+    std::vector<std::tuple<std::string, std::string, unsigned int> > transferts; //ceux de transfers.txt avec un temps
+
+    std::unordered_map<std::string, std::vector<Arret::Ptr> > arretsRetenus; //trip_id -> arrêts présents dans l'objet
+};
+
+#endif //RTC_RECHARGEMENT_H
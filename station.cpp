@@ -70,15 +70,16 @@ std::string Station::getId() const
     return m_id;
 }
 
-void Station::addArret(const Arret::Ptr &p_arret)
+//! \brief retourne la plage m_arrets par référence constante
+const PlageStation &Station::getArrets() const
 {
-    m_arrets.insert({p_arret->getHeureArrivee(), p_arret});
+    return m_arrets;
 }
 
-//! \brief retourne le conteneur m_arrets par référence constante
-const std::multimap<Heure, Arret::Ptr> &Station::getArrets() const
+//! \brief associe à la station ses arrêts dans l'index des stations (voir DonneesGTFS::getIndexStations())
+void Station::setArrets(const PlageStation &p_arrets)
 {
-    return m_arrets;
+    m_arrets = p_arrets;
 }
 
 unsigned int Station::getNbArrets() const
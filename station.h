@@ -8,11 +8,10 @@
 
 #include <string>
 #include <vector>
-#include <map>
 #include <unordered_set>
 #include <iostream>
 #include "coordonnees.h"
-#include "arret.h"
+#include "indexstations.h"
 #include "auxiliaires.h"
 
 /*!
@@ -31,16 +30,16 @@ public:
 	const std::string& getDescription() const;
 	const std::string& getNom() const;
 	std::string getId() const;
-    void addArret(const Arret::Ptr & p_arret);
     unsigned int getNbArrets() const;
-    const std::multimap<Heure, Arret::Ptr> & getArrets() const;
+    const PlageStation & getArrets() const;
+    void setArrets(const PlageStation & p_arrets);
 
 private:
     std::string m_id;
     std::string m_nom;
     std::string m_description;
     Coordonnees m_coords;
-    std::multimap<Heure, Arret::Ptr> m_arrets;
+    PlageStation m_arrets; //tranche de DonneesGTFS::getIndexStations(), par heure de départ croissante
 
 };
 
@@ -0,0 +1,191 @@
+//
+// Table des arrêts en colonnes, triée par (voyage, numéro de séquence).
+//
+
+#include "tablearrets.h"
+#include <algorithm>
+#include <stdexcept>
+
+/*!
+ * \brief reconstruit la table à partir des arrêts donnés
+ * \param[in] p_arrets: les arrêts, dans l'ordre de leur lecture
+ * \param[in] p_nbVoyages: borne des identifiants de voyages
+ * \throws logic_error si un arrêt désigne un voyage >= p_nbVoyages, ou si les numéros de séquence d'un voyage
+ * contredisent ses heures
+ * \note Comme l'ancien std::set des voyages, un arrêt dont le numéro de séquence est déjà présent dans son voyage est
+ * ignoré: le premier lu est conservé
+ */
+void TableArrets::construire(const std::vector<Arret::Ptr> &p_arrets, std::uint32_t p_nbVoyages)
+{
+    // Tri par dénombrement sur le voyage: stable, il conserve l'ordre de lecture à l'intérieur d'un voyage
+    std::vector<std::uint32_t> debuts(static_cast<std::size_t>(p_nbVoyages) + 1, 0);
+    for (Arret::Ptr a : p_arrets)
+    {
+        if (a->getVoyage() >= p_nbVoyages) throw std::logic_error("TableArrets::construire(): voyage hors borne");
+        ++debuts[a->getVoyage() + 1];
+    }
+    for (std::uint32_t v = 0; v < p_nbVoyages; ++v) debuts[v + 1] += debuts[v];
+    std::vector<Arret::Ptr> ordre(p_arrets.size());
+    {
+        std::vector<std::uint32_t> prochain(debuts.begin(), debuts.end() - 1);
+        for (Arret::Ptr a : p_arrets) ordre[prochain[a->getVoyage()]++] = a;
+    }
+
+    m_stations.resize(ordre.size());
+    m_arrivees.resize(ordre.size());
+    m_departs.resize(ordre.size());
+    m_sequences.resize(ordre.size());
+    m_voyages.resize(ordre.size());
+    m_debuts.assign(debuts.size(), 0);
+
+    auto parSequence = [](Arret::Ptr a, Arret::Ptr b) {
+        return a->getNumeroSequence() < b->getNumeroSequence();
+    };
+    std::size_t k = 0;
+    for (std::uint32_t v = 0; v < p_nbVoyages; ++v)
+    {
+        auto debut = ordre.begin() + debuts[v];
+        auto fin = ordre.begin() + debuts[v + 1];
+        // Les arrêts d'un voyage sont presque toujours déjà dans l'ordre du fichier
+        if (!std::is_sorted(debut, fin, parSequence)) std::stable_sort(debut, fin, parSequence);
+
+        m_debuts[v] = static_cast<std::uint32_t>(k);
+        for (auto itr = debut; itr != fin; ++itr)
+        {
+            Arret::Ptr a = *itr;
+            if (k > m_debuts[v])
+            {
+                if (m_sequences[k - 1] == a->getNumeroSequence()) continue;
+                if (m_departs[k - 1] > a->getCodeArrivee())
+                    throw std::logic_error("Incohérence des numéros de séquences avec les heures");
+            }
+            m_stations[k] = a->getStation();
+            m_arrivees[k] = a->getCodeArrivee();
+            m_departs[k] = a->getCodeDepart();
+            m_sequences[k] = a->getNumeroSequence();
+            m_voyages[k] = v;
+            ++k;
+        }
+    }
+    m_debuts[p_nbVoyages] = static_cast<std::uint32_t>(k);
+
+    m_stations.resize(k);
+    m_arrivees.resize(k);
+    m_departs.resize(k);
+    m_sequences.resize(k);
+    m_voyages.resize(k);
+}
+
+/*!
+ * \brief réécrit sur place les rangées du voyage p_voyage, lorsque ses nouveaux arrêts en occupent autant
+ * \brief Les plages des autres voyages, et donc les rangées désignées par un IndexStations, ne bougent pas; les
+ * arrêts sont rangés et filtrés comme par construire()
+ * \param[in] p_voyage: le voyage
+ * \param[in] p_arrets: ses nouveaux arrêts, dans l'ordre de leur lecture; aucun pour un voyage retiré
+ * \return false (sans modifier la table) si p_voyage est hors borne ou si le nombre de rangées du voyage changerait
+ * \throws logic_error si un arrêt désigne un autre voyage, ou si les numéros de séquence contredisent les heures
+ */
+bool TableArrets::remplacer(std::uint32_t p_voyage, const std::vector<Arret::Ptr> &p_arrets)
+{
+    if (p_voyage >= nbVoyages()) return false;
+    std::uint32_t debut = m_debuts[p_voyage];
+    std::size_t nombre = m_debuts[p_voyage + 1] - debut;
+    if (p_arrets.size() < nombre) return false;
+
+    std::vector<Arret::Ptr> ordre(p_arrets);
+    auto parSequence = [](Arret::Ptr a, Arret::Ptr b) {
+        return a->getNumeroSequence() < b->getNumeroSequence();
+    };
+    if (!std::is_sorted(ordre.begin(), ordre.end(), parSequence))
+        std::stable_sort(ordre.begin(), ordre.end(), parSequence);
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < ordre.size(); ++i)
+    {
+        Arret::Ptr a = ordre[i];
+        if (a->getVoyage() != p_voyage) throw std::logic_error("TableArrets::remplacer(): arrêt d'un autre voyage");
+        if (k > 0)
+        {
+            if (ordre[k - 1]->getNumeroSequence() == a->getNumeroSequence()) continue;
+            if (ordre[k - 1]->getCodeDepart() > a->getCodeArrivee())
+                throw std::logic_error("Incohérence des numéros de séquences avec les heures");
+        }
+        ordre[k++] = a;
+    }
+    if (k != nombre) return false;
+
+    for (std::size_t i = 0; i < nombre; ++i)
+    {
+        Arret::Ptr a = ordre[i];
+        m_stations[debut + i] = a->getStation();
+        m_arrivees[debut + i] = a->getCodeArrivee();
+        m_departs[debut + i] = a->getCodeDepart();
+        m_sequences[debut + i] = a->getNumeroSequence();
+    }
+    return true;
+}
+
+void TableArrets::vider()
+{
+    m_stations.clear();
+    m_arrivees.clear();
+    m_departs.clear();
+    m_sequences.clear();
+    m_voyages.clear();
+    m_debuts.clear();
+}
+
+//! \brief les arrêts du voyage p_voyage; une plage vide pour un voyage hors borne
+PlageArrets TableArrets::plage(std::uint32_t p_voyage) const
+{
+    PlageArrets plage;
+    if (p_voyage >= nbVoyages()) return plage;
+    std::uint32_t debut = m_debuts[p_voyage];
+    plage.nombre = m_debuts[p_voyage + 1] - debut;
+    if (plage.nombre == 0) return plage;
+    plage.stations = m_stations.data() + debut;
+    plage.arrivees = m_arrivees.data() + debut;
+    plage.departs = m_departs.data() + debut;
+    plage.sequences = m_sequences.data() + debut;
+    return plage;
+}
+
+//! \brief le nombre de rangées
+std::size_t TableArrets::taille() const
+{
+    return m_stations.size();
+}
+
+std::uint32_t TableArrets::nbVoyages() const
+{
+    return m_debuts.empty() ? 0 : static_cast<std::uint32_t>(m_debuts.size() - 1);
+}
+
+const std::vector<std::uint32_t> &TableArrets::getStations() const
+{
+    return m_stations;
+}
+
+const std::vector<std::uint32_t> &TableArrets::getArrivees() const
+{
+    return m_arrivees;
+}
+
+const std::vector<std::uint32_t> &TableArrets::getDeparts() const
+{
+    return m_departs;
+}
+
+const std::vector<std::uint32_t> &TableArrets::getSequences() const
+{
+    return m_sequences;
+}
+
+const std::vector<std::uint32_t> &TableArrets::getVoyages() const
+{
+    return m_voyages;
+}
+
+const std::vector<std::uint32_t> &TableArrets::getDebuts() const
+{
+    return m_debuts;
+}
@@ -0,0 +1,73 @@
+//
+// Table des arrêts en colonnes, triée par (voyage, numéro de séquence).
+//
+
+#ifndef RTC_TABLEARRETS_H
+#define RTC_TABLEARRETS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "arret.h"
+
+/*!
+ * \struct PlageArrets
+ * \brief Les arrêts d'un voyage: une tranche contiguë de chacune des colonnes de TableArrets, par numéro de séquence
+ * croissant
+ * \note Les pointeurs sont valides jusqu'à la prochaine construction de la table
+ */
+struct PlageArrets
+{
+    PlageArrets() : stations(nullptr), arrivees(nullptr), departs(nullptr), sequences(nullptr), nombre(0) {}
+
+    const std::uint32_t *stations;  //identifiants denses des stations
+    const std::uint32_t *arrivees;  //codes des heures, en secondes depuis 00h00m00s
+    const std::uint32_t *departs;
+    const std::uint32_t *sequences;
+    std::size_t nombre;
+
+    std::size_t size() const
+    {
+        return nombre;
+    }
+
+    bool empty() const
+    {
+        return nombre == 0;
+    }
+};
+
+/*!
+ * \class TableArrets
+ * \brief Les arrêts de tous les voyages rangés en colonnes parallèles (station, arrivée, départ, séquence, voyage)
+ *
+ *  Les rangées sont triées par voyage puis par numéro de séquence: les arrêts du voyage v occupent les rangées
+ *  [getDebuts()[v], getDebuts()[v + 1]). Un parcours de voyage ne lit que les colonnes dont il a besoin, en séquence.
+ */
+class TableArrets
+{
+public:
+    void construire(const std::vector<Arret::Ptr> &p_arrets, std::uint32_t p_nbVoyages);
+    bool remplacer(std::uint32_t p_voyage, const std::vector<Arret::Ptr> &p_arrets);
+    void vider();
+    PlageArrets plage(std::uint32_t p_voyage) const;
+    std::size_t taille() const;
+    std::uint32_t nbVoyages() const;
+
+    const std::vector<std::uint32_t> &getStations() const;
+    const std::vector<std::uint32_t> &getArrivees() const;
+    const std::vector<std::uint32_t> &getDeparts() const;
+    const std::vector<std::uint32_t> &getSequences() const;
+    const std::vector<std::uint32_t> &getVoyages() const;
+    const std::vector<std::uint32_t> &getDebuts() const;
+
+private:
+    std::vector<std::uint32_t> m_stations;
+    std::vector<std::uint32_t> m_arrivees;
+    std::vector<std::uint32_t> m_departs;
+    std::vector<std::uint32_t> m_sequences;
+    std::vector<std::uint32_t> m_voyages;  //redondante avec m_debuts; sert aux parcours par station (IndexStations)
+    std::vector<std::uint32_t> m_debuts; //nbVoyages() + 1 positions
+};
+
+#endif //RTC_TABLEARRETS_H
@@ -0,0 +1,154 @@
+//
+// Tableaux des prochains départs de chaque station, indexés par minute.
+//
+
+#include "tableaudeparts.h"
+#include "DonneesGTFS.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+TableauDeparts::TableauDeparts() : m_nbStations(0)
+{
+}
+
+/*!
+ * \brief reconstruit les départs de chaque station et leurs seaux à partir de l'index des stations de p_donnees
+ * \throws logic_error si un arrêt désigne un voyage absent de getVoyages() ou une ligne absente de getLignes()
+ */
+void TableauDeparts::construire(const DonneesGTFS &p_donnees)
+{
+    vider();
+    const IndexStations &index = p_donnees.getIndexStations();
+    const TableArrets &table = p_donnees.getTableArrets();
+    const Registre<Voyage> &voyages = p_donnees.getVoyages();
+    const Registre<Ligne> &lignes = p_donnees.getLignes();
+    m_nbStations = index.nbStations();
+
+    // Numéro de ligne et destination de chaque voyage, une seule fois par voyage
+    std::unordered_map<std::string, std::uint32_t> rangs;
+    auto interner = [&](const std::string &p_libelle) {
+        auto insertion = rangs.insert(std::make_pair(p_libelle, static_cast<std::uint32_t>(m_libelles.size())));
+        if (insertion.second) m_libelles.push_back(p_libelle);
+        return insertion.first->second;
+    };
+    std::vector<std::uint32_t> numeros(p_donnees.getIdsVoyages().taille(), TableIdentifiants::ABSENT);
+    std::vector<std::uint32_t> destinations(numeros.size(), TableIdentifiants::ABSENT);
+    for (auto voyageM : voyages)
+    {
+        const Voyage &voyage = voyageM.second;
+        if (!lignes.contient(voyage.getLigne()))
+            throw std::logic_error("TableauDeparts::construire(): ligne_id absent de getLignes()");
+        numeros[voyageM.first] = interner(lignes[voyage.getLigne()].getNumero());
+        destinations[voyageM.first] = interner(voyage.getDestination());
+    }
+
+    const std::vector<std::uint32_t> &voyagesTable = table.getVoyages();
+    const std::vector<std::uint32_t> &debutsVoyages = table.getDebuts();
+    m_departs.reserve(index.taille());
+    m_debuts.reserve(static_cast<std::size_t>(m_nbStations) + 1);
+    m_minutes.reserve(m_nbStations);
+    m_debutsSeaux.reserve(static_cast<std::size_t>(m_nbStations) + 1);
+    for (std::uint32_t s = 0; s < m_nbStations; ++s)
+    {
+        std::uint32_t debut = static_cast<std::uint32_t>(m_departs.size());
+        m_debuts.push_back(debut);
+        m_debutsSeaux.push_back(static_cast<std::uint32_t>(m_seaux.size()));
+        PlageStation plage = index.plage(s);
+        for (std::size_t i = 0; i < plage.size(); ++i)
+        {
+            std::uint32_t rangee = plage.rangees[i];
+            std::uint32_t voyage = voyagesTable[rangee];
+            if (rangee + 1 == debutsVoyages[voyage + 1]) continue;
+            if (numeros[voyage] == TableIdentifiants::ABSENT)
+                throw std::logic_error("TableauDeparts::construire(): voyage_id absent de getVoyages()");
+            Depart depart = {plage.departs[i], voyage, numeros[voyage], destinations[voyage]};
+            m_departs.push_back(depart);
+        }
+
+        std::uint32_t fin = static_cast<std::uint32_t>(m_departs.size());
+        m_minutes.push_back(debut == fin ? 0 : m_departs[debut].heure / 60);
+        if (debut == fin) continue;
+        std::uint32_t position = debut;
+        for (std::uint32_t minute = m_minutes.back(); minute <= m_departs[fin - 1].heure / 60; ++minute)
+        {
+            while (m_departs[position].heure < minute * 60) ++position;
+            m_seaux.push_back(position);
+        }
+    }
+    m_debuts.push_back(static_cast<std::uint32_t>(m_departs.size()));
+    m_debutsSeaux.push_back(static_cast<std::uint32_t>(m_seaux.size()));
+}
+
+void TableauDeparts::vider()
+{
+    m_nbStations = 0;
+    m_departs.clear();
+    m_debuts.clear();
+    m_minutes.clear();
+    m_debutsSeaux.clear();
+    m_seaux.clear();
+    m_libelles.clear();
+}
+
+/*!
+ * \brief les p_nombre premiers départs de p_station à p_heure ou après (moins s'il n'en reste pas autant)
+ * \param[in] p_heure: un code d'heure, en secondes depuis 00h00m00s
+ * \throws logic_error si p_station n'est pas une station du réseau
+ */
+PlageDeparts TableauDeparts::prochains(std::uint32_t p_station, std::uint32_t p_heure, std::size_t p_nombre) const
+{
+    if (p_station >= m_nbStations) throw std::logic_error("TableauDeparts::prochains(): station hors borne");
+    std::size_t position = chercher(p_station, p_heure);
+    PlageDeparts tableau;
+    tableau.departs = m_departs.data() + position;
+    tableau.nombre = std::min<std::size_t>(p_nombre, m_debuts[p_station + 1] - position);
+    return tableau;
+}
+
+/*!
+ * \brief un tableau par requête: p_tableaux[i] répond à p_requetes[i]
+ * \throws logic_error si une requête désigne une station hors borne; p_tableaux est alors incomplet
+ */
+void TableauDeparts::prochains(const std::vector<RequeteTableau> &p_requetes,
+                               std::vector<PlageDeparts> &p_tableaux) const
+{
+    p_tableaux.resize(p_requetes.size());
+    for (std::size_t i = 0; i < p_requetes.size(); ++i)
+    {
+        const RequeteTableau &requete = p_requetes[i];
+        p_tableaux[i] = prochains(requete.station, requete.heure, requete.nombre);
+    }
+}
+
+//! \brief le numéro de ligne ou la destination de rang p_rang (Depart::numero, Depart::destination)
+const std::string &TableauDeparts::libelle(std::uint32_t p_rang) const
+{
+    if (p_rang >= m_libelles.size()) throw std::logic_error("TableauDeparts::libelle(): rang hors borne");
+    return m_libelles[p_rang];
+}
+
+//! \brief le nombre de départs, toutes stations confondues
+std::size_t TableauDeparts::taille() const
+{
+    return m_departs.size();
+}
+
+std::uint32_t TableauDeparts::nbStations() const
+{
+    return m_nbStations;
+}
+
+//! \brief position du premier départ de p_station à p_heure ou après: le seau de sa minute, puis cette minute
+std::size_t TableauDeparts::chercher(std::uint32_t p_station, std::uint32_t p_heure) const
+{
+    std::uint32_t debut = m_debuts[p_station];
+    std::uint32_t fin = m_debuts[p_station + 1];
+    std::uint32_t minute = p_heure / 60;
+    if (debut == fin || minute < m_minutes[p_station]) return debut;
+    std::uint32_t seau = minute - m_minutes[p_station];
+    if (seau >= m_debutsSeaux[p_station + 1] - m_debutsSeaux[p_station]) return fin;
+    std::uint32_t position = m_seaux[m_debutsSeaux[p_station] + seau];
+    while (position < fin && m_departs[position].heure < p_heure) ++position;
+    return position;
+}
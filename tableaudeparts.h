@@ -0,0 +1,101 @@
+//
+// Tableaux des prochains départs de chaque station, indexés par minute.
+//
+
+#ifndef RTC_TABLEAUDEPARTS_H
+#define RTC_TABLEAUDEPARTS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+class DonneesGTFS;
+
+/*!
+ * \struct Depart
+ * \brief Une ligne d'un tableau des départs, dont le numéro de ligne et la destination sont déjà résolus
+ */
+struct Depart
+{
+    std::uint32_t heure;       //code de l'heure de départ, en secondes depuis 00h00m00s
+    std::uint32_t voyage;      //identifiant dense du trip_id
+    std::uint32_t numero;      //rang du numéro de ligne dans TableauDeparts::libelle()
+    std::uint32_t destination; //rang de la destination (trip_headsign) dans TableauDeparts::libelle()
+};
+
+/*!
+ * \struct PlageDeparts
+ * \brief Un tableau des départs: une tranche contiguë de TableauDeparts, par heure de départ croissante
+ * \note Les pointeurs sont valides jusqu'à la prochaine construction du TableauDeparts
+ */
+struct PlageDeparts
+{
+    PlageDeparts() : departs(nullptr), nombre(0) {}
+
+    const Depart *departs;
+    std::size_t nombre;
+
+    std::size_t size() const
+    {
+        return nombre;
+    }
+
+    bool empty() const
+    {
+        return nombre == 0;
+    }
+};
+
+/*!
+ * \struct RequeteTableau
+ * \brief «les p_nombre prochains départs de la station à partir de l'heure»
+ */
+struct RequeteTableau
+{
+    std::uint32_t station; //identifiant dense
+    std::uint32_t heure;   //code de l'heure
+    std::uint32_t nombre;
+};
+
+/*!
+ * \class TableauDeparts
+ * \brief Répond aux requêtes «les N prochains départs de la station S à partir de l'heure t» des afficheurs
+ *
+ *  Les départs de chaque station sont rangés d'un seul bloc, par heure croissante, avec le numéro de ligne et la
+ *  destination de leur voyage déjà joints: un tableau n'est qu'une tranche du bloc, sans copie ni recherche dans
+ *  les registres. Un seau par minute, de la première à la dernière minute de départ de la station, donne la
+ *  position du premier départ de cette minute ou après; une requête lit le seau de sa minute puis avance d'au plus
+ *  les départs de cette même minute.
+ *
+ *  Le dernier arrêt d'un voyage n'est pas un départ et n'apparaît pas. Comme PlanificateurRaptor, le tableau est
+ *  une photographie de DonneesGTFS: il doit être reconstruit si elles changent; il n'est que lu par les requêtes,
+ *  qui peuvent venir de plusieurs fils.
+ */
+class TableauDeparts
+{
+public:
+    TableauDeparts();
+
+    void construire(const DonneesGTFS &p_donnees);
+    void vider();
+    PlageDeparts prochains(std::uint32_t p_station, std::uint32_t p_heure, std::size_t p_nombre) const;
+    void prochains(const std::vector<RequeteTableau> &p_requetes, std::vector<PlageDeparts> &p_tableaux) const;
+
+    const std::string &libelle(std::uint32_t p_rang) const;
+    std::size_t taille() const;
+    std::uint32_t nbStations() const;
+
+private:
+    std::size_t chercher(std::uint32_t p_station, std::uint32_t p_heure) const;
+
+    std::uint32_t m_nbStations;
+    std::vector<Depart> m_departs;            //station par station, par heure croissante
+    std::vector<std::uint32_t> m_debuts;      //nbStations() + 1 positions dans m_departs
+    std::vector<std::uint32_t> m_minutes;     //par station: minute du premier seau
+    std::vector<std::uint32_t> m_debutsSeaux; //nbStations() + 1 positions dans m_seaux
+    std::vector<std::uint32_t> m_seaux;       //position dans m_departs du premier départ de la minute ou après
+    std::vector<std::string> m_libelles;      //numéros de ligne et destinations, sans doublon
+};
+
+#endif //RTC_TABLEAUDEPARTS_H
@@ -0,0 +1,72 @@
+//
+// Trajets à pied générés entre les stations rapprochées.
+//
+
+#include "trajetsapied.h"
+#include "indexspatial.h"
+#include "parallele.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    const std::size_t NB_STATIONS_PAR_MORCEAU = 1024; //stations d'une tâche du calcul des durées
+}
+
+/*!
+ * \brief génère un trajet à pied entre chaque paire ordonnée de stations distinctes à au plus p_rayon km
+ * \brief Les paires candidates viennent d'un IndexSpatial (recherche par rayon par lots, répartie entre les fils);
+ * la durée de chaque trajet, arrondie à la seconde supérieure, est calculée en parallèle
+ * \param[in] p_rayon: la distance à vol d'oiseau maximale, en km
+ * \param[in] p_vitesse: la vitesse de marche, en m/s
+ * \param[out] p_trajets: les trajets <from_station, to_station, durée en secondes>, par station de départ dans
+ * l'ordre de p_stations, puis par distance croissante
+ * \throws logic_error si p_vitesse n'est pas positive
+ */
+void genererTrajetsAPied(const Registre<Station> &p_stations, double p_rayon, double p_vitesse,
+                         std::vector<std::tuple<std::uint32_t, std::uint32_t, unsigned int> > &p_trajets)
+{
+    if (!(p_vitesse > 0)) throw std::logic_error("genererTrajetsAPied(): la vitesse doit être positive");
+    p_trajets.clear();
+
+    IndexSpatial index;
+    index.construire(p_stations);
+    std::vector<std::uint32_t> stations;
+    std::vector<Coordonnees> centres;
+    stations.reserve(p_stations.size());
+    centres.reserve(p_stations.size());
+    for (auto stationM : p_stations)
+    {
+        stations.push_back(stationM.first);
+        centres.push_back(stationM.second.getCoords());
+    }
+    std::vector<std::uint32_t> debuts;
+    std::vector<Voisin> voisins;
+    index.dansRayon(centres, p_rayon, debuts, voisins);
+
+    // Chaque station se trouve elle-même; les positions des trajets de chacune s'en déduisent
+    std::vector<std::size_t> positions(stations.size() + 1, 0);
+    for (std::size_t i = 0; i < stations.size(); ++i)
+    {
+        std::size_t nombre = 0;
+        for (std::uint32_t j = debuts[i]; j < debuts[i + 1]; ++j) nombre += voisins[j].station != stations[i];
+        positions[i + 1] = positions[i] + nombre;
+    }
+    p_trajets.resize(positions.back());
+
+    std::size_t nbMorceaux = (stations.size() + NB_STATIONS_PAR_MORCEAU - 1) / NB_STATIONS_PAR_MORCEAU;
+    executerEnParallele(nbMorceaux, [&](std::size_t k) {
+        std::size_t fin = std::min(stations.size(), (k + 1) * NB_STATIONS_PAR_MORCEAU);
+        for (std::size_t i = k * NB_STATIONS_PAR_MORCEAU; i < fin; ++i)
+        {
+            std::size_t position = positions[i];
+            for (std::uint32_t j = debuts[i]; j < debuts[i + 1]; ++j)
+            {
+                if (voisins[j].station == stations[i]) continue;
+                unsigned int duree = static_cast<unsigned int>(std::ceil(voisins[j].distance * 1000 / p_vitesse));
+                p_trajets[position++] = std::make_tuple(stations[i], voisins[j].station, duree);
+            }
+        }
+    });
+}
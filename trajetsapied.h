@@ -0,0 +1,20 @@
+//
+// Trajets à pied générés entre les stations rapprochées.
+//
+
+#ifndef RTC_TRAJETSAPIED_H
+#define RTC_TRAJETSAPIED_H
+
+#include <vector>
+#include <tuple>
+#include <cstdint>
+#include "identifiants.h"
+#include "station.h"
+
+const double RAYON_MARCHE = 0.3;   //en km, distance à vol d'oiseau maximale d'un trajet à pied
+const double VITESSE_MARCHE = 1.2; //en m/s
+
+void genererTrajetsAPied(const Registre<Station> &p_stations, double p_rayon, double p_vitesse,
+                         std::vector<std::tuple<std::uint32_t, std::uint32_t, unsigned int> > &p_trajets);
+
+#endif //RTC_TRAJETSAPIED_H
@@ -4,77 +4,80 @@
 //
 
 #include "voyage.h"
+#include "identifiants.h"
+#include <stdexcept>
 
 /*!
  * \brief Constructeur de la classes Voyage
- * \param[in] p_id : identificateur du voyage
- * \param[in] p_ligne_id : identificateur de la ligne desservie par le voyage
- * \param[in] p_service_id: identificateur du service auquel ce voyage appartient
+ * \param[in] p_id : identifiant dense du voyage
+ * \param[in] p_ligne : identifiant dense de la ligne desservie par le voyage
+ * \param[in] p_service: identifiant dense du service auquel ce voyage appartient
  * \param[in] p_destination: destination du voyage
  */
-Voyage::Voyage(const std::string &p_id, std::string p_ligne_id, const std::string &p_service_id,
-               const std::string &p_destination) :
-        m_id(p_id), m_ligne(p_ligne_id), m_service_id(p_service_id), m_destination(p_destination)
+Voyage::Voyage(std::uint32_t p_id, std::uint32_t p_ligne, std::uint32_t p_service, const std::string &p_destination) :
+        m_id(p_id), m_ligne(p_ligne), m_service(p_service), m_destination(p_destination)
 {
 }
 
-Voyage::Voyage()
+Voyage::Voyage() : m_id(TableIdentifiants::ABSENT), m_ligne(TableIdentifiants::ABSENT),
+                   m_service(TableIdentifiants::ABSENT)
 {
 }
 
-//! \brief retourne le conteneur m_arrets par référence constante
-const std::set<Arret::Ptr, Voyage::compArret> &Voyage::getArrets() const
+//! \brief retourne la plage m_arrets par référence constante
+const PlageArrets &Voyage::getArrets() const
 {
     return m_arrets;
 }
 
+//! \brief associe au voyage ses arrêts dans la table des arrêts (voir DonneesGTFS::getTableArrets())
+void Voyage::setArrets(const PlageArrets &p_arrets)
+{
+    m_arrets = p_arrets;
+}
+
 const std::string &Voyage::getDestination() const
 {
     return m_destination;
 }
 
-std::string Voyage::getId() const
+std::uint32_t Voyage::getId() const
 {
     return m_id;
 }
 
-std::string Voyage::getLigne() const
+std::uint32_t Voyage::getLigne() const
 {
     return m_ligne;
 }
 
-std::string Voyage::getServiceId() const
+std::uint32_t Voyage::getServiceId() const
 {
-    return m_service_id;
+    return m_service;
 }
 
 /*!
  * \brief retourne l'heure de départ du voyage, ie l'heure d'arrivée du premier arret dans m_arret
  * \return l'heure de départ
  * \exception std::logic_error s'il n'y a aucun arret pour ce voyage
- * \post m_arret est initialisé grâce à setArret
+ * \post m_arrets est initialisé grâce à setArrets
  */
 Heure Voyage::getHeureDepart() const
 {
     if (m_arrets.size() == 0) throw std::logic_error("aucun arret pour ce voyage");
-    return (*(m_arrets.begin()))->getHeureArrivee();
+    return Heure::depuisCode(m_arrets.arrivees[0]);
 }
 
 /*!
  * \brief retourne l'heure de fin du voyage, ie l'heure de d'arrivée du dernier arret dans m_arret
  * \return l'heure de fin
  * \exception std::logic_error s'il n'y a aucun arret pour ce voyage
- * \post m_arret est initialisé grâce à setArret
+ * \post m_arrets est initialisé grâce à setArrets
  */
 Heure Voyage::getHeureFin() const
 {
     if (m_arrets.size() == 0) throw std::logic_error("aucun arret pour ce voyage");
-    return (*(--m_arrets.end()))->getHeureArrivee();
-}
-
-void Voyage::ajouterArret(const Arret::Ptr &p_arret)
-{
-    m_arrets.insert(p_arret);
+    return Heure::depuisCode(m_arrets.arrivees[m_arrets.size() - 1]);
 }
 
 
@@ -116,12 +119,3 @@ unsigned int Voyage::getNbArrets() const
 {
     return (unsigned int) m_arrets.size();
 }
-
-//! \brief //foncteur de comparaison pour les arrets de m_arrets
-bool Voyage::compArret::operator()(Arret::Ptr i, Arret::Ptr j) const
-{
-    bool rep = i->getNumeroSequence() < j->getNumeroSequence();
-    if (rep && i->getHeureDepart() > j->getHeureArrivee())
-        throw std::logic_error("Incohérence des numéros de séquences avec les heures");
-    return rep;
-}
@@ -7,9 +7,8 @@
 #define RTC_VOYAGE_H
 
 #include <string>
-#include <set>
-#include <memory>
-#include "arret.h"
+#include <cstdint>
+#include "tablearrets.h"
 #include "auxiliaires.h"
 
 /*!
@@ -21,33 +20,28 @@ class Voyage {
 
 public:
 
-    struct compArret //foncteur de comparaison pour m_arrets
-    {
-        bool operator() (Arret::Ptr i, Arret::Ptr j) const;
-    };
-
-    Voyage(const std::string & p_id, std::string p_ligne_id, const std::string & p_service_id, const std::string & p_destination);
+    Voyage(std::uint32_t p_id, std::uint32_t p_ligne, std::uint32_t p_service, const std::string & p_destination);
     Voyage();
-	const std::set<Arret::Ptr, compArret> & getArrets() const;
+	const PlageArrets & getArrets() const;
+	void setArrets(const PlageArrets & p_arrets);
     unsigned int getNbArrets() const;
 	const std::string& getDestination() const;
-	std::string getId() const;
-	std::string getLigne() const;
-	std::string getServiceId() const;
+	std::uint32_t getId() const;
+	std::uint32_t getLigne() const;
+	std::uint32_t getServiceId() const;
 	Heure getHeureDepart() const;
 	Heure getHeureFin() const;
-    void ajouterArret(const Arret::Ptr & p_arret);
 	bool operator< (const Voyage & p_other) const;
 	bool operator> (const Voyage & p_other) const;
 	friend std::ostream & operator<<(std::ostream & flux, const Voyage & p_voyage);
 
 private:
 
-    std::string m_id;
-	std::string m_ligne;
-	std::string m_service_id;
+    std::uint32_t m_id; //identifiants denses, voir DonneesGTFS::getIdsVoyages(), getIdsLignes() et getIdsServices()
+	std::uint32_t m_ligne;
+	std::uint32_t m_service;
 	std::string m_destination;
-	std::set<Arret::Ptr, compArret> m_arrets;
+	PlageArrets m_arrets; //tranche de DonneesGTFS::getTableArrets(), par numéro de séquence croissant
 
 };
 